@@ -124,6 +124,7 @@ wrap_unique_ptr(DownloadCallbacksUniquePtr, libdnf5::repo::DownloadCallbacks);
     }
 };
 %ignore libdnf5::repo::PackageDownloader::add;
+%ignore libdnf5::repo::PackageDownloader::set_package_ready_callback;
 %ignore PackageDownloadError;
 %include "libdnf5/repo/package_downloader.hpp"
 
@@ -120,6 +120,7 @@ wrap_unique_ptr(TransactionCallbacksUniquePtr, libdnf5::rpm::TransactionCallback
 %include "libdnf5/rpm/rpm_signature.hpp"
 
 %template(VectorKeyInfo) std::vector<libdnf5::rpm::KeyInfo>;
+%template(VectorRpmSignatureCheckResult) std::vector<libdnf5::rpm::RpmSignature::CheckResult>;
 
 // Add attributes for getters/setters in Python.
 // See 'common.i' for more info.
@@ -223,6 +223,7 @@ BuildRequires:  dbus-daemon
 BuildRequires:  polkit
 BuildRequires:  python3-devel
 BuildRequires:  python3dist(dbus-python)
+BuildRequires:  python3-gobject-base
 %endif
 %endif
 
@@ -36,11 +36,19 @@ void MakeCacheCommand::set_parent_command() {
 
 void MakeCacheCommand::set_argument_parser() {
     get_argument_parser_command()->set_description("Generate the metadata cache");
+
+    warm_solv_cache = std::make_unique<libdnf5::cli::session::BoolOption>(
+        *this,
+        "warm-solv-cache",
+        '\0',
+        "Also load the installed packages and complete the solver cache files, including the file provides.",
+        false);
 }
 
 void MakeCacheCommand::configure() {
     auto & ctx = get_context();
-    ctx.set_load_system_repo(false);
+    // The file provides stored in the caches are computed from the requires of both installed and available packages
+    ctx.set_load_system_repo(warm_solv_cache->get_value());
     ctx.set_load_available_repos(Context::LoadAvailableRepos::ENABLED);
 
     libdnf5::repo::RepoQuery enabled_repos_query(ctx.get_base());
@@ -61,6 +69,9 @@ void MakeCacheCommand::configure() {
 }
 
 void MakeCacheCommand::run() {
+    if (warm_solv_cache->get_value()) {
+        get_context().get_base().get_repo_sack()->build_solv_caches();
+    }
     std::cout << "Metadata cache created." << std::endl;
 }
 
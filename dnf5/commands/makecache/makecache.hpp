@@ -21,6 +21,9 @@
 #define DNF5_COMMANDS_MAKECAHE_MAKECACHE_HPP
 
 #include <dnf5/context.hpp>
+#include <libdnf5-cli/session.hpp>
+
+#include <memory>
 
 namespace dnf5 {
 
@@ -31,6 +34,9 @@ public:
     void set_argument_parser() override;
     void configure() override;
     void run() override;
+
+private:
+    std::unique_ptr<libdnf5::cli::session::BoolOption> warm_solv_cache{nullptr};
 };
 
 }  // namespace dnf5
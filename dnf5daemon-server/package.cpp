@@ -19,10 +19,13 @@
 
 #include "package.hpp"
 
+#include "utils.hpp"
+
 #include <fmt/format.h>
 #include <json-c/json.h>
 
 #include <map>
+#include <type_traits>
 
 // map string package attribute name to actual attribute
 const std::map<std::string, PackageAttribute> package_attributes{
@@ -62,6 +65,7 @@ const std::map<std::string, PackageAttribute> package_attributes{
 
 static std::vector<std::string> reldeplist_to_strings(const libdnf5::rpm::ReldepList & reldeps) {
     std::vector<std::string> lst;
+    lst.reserve(static_cast<std::size_t>(reldeps.size()));
     for (auto reldep : reldeps) {
         lst.emplace_back(reldep.to_string());
     }
@@ -78,18 +82,32 @@ static std::vector<dnfdaemon::Changelog> changelogs_to_list(const libdnf5::rpm::
     return changelogs;
 }
 
+PackageAttributes resolve_package_attributes(const std::vector<std::string> & attributes) {
+    PackageAttributes resolved;
+    resolved.reserve(attributes.size());
+    for (const auto & attr : attributes) {
+        auto it = package_attributes.find(attr);
+        if (it == package_attributes.end()) {
+            throw std::runtime_error(fmt::format("Package attribute '{}' not supported", attr));
+        }
+        resolved.emplace_back(attr, it->second);
+    }
+    return resolved;
+}
+
 dnfdaemon::KeyValueMap package_to_map(
     const libdnf5::rpm::Package & libdnf_package, const std::vector<std::string> & attributes) {
+    return package_to_map(libdnf_package, resolve_package_attributes(attributes));
+}
+
+dnfdaemon::KeyValueMap package_to_map(
+    const libdnf5::rpm::Package & libdnf_package, const PackageAttributes & attributes) {
     dnfdaemon::KeyValueMap dbus_package;
     // add package id by default
     dbus_package.emplace(std::make_pair("id", libdnf_package.get_id().id));
     // attributes required by client
-    for (auto & attr : attributes) {
-        auto it = package_attributes.find(attr);
-        if (it == package_attributes.end()) {
-            throw std::runtime_error(fmt::format("Package attribute '{}' not supported", attr));
-        }
-        switch (it->second) {
+    for (const auto & [attr, attr_kind] : attributes) {
+        switch (attr_kind) {
             case PackageAttribute::name:
                 dbus_package.emplace(attr, libdnf_package.get_name());
                 break;
@@ -201,165 +219,160 @@ dnfdaemon::KeyValueMap package_to_map(
     return dbus_package;
 }
 
-static void add_string_list(json_object * json_pkg, const char * cattr, const std::vector<std::string> & vector) {
+static json_object * string_list_to_json(const std::vector<std::string> & vector) {
     json_object * array = json_object_new_array();
-    json_object_object_add(json_pkg, cattr, array);
     for (const auto & elem : vector) {
         json_object_array_add(array, json_object_new_string(elem.c_str()));
     }
+    return array;
 }
 
-std::string package_to_json(const libdnf5::rpm::Package & libdnf_package, const std::vector<std::string> & attributes) {
-    json_object * json_pkg = json_object_new_object();
-
-    // add package id by default
-    json_object_object_add(json_pkg, "id", json_object_new_int(libdnf_package.get_id().id));
-
-    // attributes required by client
-    for (const auto & attr : attributes) {
-        const auto * const cattr = attr.c_str();
-        auto it = package_attributes.find(attr);
-        if (it == package_attributes.end()) {
-            throw std::runtime_error(fmt::format("Package attribute '{}' not supported", attr));
+static PackageValue package_attribute_value(const libdnf5::rpm::Package & libdnf_package, PackageAttribute attr_kind) {
+    switch (attr_kind) {
+        case PackageAttribute::name:
+            return libdnf_package.get_name();
+        case PackageAttribute::epoch:
+            return libdnf_package.get_epoch();
+        case PackageAttribute::version:
+            return libdnf_package.get_version();
+        case PackageAttribute::release:
+            return libdnf_package.get_release();
+        case PackageAttribute::arch:
+            return libdnf_package.get_arch();
+        case PackageAttribute::repo_id:
+            return libdnf_package.get_repo_id();
+        case PackageAttribute::from_repo_id:
+            return libdnf_package.get_from_repo_id();
+        case PackageAttribute::is_installed:
+            return libdnf_package.is_installed();
+        case PackageAttribute::install_size:
+            return static_cast<int64_t>(libdnf_package.get_install_size());
+        case PackageAttribute::download_size:
+            return static_cast<int64_t>(libdnf_package.get_download_size());
+        case PackageAttribute::buildtime:
+            return static_cast<int64_t>(libdnf_package.get_build_time());
+        case PackageAttribute::sourcerpm:
+            return libdnf_package.get_sourcerpm();
+        case PackageAttribute::summary:
+            return libdnf_package.get_summary();
+        case PackageAttribute::url:
+            return libdnf_package.get_url();
+        case PackageAttribute::license:
+            return libdnf_package.get_license();
+        case PackageAttribute::description:
+            return libdnf_package.get_description();
+        case PackageAttribute::files:
+            return libdnf_package.get_files();
+        case PackageAttribute::changelogs: {
+            std::vector<PackageChangelog> changelogs;
+            for (const auto & libdnf_chlog : libdnf_package.get_changelogs()) {
+                changelogs.emplace_back(
+                    static_cast<int64_t>(libdnf_chlog.get_timestamp()),
+                    libdnf_chlog.get_author(),
+                    libdnf_chlog.get_text());
+            }
+            return changelogs;
         }
-        switch (it->second) {
-            case PackageAttribute::name:
-                json_object_object_add(json_pkg, cattr, json_object_new_string(libdnf_package.get_name().c_str()));
+        case PackageAttribute::provides:
+            return reldeplist_to_strings(libdnf_package.get_provides());
+        case PackageAttribute::requires_all:
+            return reldeplist_to_strings(libdnf_package.get_requires());
+        case PackageAttribute::requires_pre:
+            return reldeplist_to_strings(libdnf_package.get_requires_pre());
+        case PackageAttribute::prereq_ignoreinst:
+            return reldeplist_to_strings(libdnf_package.get_prereq_ignoreinst());
+        case PackageAttribute::regular_requires:
+            return reldeplist_to_strings(libdnf_package.get_regular_requires());
+        case PackageAttribute::conflicts:
+            return reldeplist_to_strings(libdnf_package.get_conflicts());
+        case PackageAttribute::obsoletes:
+            return reldeplist_to_strings(libdnf_package.get_obsoletes());
+        case PackageAttribute::recommends:
+            return reldeplist_to_strings(libdnf_package.get_recommends());
+        case PackageAttribute::suggests:
+            return reldeplist_to_strings(libdnf_package.get_suggests());
+        case PackageAttribute::enhances:
+            return reldeplist_to_strings(libdnf_package.get_enhances());
+        case PackageAttribute::supplements:
+            return reldeplist_to_strings(libdnf_package.get_supplements());
+        case PackageAttribute::evr: {
+            // Always show epoch in EVR (epoch:version-release)
+            std::string evr_with_epoch = libdnf_package.get_epoch();
+            if (evr_with_epoch.empty()) {
+                evr_with_epoch = "0";
+            }
+            evr_with_epoch += ":" + libdnf_package.get_version() + "-" + libdnf_package.get_release();
+            return evr_with_epoch;
+        }
+        case PackageAttribute::nevra:
+            return libdnf_package.get_full_nevra();
+        case PackageAttribute::full_nevra:
+            return libdnf_package.get_full_nevra();
+        case PackageAttribute::reason:
+            return libdnf5::transaction::transaction_item_reason_to_string(libdnf_package.get_reason());
+        case PackageAttribute::vendor:
+            return libdnf_package.get_vendor();
+        case PackageAttribute::group:
+            return libdnf_package.get_group();
+    }
+    return std::string();
+}
 
-                break;
-            case PackageAttribute::epoch:
-                json_object_object_add(json_pkg, cattr, json_object_new_string(libdnf_package.get_epoch().c_str()));
-                break;
-            case PackageAttribute::version:
-                json_object_object_add(json_pkg, cattr, json_object_new_string(libdnf_package.get_version().c_str()));
-                break;
-            case PackageAttribute::release:
-                json_object_object_add(json_pkg, cattr, json_object_new_string(libdnf_package.get_release().c_str()));
-                break;
-            case PackageAttribute::arch:
-                json_object_object_add(json_pkg, cattr, json_object_new_string(libdnf_package.get_arch().c_str()));
-                break;
-            case PackageAttribute::repo_id:
-                json_object_object_add(json_pkg, cattr, json_object_new_string(libdnf_package.get_repo_id().c_str()));
-                break;
-            case PackageAttribute::from_repo_id:
-                json_object_object_add(
-                    json_pkg, cattr, json_object_new_string(libdnf_package.get_from_repo_id().c_str()));
-                break;
-            case PackageAttribute::is_installed:
-                json_object_object_add(
-                    json_pkg, cattr, json_object_new_boolean(static_cast<json_bool>(libdnf_package.is_installed())));
-                break;
-            case PackageAttribute::install_size:
-                json_object_object_add(
-                    json_pkg, cattr, json_object_new_int64(static_cast<int64_t>(libdnf_package.get_install_size())));
-                break;
-            case PackageAttribute::download_size:
-                json_object_object_add(
-                    json_pkg, cattr, json_object_new_int64(static_cast<int64_t>(libdnf_package.get_download_size())));
-                break;
-            case PackageAttribute::buildtime:
-                json_object_object_add(
-                    json_pkg, cattr, json_object_new_int64(static_cast<int64_t>(libdnf_package.get_build_time())));
-                break;
-            case PackageAttribute::sourcerpm:
-                json_object_object_add(json_pkg, cattr, json_object_new_string(libdnf_package.get_sourcerpm().c_str()));
-                break;
-            case PackageAttribute::summary:
-                json_object_object_add(json_pkg, cattr, json_object_new_string(libdnf_package.get_summary().c_str()));
-                break;
-            case PackageAttribute::url:
-                json_object_object_add(json_pkg, cattr, json_object_new_string(libdnf_package.get_url().c_str()));
-                break;
-            case PackageAttribute::license:
-                json_object_object_add(json_pkg, cattr, json_object_new_string(libdnf_package.get_license().c_str()));
-                break;
-            case PackageAttribute::description:
-                json_object_object_add(
-                    json_pkg, cattr, json_object_new_string(libdnf_package.get_description().c_str()));
-                break;
-            case PackageAttribute::files:
-                add_string_list(json_pkg, cattr, libdnf_package.get_files());
-                break;
-            case PackageAttribute::changelogs: {
+static json_object * package_value_to_json(const PackageValue & value) {
+    return std::visit(
+        [](const auto & val) -> json_object * {
+            using ValueType = std::decay_t<decltype(val)>;
+            if constexpr (std::is_same_v<ValueType, std::string>) {
+                return json_object_new_string(val.c_str());
+            } else if constexpr (std::is_same_v<ValueType, int64_t>) {
+                return json_object_new_int64(val);
+            } else if constexpr (std::is_same_v<ValueType, bool>) {
+                return json_object_new_boolean(static_cast<json_bool>(val));
+            } else if constexpr (std::is_same_v<ValueType, std::vector<std::string>>) {
+                return string_list_to_json(val);
+            } else {
                 json_object * array = json_object_new_array();
-                json_object_object_add(json_pkg, cattr, array);
-                for (const auto & libdnf_chlog : libdnf_package.get_changelogs()) {
+                for (const auto & [timestamp, author, text] : val) {
                     json_object * chlog = json_object_new_array();
-                    json_object_array_add(
-                        chlog, json_object_new_int64(static_cast<int64_t>(libdnf_chlog.get_timestamp())));
-                    json_object_array_add(chlog, json_object_new_string(libdnf_chlog.get_author().c_str()));
-                    json_object_array_add(chlog, json_object_new_string(libdnf_chlog.get_text().c_str()));
+                    json_object_array_add(chlog, json_object_new_int64(timestamp));
+                    json_object_array_add(chlog, json_object_new_string(author.c_str()));
+                    json_object_array_add(chlog, json_object_new_string(text.c_str()));
 
                     json_object_array_add(array, chlog);
                 }
-                break;
+                return array;
             }
-            case PackageAttribute::provides:
-                add_string_list(json_pkg, cattr, reldeplist_to_strings(libdnf_package.get_provides()));
-                break;
-            case PackageAttribute::requires_all:
-                add_string_list(json_pkg, cattr, reldeplist_to_strings(libdnf_package.get_requires()));
-                break;
-            case PackageAttribute::requires_pre:
-                add_string_list(json_pkg, cattr, reldeplist_to_strings(libdnf_package.get_requires_pre()));
-                break;
-            case PackageAttribute::prereq_ignoreinst:
-                add_string_list(json_pkg, cattr, reldeplist_to_strings(libdnf_package.get_prereq_ignoreinst()));
-                break;
-            case PackageAttribute::regular_requires:
-                add_string_list(json_pkg, cattr, reldeplist_to_strings(libdnf_package.get_regular_requires()));
-                break;
-            case PackageAttribute::conflicts:
-                add_string_list(json_pkg, cattr, reldeplist_to_strings(libdnf_package.get_conflicts()));
-                break;
-            case PackageAttribute::obsoletes:
-                add_string_list(json_pkg, cattr, reldeplist_to_strings(libdnf_package.get_obsoletes()));
-                break;
-            case PackageAttribute::recommends:
-                add_string_list(json_pkg, cattr, reldeplist_to_strings(libdnf_package.get_recommends()));
-                break;
-            case PackageAttribute::suggests:
-                add_string_list(json_pkg, cattr, reldeplist_to_strings(libdnf_package.get_suggests()));
-                break;
-            case PackageAttribute::enhances:
-                add_string_list(json_pkg, cattr, reldeplist_to_strings(libdnf_package.get_enhances()));
-                break;
-            case PackageAttribute::supplements:
-                add_string_list(json_pkg, cattr, reldeplist_to_strings(libdnf_package.get_supplements()));
-                break;
-            case PackageAttribute::evr:
-                // Always show epoch in EVR (epoch:version-release)
-                {
-                    std::string evr_with_epoch = libdnf_package.get_epoch();
-                    if (evr_with_epoch.empty()) {
-                        evr_with_epoch = "0";
-                    }
-                    evr_with_epoch += ":" + libdnf_package.get_version() + "-" + libdnf_package.get_release();
-                    json_object_object_add(json_pkg, cattr, json_object_new_string(evr_with_epoch.c_str()));
-                }
-                break;
-            case PackageAttribute::nevra:
-                json_object_object_add(
-                    json_pkg, cattr, json_object_new_string(libdnf_package.get_full_nevra().c_str()));
-                break;
-            case PackageAttribute::full_nevra:
-                json_object_object_add(
-                    json_pkg, cattr, json_object_new_string(libdnf_package.get_full_nevra().c_str()));
-                break;
-            case PackageAttribute::reason:
-                json_object_object_add(
-                    json_pkg,
-                    cattr,
-                    json_object_new_string(
-                        libdnf5::transaction::transaction_item_reason_to_string(libdnf_package.get_reason()).c_str()));
-                break;
-            case PackageAttribute::vendor:
-                json_object_object_add(json_pkg, cattr, json_object_new_string(libdnf_package.get_vendor().c_str()));
-                break;
-            case PackageAttribute::group:
-                json_object_object_add(json_pkg, cattr, json_object_new_string(libdnf_package.get_group().c_str()));
-                break;
+        },
+        value);
+}
+
+PackageValues package_to_values(const libdnf5::rpm::Package & libdnf_package, const PackageAttributes & attributes) {
+    PackageValues package;
+    package.id = libdnf_package.get_id().id;
+    package.values.reserve(attributes.size());
+    for (const auto & [attr, attr_kind] : attributes) {
+        package.values.push_back(package_attribute_value(libdnf_package, attr_kind));
+    }
+    return package;
+}
+
+std::string package_values_to_json(
+    const PackageValues & package, const PackageAttributes & attributes, PackageJsonFormat format) {
+    json_object * json_pkg;
+    if (format == PackageJsonFormat::ARRAY) {
+        // the values in the order of the attributes without the repeated attribute names
+        json_pkg = json_object_new_array();
+        json_object_array_add(json_pkg, json_object_new_int(package.id));
+        for (const auto & value : package.values) {
+            json_object_array_add(json_pkg, package_value_to_json(value));
+        }
+    } else {
+        json_pkg = json_object_new_object();
+        // add package id by default
+        json_object_object_add(json_pkg, "id", json_object_new_int(package.id));
+        // attributes required by client
+        for (std::size_t idx = 0; idx < package.values.size(); ++idx) {
+            json_object_object_add(json_pkg, attributes[idx].first.c_str(), package_value_to_json(package.values[idx]));
         }
     }
 
@@ -368,3 +381,127 @@ std::string package_to_json(const libdnf5::rpm::Package & libdnf_package, const
     json_object_put(json_pkg);
     return res;
 }
+
+std::string package_to_json(
+    const libdnf5::rpm::Package & libdnf_package,
+    const std::vector<std::string> & attributes,
+    PackageJsonFormat format) {
+    return package_to_json(libdnf_package, resolve_package_attributes(attributes), format);
+}
+
+std::string package_to_json(
+    const libdnf5::rpm::Package & libdnf_package, const PackageAttributes & attributes, PackageJsonFormat format) {
+    return package_values_to_json(package_to_values(libdnf_package, attributes), attributes, format);
+}
+
+std::string package_json_header(const PackageAttributes & attributes) {
+    json_object * json_header = json_object_new_array();
+    json_object_array_add(json_header, json_object_new_string("id"));
+    for (const auto & [attr, attr_kind] : attributes) {
+        json_object_array_add(json_header, json_object_new_string(attr.c_str()));
+    }
+    std::string res = json_object_to_json_string_ext(json_header, JSON_C_TO_STRING_PLAIN);
+    json_object_put(json_header);
+    return res;
+}
+
+PackageJsonWriter::PackageJsonWriter(int out_fd, PackageAttributes attributes, PackageJsonFormat format)
+    : out_fd(out_fd),
+      attributes(std::move(attributes)),
+      format(format) {
+    chunk.reserve(CHUNK_SIZE);
+    writer_thread = std::thread(&PackageJsonWriter::run, this);
+}
+
+PackageJsonWriter::~PackageJsonWriter() {
+    std::string error_msg;
+    finish(error_msg);
+}
+
+bool PackageJsonWriter::write(PackageValues && package) {
+    chunk.push_back(std::move(package));
+    if (chunk.size() < CHUNK_SIZE) {
+        return true;
+    }
+    return queue_chunk();
+}
+
+bool PackageJsonWriter::queue_chunk() {
+    {
+        std::unique_lock<std::mutex> lock(queue_mutex);
+        // the extracted packages waiting for the writer are limited, a slow reader of the pipe does not fill the memory
+        queue_condition.wait(lock, [this]() { return chunks.size() < MAX_QUEUED_CHUNKS || failed; });
+        if (failed) {
+            chunk.clear();
+            return false;
+        }
+        chunks.push_back(std::move(chunk));
+    }
+    queue_condition.notify_all();
+    chunk = std::vector<PackageValues>();
+    chunk.reserve(CHUNK_SIZE);
+    return true;
+}
+
+bool PackageJsonWriter::finish(std::string & error_msg) {
+    if (writer_thread.joinable()) {
+        if (!chunk.empty()) {
+            queue_chunk();
+        }
+        {
+            std::lock_guard<std::mutex> lock(queue_mutex);
+            finishing = true;
+        }
+        queue_condition.notify_all();
+        writer_thread.join();
+    }
+    error_msg = error;
+    return !failed;
+}
+
+void PackageJsonWriter::run() {
+    // packages are written in large batches, not one write per package
+    dnfdaemon::BufferedFdWriter writer(out_fd);
+    std::string write_error;
+    bool success = true;
+    if (format == PackageJsonFormat::ARRAY) {
+        // the header with the names of the values in the package arrays
+        success = writer.write(package_json_header(attributes) + "\n", write_error);
+    }
+
+    std::unique_lock<std::mutex> lock(queue_mutex);
+    while (success) {
+        queue_condition.wait(lock, [this]() { return !chunks.empty() || finishing; });
+        if (chunks.empty()) {
+            // all queued packages were converted
+            lock.unlock();
+            success = writer.flush(write_error);
+            lock.lock();
+            break;
+        }
+        auto packages = std::move(chunks.front());
+        chunks.pop_front();
+        lock.unlock();
+        // the caller may wait for the free place in the queue
+        queue_condition.notify_all();
+
+        std::string jsonstr;
+        for (const auto & package : packages) {
+            jsonstr = package_values_to_json(package, attributes, format);
+            jsonstr += '\n';
+            if (!writer.write(jsonstr, write_error)) {
+                success = false;
+                break;
+            }
+        }
+        lock.lock();
+    }
+
+    if (!success) {
+        failed = true;
+        error = fmt::format("Error writing package list to the fd: {}", write_error);
+        chunks.clear();
+    }
+    lock.unlock();
+    queue_condition.notify_all();
+}
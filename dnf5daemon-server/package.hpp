@@ -24,7 +24,16 @@
 
 #include <libdnf5/rpm/package.hpp>
 
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <mutex>
 #include <string>
+#include <thread>
+#include <tuple>
+#include <utility>
+#include <variant>
 #include <vector>
 
 // TODO(mblaha): add all other package attributes
@@ -70,13 +79,118 @@ enum class PackageAttribute {
     group
 };
 
+/// Package attributes requested by a client, their names paired with the attributes.
+using PackageAttributes = std::vector<std::pair<std::string, PackageAttribute>>;
+
+/// Resolve the names of package attributes requested by a client.
+/// Resolving them once instead of for each converted package saves the lookups when many packages are converted.
+/// @throws std::runtime_error if an attribute is not supported.
+PackageAttributes resolve_package_attributes(const std::vector<std::string> & attributes);
+
 dnfdaemon::KeyValueMap package_to_map(
     const libdnf5::rpm::Package & libdnf_package, const std::vector<std::string> & attributes);
+dnfdaemon::KeyValueMap package_to_map(
+    const libdnf5::rpm::Package & libdnf_package, const PackageAttributes & attributes);
+
+/// Layout of a package converted to JSON
+enum class PackageJsonFormat {
+    /// Dictionary of attribute names and values
+    OBJECT,
+    /// Array of attribute values ordered as the "id" followed by the requested attributes
+    ARRAY
+};
 
 /// Convert given libdnf_package to a JSON string using requested attributes.
 /// @param libdnf_package Package to convert to JSON
 /// @param attributes A list of attributes of ligdnf_package that are included in JSON
-/// @return JSON String with the package represented as key:value dictionary.
-std::string package_to_json(const libdnf5::rpm::Package & libdnf_package, const std::vector<std::string> & attributes);
+/// @param format Whether the package is represented as key:value dictionary or as an array of values
+/// @return JSON String with the package represented in the `format` layout.
+std::string package_to_json(
+    const libdnf5::rpm::Package & libdnf_package,
+    const std::vector<std::string> & attributes,
+    PackageJsonFormat format = PackageJsonFormat::OBJECT);
+std::string package_to_json(
+    const libdnf5::rpm::Package & libdnf_package,
+    const PackageAttributes & attributes,
+    PackageJsonFormat format = PackageJsonFormat::OBJECT);
+
+/// Create the header of packages converted to JSON in the `PackageJsonFormat::ARRAY` layout.
+/// @param attributes A list of requested package attributes
+/// @return JSON String with an array of the names of the package values.
+std::string package_json_header(const PackageAttributes & attributes);
+
+/// Changelog entry of a package: timestamp, author and text
+using PackageChangelog = std::tuple<int64_t, std::string, std::string>;
+/// Value of a package attribute
+using PackageValue = std::variant<std::string, int64_t, bool, std::vector<std::string>, std::vector<PackageChangelog>>;
+
+/// Values of the requested attributes extracted from a package.
+/// Unlike the package they do not refer to the package sack, they can be converted to JSON on another thread.
+struct PackageValues {
+    int id{0};
+    /// Values in the order of the requested attributes
+    std::vector<PackageValue> values;
+};
+
+/// Extract the values of the requested attributes from the package.
+PackageValues package_to_values(const libdnf5::rpm::Package & libdnf_package, const PackageAttributes & attributes);
+
+/// Convert the values extracted from a package to a JSON string.
+/// @param package Values extracted with the same `attributes`
+/// @param attributes A list of requested package attributes
+/// @param format Whether the package is represented as key:value dictionary or as an array of values
+/// @return JSON String with the package represented in the `format` layout.
+std::string package_values_to_json(
+    const PackageValues & package, const PackageAttributes & attributes, PackageJsonFormat format);
+
+/// Converts the package values to JSON and writes them to the file descriptor on its own thread.
+/// The values are extracted on the calling thread, the package sack must not be accessed concurrently.
+/// Converting and writing the packages runs in parallel with the extraction of the following ones.
+class PackageJsonWriter {
+public:
+    /// Number of packages handed over to the writer thread at once
+    static constexpr std::size_t CHUNK_SIZE = 256;
+    /// Maximal number of chunks waiting for the writer thread, the caller waits for a free place
+    static constexpr std::size_t MAX_QUEUED_CHUNKS = 16;
+
+    /// Starts the writer thread. In the `PackageJsonFormat::ARRAY` format it first writes the header line.
+    /// @param out_fd Open file descriptor
+    /// @param attributes A list of requested package attributes
+    /// @param format Layout of the written packages, one package per line
+    PackageJsonWriter(int out_fd, PackageAttributes attributes, PackageJsonFormat format);
+    ~PackageJsonWriter();
+
+    PackageJsonWriter(const PackageJsonWriter &) = delete;
+    PackageJsonWriter & operator=(const PackageJsonWriter &) = delete;
+
+    /// Queues the package values to be written.
+    /// @return False if writing to the file descriptor failed, the following packages are not written.
+    bool write(PackageValues && package);
+
+    /// Waits until the queued packages are written and stops the writer thread.
+    /// @param error_msg In case of error this string contains error description
+    /// @return True in case all packages were written, False otherwise.
+    bool finish(std::string & error_msg);
+
+private:
+    /// Hands the collected packages over to the writer thread.
+    bool queue_chunk();
+    void run();
+
+    const int out_fd;
+    const PackageAttributes attributes;
+    const PackageJsonFormat format;
+    // packages collected by the caller
+    std::vector<PackageValues> chunk;
+
+    std::mutex queue_mutex;
+    // wakes the writer thread when a chunk is queued and the caller when a chunk is taken
+    std::condition_variable queue_condition;
+    std::deque<std::vector<PackageValues>> chunks;
+    bool finishing{false};
+    bool failed{false};
+    std::string error;
+    std::thread writer_thread;
+};
 
 #endif
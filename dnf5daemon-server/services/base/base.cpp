@@ -114,6 +114,11 @@ void Base::dbus_register() {
                 dnfdaemon::SIGNAL_REPO_KEY_IMPORT_REQUEST,
                 sdbus::Signature{"osasssx"},
                 {"session_object_path", "key_id", "user_ids", "key_fingerprint", "key_url", "timestamp"},
+                {}},
+            sdbus::SignalVTableItem{
+                dnfdaemon::SIGNAL_REPOSITORIES_READY,
+                sdbus::Signature{"ob"},
+                {"session_object_path", "success"},
                 {}})
         .forInterface(dnfdaemon::INTERFACE_BASE);
 #else
@@ -177,6 +182,8 @@ void Base::dbus_register() {
         dnfdaemon::SIGNAL_REPO_KEY_IMPORT_REQUEST,
         "osasssx",
         {"session_object_path", "key_id", "user_ids", "key_fingerprint", "key_url", "timestamp"});
+    dbus_object->registerSignal(
+        dnfdaemon::INTERFACE_BASE, dnfdaemon::SIGNAL_REPOSITORIES_READY, "ob", {"session_object_path", "success"});
 #endif
 }
 
@@ -598,8 +598,10 @@ sdbus::MethodReply Rpm::list(sdbus::MethodCall & call) {
     // create reply from the query
     dnfdaemon::KeyValueMapList out_packages;
     std::vector<std::string> default_attrs{};
-    std::vector<std::string> package_attrs =
-        dnfdaemon::key_value_map_get<std::vector<std::string>>(options, "package_attrs", default_attrs);
+    // the attribute names are resolved once, not for each package
+    auto package_attrs = resolve_package_attributes(
+        dnfdaemon::key_value_map_get<std::vector<std::string>>(options, "package_attrs", default_attrs));
+    out_packages.reserve(query.size());
     for (const auto & pkg : query) {
         out_packages.push_back(package_to_map(pkg, package_attrs));
     }
@@ -623,25 +625,45 @@ void Rpm::list_fd(sdbus::MethodCall & call, const std::string & transfer_id) {
 
     auto query = filter_packages(options);
 
-    std::vector<std::string> package_attrs =
-        dnfdaemon::key_value_map_get<std::vector<std::string>>(options, "package_attrs", std::vector<std::string>());
+    std::string package_format = dnfdaemon::key_value_map_get<std::string>(options, "package_format", "object");
     std::string error_msg;
-    for (const auto & pkg : query) {
-        std::string jsonstr;
-        try {
-            jsonstr = package_to_json(pkg, package_attrs) + "\n";
-        } catch (const std::exception & ex) {
-            error_msg = fmt::format(
-                "Error serializing package \"{0}\" from repo \"{1}\": {2}",
-                pkg.get_nevra(),
-                pkg.get_repo_id(),
-                ex.what());
-            break;
+    // the attribute names are resolved once, not for each package
+    PackageAttributes package_attrs;
+    try {
+        package_attrs = resolve_package_attributes(dnfdaemon::key_value_map_get<std::vector<std::string>>(
+            options, "package_attrs", std::vector<std::string>()));
+    } catch (const std::exception & ex) {
+        error_msg = ex.what();
+    }
+    PackageJsonFormat json_format = PackageJsonFormat::OBJECT;
+    if (package_format == "array") {
+        json_format = PackageJsonFormat::ARRAY;
+    } else if (package_format != "object") {
+        error_msg = fmt::format("Package format '{}' not supported", package_format);
+    }
+    if (error_msg.empty()) {
+        // the values are extracted here, the package sack is not thread-safe; converting them to JSON and writing
+        // them to the fd runs in parallel on the writer thread
+        PackageJsonWriter writer(out_fd, package_attrs, json_format);
+        for (const auto & pkg : query) {
+            PackageValues package;
+            try {
+                package = package_to_values(pkg, package_attrs);
+            } catch (const std::exception & ex) {
+                error_msg = fmt::format(
+                    "Error serializing package \"{0}\" from repo \"{1}\": {2}",
+                    pkg.get_nevra(),
+                    pkg.get_repo_id(),
+                    ex.what());
+                break;
+            }
+            if (!writer.write(std::move(package))) {
+                break;
+            }
         }
         std::string write_error;
-        if (!dnfdaemon::write_to_fd(jsonstr, out_fd, write_error)) {
-            error_msg = fmt::format("Error writing package list to the fd: {}", write_error);
-            break;
+        if (!writer.finish(write_error) && error_msg.empty()) {
+            error_msg = write_error;
         }
     }
     close(out_fd);
@@ -39,11 +39,13 @@
 #include <libdnf5/utils/fs/file.hpp>
 #include <sdbus-c++/sdbus-c++.h>
 
+#include <algorithm>
 #include <chrono>
 #include <filesystem>
 #include <iostream>
 #include <optional>
 #include <string>
+#include <system_error>
 
 // config options that regular user can override for their session.
 static const std::unordered_set<std::string> ALLOWED_MAIN_CONF_OVERRIDES = {
@@ -74,6 +76,87 @@ static const std::unordered_set<std::string> ALLOWED_MAIN_CONF_OVERRIDES = {
     "strict",
 };
 
+// methods that do not change the base of the session, the base can be reused by another session after them
+static const std::unordered_set<std::string> BASE_READ_ONLY_METHODS = {
+    "org.rpm.dnf.v0.Advisory.list",
+    "org.rpm.dnf.v0.Base.read_all_repos",
+    "org.rpm.dnf.v0.Goal.get_transaction_problems",
+    "org.rpm.dnf.v0.Goal.get_transaction_problems_string",
+    "org.rpm.dnf.v0.History.recent_changes",
+    "org.rpm.dnf.v0.Offline.get_status",
+    "org.rpm.dnf.v0.comps.Group.list",
+    "org.rpm.dnf.v0.rpm.Repo.list",
+    "org.rpm.dnf.v0.rpm.Rpm.list",
+    "org.rpm.dnf.v0.rpm.Rpm.list_fd",
+};
+
+// Appends the modification time of `path` and, if it is a directory, of the files in it to `stamp`.
+static void append_mtimes(std::string & stamp, const std::filesystem::path & path) {
+    auto append_mtime = [&stamp](const std::filesystem::path & file) {
+        std::error_code ec;
+        auto mtime = std::filesystem::last_write_time(file, ec);
+        stamp += fmt::format("{} {}\n", file.string(), ec ? 0 : mtime.time_since_epoch().count());
+    };
+    append_mtime(path);
+
+    std::error_code ec;
+    if (!std::filesystem::is_directory(path, ec)) {
+        return;
+    }
+    std::vector<std::filesystem::path> files;
+    for (std::filesystem::directory_iterator it(path, ec), end; !ec && it != end; it.increment(ec)) {
+        files.push_back(it->path());
+    }
+    std::sort(files.begin(), files.end());
+    for (const auto & file : files) {
+        append_mtime(file);
+    }
+}
+
+bool ReusableBase::is_current() const {
+    return Session::get_config_files_stamp(*base) == config_stamp &&
+           base->get_repo_sack()->is_loaded_data_current();
+}
+
+std::string Session::get_base_reuse_key(const dnfdaemon::KeyValueMap & session_configuration) {
+    std::string key;
+    // std::map iterates the overrides in a stable order
+    auto conf_overrides = dnfdaemon::key_value_map_get<std::map<std::string, std::string>>(
+        session_configuration, "config", std::map<std::string, std::string>{});
+    for (const auto & [option, value] : conf_overrides) {
+        key += fmt::format("config.{}={}\n", option, value);
+    }
+    for (const auto * var : {"releasever", "releasever_major", "releasever_minor"}) {
+        if (session_configuration.find(var) != session_configuration.end()) {
+            key += fmt::format("{}={}\n", var, dnfdaemon::key_value_map_get<std::string>(session_configuration, var));
+        }
+    }
+    key += fmt::format(
+        "load_available_repos={}\nload_system_repo={}\n",
+        dnfdaemon::key_value_map_get<bool>(session_configuration, "load_available_repos", true),
+        dnfdaemon::key_value_map_get<bool>(session_configuration, "load_system_repo", true));
+    for (const auto & type : dnfdaemon::key_value_map_get<std::vector<std::string>>(
+             session_configuration, "optional_metadata_types", {})) {
+        key += fmt::format("optional_metadata_type={}\n", type);
+    }
+    return key;
+}
+
+std::string Session::get_config_files_stamp(libdnf5::Base & base) {
+    const auto & config = base.get_config();
+    std::string stamp;
+    append_mtimes(stamp, config.get_config_file_path_option().get_value());
+    append_mtimes(stamp, libdnf5::CONF_DIRECTORY);
+    for (const auto & dir : config.get_reposdir_option().get_value()) {
+        append_mtimes(stamp, dir);
+    }
+    for (const auto & dir : config.get_varsdir_option().get_value()) {
+        append_mtimes(stamp, dir);
+    }
+    append_mtimes(stamp, dnfdaemon::CONF_FILENAME);
+    return stamp;
+}
+
 void Session::setup_base() {
     std::vector<std::unique_ptr<libdnf5::Logger>> loggers;
     loggers.emplace_back(std::make_unique<libdnf5::StdCStreamLogger>(std::cerr));
@@ -148,16 +231,70 @@ void Session::setup_base() {
 
     base->set_download_callbacks(std::make_unique<dnf5daemon::DownloadCB>(*this));
 
+    config_stamp = get_config_files_stamp(*base);
+    restricted_overrides = am_i_root.value_or(false);
+    // the base set up without the denied overrides does not match the session configuration it would be reused for
+    base_modified = am_i_root.has_value() && !am_i_root.value();
+
     // Goal and Transaction instances depend on the base, so reset them as well
     goal = std::make_unique<libdnf5::Goal>(*base);
     transaction.reset(nullptr);
 }
 
+void Session::adopt_base(ReusableBase && reused_base) {
+    base = std::move(reused_base.base);
+    config_stamp = std::move(reused_base.config_stamp);
+    restricted_overrides = reused_base.restricted_overrides;
+    base_modified = false;
+
+    // the callbacks of the base refer to the session that set it up
+    base->set_download_callbacks(std::make_unique<dnf5daemon::DownloadCB>(*this));
+    libdnf5::repo::RepoQuery enabled_repos(*base);
+    enabled_repos.filter_enabled(true);
+    enabled_repos.filter_type(libdnf5::repo::Repo::Type::AVAILABLE);
+    for (auto & repo : enabled_repos) {
+        repo->set_user_data(nullptr);
+        repo->set_callbacks(std::make_unique<dnf5daemon::KeyImportRepoCB>(*this));
+    }
+    repositories_status = dnfdaemon::RepoStatus::READY;
+
+    goal = std::make_unique<libdnf5::Goal>(*base);
+    transaction.reset(nullptr);
+}
+
+std::optional<ReusableBase> Session::release_reusable_base() {
+    // the base must not be used by a running method once it is handed over
+    dbus_object->unregister();
+    threads_manager.finish();
+
+    if (base_modified || repositories_status != dnfdaemon::RepoStatus::READY ||
+        base->get_repo_sack()->has_cmdline_repo()) {
+        return std::nullopt;
+    }
+
+    // Goal and Transaction refer to the base, they are released before the base is used by another session
+    transaction.reset(nullptr);
+    goal.reset();
+    return ReusableBase{
+        get_base_reuse_key(session_configuration), std::move(config_stamp), std::move(base), restricted_overrides};
+}
+
+void Session::note_method_call(std::string_view interface_name, std::string_view method_name) {
+    if (base_modified) {
+        return;
+    }
+    std::string method = fmt::format("{}.{}", interface_name, method_name);
+    if (BASE_READ_ONLY_METHODS.find(method) == BASE_READ_ONLY_METHODS.end()) {
+        base_modified = true;
+    }
+}
+
 Session::Session(
     sdbus::IConnection & connection,
     dnfdaemon::KeyValueMap session_configuration,
     const sdbus::ObjectPath & object_path,
-    const std::string & sender)
+    const std::string & sender,
+    std::optional<ReusableBase> reused_base)
     : connection(connection),
       session_configuration(session_configuration),
       object_path(object_path),
@@ -167,7 +304,16 @@ Session::Session(
     }
 
     dbus_object = sdbus::createObject(connection, object_path);
-    setup_base();
+    // the restricted config overrides are applied only for a sender authorized to use them
+    if (reused_base && reused_base->restricted_overrides &&
+        !check_authorization(dnfdaemon::POLKIT_CONFIG_OVERRIDE, sender, false)) {
+        reused_base.reset();
+    }
+    if (reused_base) {
+        adopt_base(std::move(*reused_base));
+    } else {
+        setup_base();
+    }
 
     // instantiate all services provided by the daemon
     services.emplace_back(std::make_unique<Base>(*this));
@@ -236,21 +382,55 @@ void Session::fill_sack() {
     }
 }
 
+void Session::set_repositories_status(dnfdaemon::RepoStatus status) {
+    {
+        std::lock_guard<std::mutex> lock(repositories_mutex);
+        repositories_status = status;
+    }
+    repositories_condition.notify_all();
+
+    if (status == dnfdaemon::RepoStatus::READY || status == dnfdaemon::RepoStatus::ERROR) {
+        try {
+            auto signal = dbus_object->createSignal(dnfdaemon::INTERFACE_BASE, dnfdaemon::SIGNAL_REPOSITORIES_READY);
+            signal.setDestination(sender);
+            signal << object_path;
+            signal << (status == dnfdaemon::RepoStatus::READY);
+            dbus_object->emitSignal(signal);
+        } catch (...) {
+        }
+    }
+}
+
 bool Session::read_all_repos() {
-    while (repositories_status == dnfdaemon::RepoStatus::PENDING) {
-        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    {
+        // wait for a load running in another call, the status is checked and switched to PENDING under the lock
+        std::unique_lock<std::mutex> lock(repositories_mutex);
+        repositories_condition.wait(lock, [this]() { return repositories_status != dnfdaemon::RepoStatus::PENDING; });
+        if (repositories_status == dnfdaemon::RepoStatus::READY) {
+            return true;
+        } else if (repositories_status == dnfdaemon::RepoStatus::ERROR) {
+            return false;
+        }
+        repositories_status = dnfdaemon::RepoStatus::PENDING;
     }
-    if (repositories_status == dnfdaemon::RepoStatus::READY) {
-        return true;
-    } else if (repositories_status == dnfdaemon::RepoStatus::ERROR) {
-        return false;
+
+    try {
+        bool retval = load_repos();
+        set_repositories_status(retval ? dnfdaemon::RepoStatus::READY : dnfdaemon::RepoStatus::ERROR);
+        return retval;
+    } catch (...) {
+        // release the waiting callers
+        set_repositories_status(dnfdaemon::RepoStatus::ERROR);
+        throw;
     }
-    repositories_status = dnfdaemon::RepoStatus::PENDING;
+}
 
+bool Session::load_repos() {
     bool retval = true;
 
     bool load_available_repos = session_configuration_value<bool>("load_available_repos", true);
     bool load_system_repo = session_configuration_value<bool>("load_system_repo", true);
+    bool warm_solv_caches = session_configuration_value<bool>("warm_solv_caches", false);
     std::vector<std::string> optional_metadata_str =
         session_configuration_value<std::vector<std::string>>("optional_metadata_types", {});
     if (load_available_repos) {
@@ -277,6 +457,9 @@ bool Session::read_all_repos() {
             } else {
                 base->get_repo_sack()->load_repos(libdnf5::repo::Repo::Type::AVAILABLE);
             }
+            if (warm_solv_caches) {
+                base->get_repo_sack()->build_solv_caches();
+            }
         } catch (const std::runtime_error & ex) {
             retval = false;
         }
@@ -284,7 +467,6 @@ bool Session::read_all_repos() {
         base->get_repo_sack()->load_repos(libdnf5::repo::Repo::Type::SYSTEM);
     }
 
-    repositories_status = retval ? dnfdaemon::RepoStatus::READY : dnfdaemon::RepoStatus::ERROR;
     return retval;
 }
 
@@ -32,7 +32,9 @@
 #include <condition_variable>
 #include <memory>
 #include <mutex>
+#include <optional>
 #include <string>
+#include <string_view>
 #include <thread>
 #include <vector>
 
@@ -50,6 +52,20 @@ protected:
     Session & session;
 };
 
+/// Loaded base of a closed session that can be handed over to a new session with the same configuration.
+struct ReusableBase {
+    /// Session configuration the base was set up with, see `Session::get_base_reuse_key()`
+    std::string key;
+    /// Modification times of the configuration files the base was set up from
+    std::string config_stamp;
+    std::unique_ptr<libdnf5::Base> base;
+    /// The base was set up with restricted config option overrides, only an authorized sender can reuse it
+    bool restricted_overrides{false};
+
+    /// @return `true` if neither the configuration files nor the loaded repositories changed since the base was set up.
+    bool is_current() const;
+};
+
 class Session {
 public:
     enum class CancelDownload { NOT_RUNNING, NOT_REQUESTED, REQUESTED, NOT_ALLOWED };
@@ -57,9 +73,16 @@ public:
         sdbus::IConnection & connection,
         dnfdaemon::KeyValueMap session_configuration,
         const sdbus::ObjectPath & object_path,
-        const std::string & sender);
+        const std::string & sender,
+        std::optional<ReusableBase> reused_base = std::nullopt);
     ~Session();
 
+    /// @return The key of the bases that a session with `session_configuration` can reuse.
+    static std::string get_base_reuse_key(const dnfdaemon::KeyValueMap & session_configuration);
+
+    /// @return Modification times of the configuration files `base` was set up from.
+    static std::string get_config_files_stamp(libdnf5::Base & base);
+
     template <typename ItemType>
     ItemType session_configuration_value(const std::string & key, const ItemType & default_value) {
         return dnfdaemon::key_value_map_get(session_configuration, key, default_value);
@@ -84,6 +107,8 @@ public:
     bool check_authorization(
         const std::string & actionid, const std::string & sender, bool allow_user_interaction = true);
     void fill_sack();
+    /// Loads the repositories if they are not loaded yet. If another call is loading them, waits until it finishes.
+    /// @return `true` if the repositories were loaded successfully.
     bool read_all_repos();
     std::optional<std::string> session_locale;
     void confirm_key(const std::string & key_id, const bool confirmed);
@@ -104,8 +129,20 @@ public:
     void reset_goal();
     void reset_base();
 
+    /// Records a D-Bus method call of the session. Any method except the known read-only ones may change the base
+    /// (e.g. resolving a goal or enabling a repository), the base is not reused after such a call.
+    void note_method_call(std::string_view interface_name, std::string_view method_name);
+
+    /// Stops serving the D-Bus methods of the session and takes its base if it can be reused by another session:
+    /// the repositories are loaded and the base was not modified.
+    std::optional<ReusableBase> release_reusable_base();
+
 private:
     void setup_base();
+    void adopt_base(ReusableBase && reused_base);
+    bool load_repos();
+    /// Sets the status of the repositories, wakes up the waiting callers and signals the client once loaded.
+    void set_repositories_status(dnfdaemon::RepoStatus status);
 
     sdbus::IConnection & connection;
     std::unique_ptr<libdnf5::Base> base;
@@ -116,6 +153,12 @@ private:
     std::vector<std::unique_ptr<IDbusSessionService>> services{};
     ThreadsManager threads_manager;
     std::atomic<dnfdaemon::RepoStatus> repositories_status{dnfdaemon::RepoStatus::NOT_READY};
+    // guards changes of repositories_status the callers of read_all_repos() wait for
+    std::mutex repositories_mutex;
+    std::condition_variable repositories_condition;
+    std::string config_stamp;
+    std::atomic<bool> base_modified{false};
+    bool restricted_overrides{false};
     std::unique_ptr<sdbus::IObject> dbus_object;
     std::string sender;
     // repository key import confirmation
@@ -31,6 +31,7 @@
 #include <sstream>
 #include <string>
 #include <thread>
+#include <utility>
 
 // TODO(mblaha): Make this constant configurable
 const unsigned int MAX_SESSIONS = 10;
@@ -165,13 +166,30 @@ sdbus::MethodReply SessionManager::open_session(sdbus::MethodCall & call) {
     dnfdaemon::KeyValueMap configuration;
     call >> configuration;
 
+    // take over the loaded base of a closed session with the same configuration
+    std::optional<ReusableBase> reused_base;
+    auto reuse_key = Session::get_base_reuse_key(configuration);
+    {
+        std::lock_guard<std::mutex> lock(sessions_mutex);
+        if (idle_base && idle_base->key == reuse_key) {
+            reused_base = std::move(idle_base);
+            idle_base.reset();
+        }
+    }
+    // checking the loaded data reads the repository metadata and rpmdb cookie, do it outside of the lock
+    if (reused_base && !reused_base->is_current()) {
+        reused_base.reset();
+    }
+
     // generate UUID-like session id
     const sdbus::ObjectPath sessionid{dnfdaemon::DBUS_OBJECT_PATH + std::string("/") + gen_session_id()};
     // store newly created session
     {
         std::lock_guard<std::mutex> lock(sessions_mutex);
         sessions[sender].emplace(
-            sessionid, std::make_unique<Session>(*connection, std::move(configuration), sessionid, sender));
+            sessionid,
+            std::make_unique<Session>(
+                *connection, std::move(configuration), sessionid, sender, std::move(reused_base)));
     }
 
     auto reply = call.createReply();
@@ -186,13 +204,30 @@ sdbus::MethodReply SessionManager::close_session(sdbus::MethodCall & call) {
     call >> session_id;
 
     bool retval = false;
-    // find sessions created by the same sender
-    auto sender_it = sessions.find(sender);
-    if (sender_it != sessions.end()) {
+    std::unique_ptr<Session> session;
+    {
         std::lock_guard<std::mutex> lock(sessions_mutex);
-        // delete session with given session_id
-        if (sender_it->second.erase(session_id) > 0) {
-            retval = true;
+        // find sessions created by the same sender
+        auto sender_it = sessions.find(sender);
+        if (sender_it != sessions.end()) {
+            // remove session with given session_id
+            auto session_it = sender_it->second.find(session_id);
+            if (session_it != sender_it->second.end()) {
+                session = std::move(session_it->second);
+                sender_it->second.erase(session_it);
+                retval = true;
+            }
+        }
+    }
+
+    if (session) {
+        // keep the loaded base of the session for the next one, it replaces the previously kept base
+        auto reusable_base = session->release_reusable_base();
+        session.reset();
+        if (reusable_base) {
+            std::optional<ReusableBase> replaced_base;
+            std::lock_guard<std::mutex> lock(sessions_mutex);
+            replaced_base = std::exchange(idle_base, std::move(reusable_base));
         }
     }
 
@@ -214,6 +249,7 @@ void SessionManager::shut_down() {
         std::lock_guard<std::mutex> lock(sessions_mutex);
         // wait for current sessions to finish and delete them
         sessions.clear();
+        idle_base.reset();
         // leave the main event loop
         connection->leaveEventLoop();
     }
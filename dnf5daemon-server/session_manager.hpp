@@ -28,6 +28,7 @@
 #include <map>
 #include <memory>
 #include <mutex>
+#include <optional>
 #include <string>
 
 class SessionManager {
@@ -41,7 +42,8 @@ public:
 
 private:
     std::unique_ptr<sdbus::IConnection> connection = nullptr;
-    ThreadsManager threads_manager;
+    // closing a session waits for its running method calls, it must not hold up opening and closing other sessions
+    ThreadsManager threads_manager{ThreadsManager::UNLIMITED_WORKERS};
     std::unique_ptr<sdbus::IObject> dbus_object;
     std::unique_ptr<sdbus::IProxy> name_changed_proxy;
     std::mutex active_mutex;
@@ -50,6 +52,8 @@ private:
     std::mutex sessions_mutex;
     // map {sender_address: {session_id: Session object}}
     std::map<std::string, std::map<std::string, std::unique_ptr<Session>>> sessions;
+    // loaded base of the last closed session waiting to be reused by a new session, guarded by sessions_mutex
+    std::optional<ReusableBase> idle_base;
 
     void dbus_register();
     sdbus::MethodReply open_session(sdbus::MethodCall & call);
@@ -24,66 +24,133 @@
 #include <locale.h>
 
 #include <algorithm>
-#include <chrono>
 #include <iostream>
 
-ThreadsManager::ThreadsManager() {
-    // collecting finished worker threads
-    running_threads_collector = std::thread([this]() {
-        while (!finish_collector) {
-            join_threads(true);
-            std::this_thread::sleep_for(std::chrono::seconds(1));
-        }
-    });
-}
+ThreadsManager::ThreadsManager(std::size_t max_workers, std::size_t max_queued_tasks)
+    : max_workers(std::max<std::size_t>(max_workers, 1)),
+      max_queued_tasks(max_queued_tasks) {}
 
 ThreadsManager::~ThreadsManager() {
     finish();
 }
 
-void ThreadsManager::register_thread(std::thread && thread) {
-    std::lock_guard<std::mutex> lock(running_threads_mutex);
-    running_threads.emplace_back(std::move(thread));
+bool ThreadsManager::submit(std::function<void()> && task, bool serial, bool limit_queue) {
+    {
+        std::lock_guard<std::mutex> lock(tasks_mutex);
+        auto queued_tasks = tasks.size() + serial_tasks.size();
+        if (finishing || (limit_queue && queued_tasks >= max_queued_tasks)) {
+            ++metrics.rejected_tasks;
+            return false;
+        }
+        (serial ? serial_tasks : tasks).push_back(std::move(task));
+        ++queued_tasks;
+        metrics.peak_queued_tasks = std::max(metrics.peak_queued_tasks, queued_tasks);
+        if (idle_workers < queued_tasks && workers.size() < max_workers) {
+            workers.emplace_back(&ThreadsManager::run_worker, this);
+        }
+    }
+    tasks_condition.notify_one();
+    return true;
 }
 
-void ThreadsManager::mark_thread_finished(std::thread::id thread_id) {
-    std::lock_guard<std::mutex> lock(running_threads_mutex);
-    finished_threads.emplace_back(std::move(thread_id));
-}
+void ThreadsManager::run_worker() {
+    std::unique_lock<std::mutex> lock(tasks_mutex);
+    while (true) {
+        auto has_runnable_task = [this]() { return !tasks.empty() || (!serial_tasks.empty() && !serial_task_running); };
+        ++idle_workers;
+        tasks_condition.wait(lock, [&]() {
+            return has_runnable_task() || (finishing && tasks.empty() && serial_tasks.empty());
+        });
+        --idle_workers;
+        if (!has_runnable_task()) {
+            // finishing and all tasks are done
+            return;
+        }
 
-void ThreadsManager::join_threads(const bool only_finished) {
-    std::vector<std::thread> to_be_joined{};
+        bool serial = tasks.empty();
+        auto & queue = serial ? serial_tasks : tasks;
+        auto task = std::move(queue.front());
+        queue.pop_front();
+        if (serial) {
+            serial_task_running = true;
+        }
 
-    {
-        std::lock_guard<std::mutex> lock(running_threads_mutex);
-        for (auto thread = running_threads.begin(); thread < running_threads.end();) {
-            auto in_finished = std::find(finished_threads.begin(), finished_threads.end(), thread->get_id());
-            if (thread->joinable() && (!only_finished || (in_finished != finished_threads.end()))) {
-                to_be_joined.push_back(std::move(*thread));
-                running_threads.erase(thread);
-                if (in_finished != finished_threads.end()) {
-                    finished_threads.erase(in_finished);
-                }
-            } else {
-                ++thread;
+        lock.unlock();
+        task();
+        // destroy the captured call data before the lock is taken again
+        task = nullptr;
+        lock.lock();
+        ++metrics.completed_tasks;
+
+        if (serial) {
+            serial_task_running = false;
+            if (!serial_tasks.empty() || finishing) {
+                // the next serial task may be taken by any waiting worker
+                tasks_condition.notify_all();
             }
         }
     }
+}
+
+void ThreadsManager::finish() {
+    std::vector<std::thread> to_be_joined;
+    bool first_finish;
+    {
+        std::lock_guard<std::mutex> lock(tasks_mutex);
+        first_finish = !finishing;
+        finishing = true;
+        to_be_joined = std::move(workers);
+        workers.clear();
+    }
+    // wake up idle workers, they exit once all queued tasks are done
+    tasks_condition.notify_all();
+    for (auto & worker : to_be_joined) {
+        worker.join();
+    }
 
-    for (auto thread = to_be_joined.begin(); thread < to_be_joined.end(); ++thread) {
-        // join the thread and remove it from registry
-        thread->join();
+    if (first_finish) {
+        auto finished = get_metrics();
+        std::cerr << fmt::format(
+                         "Threads manager finished: {} workers, peak of {} queued tasks, {} completed, {} rejected",
+                         to_be_joined.size(),
+                         finished.peak_queued_tasks,
+                         finished.completed_tasks,
+                         finished.rejected_tasks)
+                  << std::endl;
     }
 }
 
-void ThreadsManager::finish() {
-    if (!running_threads_collector.joinable()) {
-        return;
+ThreadsManager::Metrics ThreadsManager::get_metrics() {
+    std::lock_guard<std::mutex> lock(tasks_mutex);
+    auto current = metrics;
+    current.workers = workers.size();
+    current.queued_tasks = tasks.size() + serial_tasks.size();
+    return current;
+}
+
+bool ThreadsManager::send_reply(sdbus::MethodCall & call, sdbus::MethodReply & reply) {
+    std::string error_msg;
+    try {
+        reply.send();
+        return true;
+    } catch (const std::exception & e) {
+        error_msg = e.what();
+    } catch (...) {
+        error_msg = "Unknown exception caught";
     }
-    // join all threads
-    finish_collector = true;
-    join_threads(false);
-    running_threads_collector.join();
+    std::cerr << fmt::format(
+                     "Error sending D-Bus reply to {}:{}() call: {}",
+                     call.getInterfaceName(),
+                     call.getMemberName(),
+                     error_msg)
+              << std::endl;
+    return false;
+}
+
+void ThreadsManager::reject_method(sdbus::MethodCall & call) {
+    auto reply = call.createErrorReply(sdbus::Error(
+        dnfdaemon::ERROR, "Cannot handle the request, too many requests are pending or the daemon is shutting down."));
+    send_reply(call, reply);
 }
 
 
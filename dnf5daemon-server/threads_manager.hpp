@@ -17,6 +17,7 @@
 // You should have received a copy of the GNU General Public License
 // along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
 
+
 #ifndef DNF5DAEMON_SERVER_THREADS_MANAGER_HPP
 #define DNF5DAEMON_SERVER_THREADS_MANAGER_HPP
 
@@ -27,95 +28,107 @@
 #include <locale.h>
 #include <sdbus-c++/sdbus-c++.h>
 
-#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
 #include <iostream>
+#include <limits>
 #include <mutex>
 #include <optional>
 #include <string>
 #include <thread>
 #include <vector>
 
+/// Runs the D-Bus method calls and signal handlers on a bounded pool of worker threads.
+///
+/// Method calls that use libdnf5 are queued in a serial lane and run one at a time in the order
+/// of their arrival. The other calls (e.g. a key import confirmation the running call waits for) are
+/// taken by any idle worker. When the queue is full, method calls are refused with an error reply.
 class ThreadsManager {
 public:
-    ThreadsManager();
+    /// Default maximal number of worker threads
+    static constexpr std::size_t DEFAULT_MAX_WORKERS = 4;
+    /// Default maximal number of queued method calls waiting for a worker
+    static constexpr std::size_t DEFAULT_MAX_QUEUED_TASKS = 64;
+    /// Maximal number of worker threads of a manager that starts a new worker whenever none is idle, for method
+    /// calls that may wait for a long time and must not hold up the following ones
+    static constexpr std::size_t UNLIMITED_WORKERS = std::numeric_limits<std::size_t>::max();
+
+    /// Load statistics of the manager
+    struct Metrics {
+        /// Number of started worker threads
+        std::size_t workers{0};
+        /// Number of tasks waiting for a worker
+        std::size_t queued_tasks{0};
+        /// Maximal number of tasks that were waiting for a worker at the same time
+        std::size_t peak_queued_tasks{0};
+        /// Number of finished tasks
+        std::uint64_t completed_tasks{0};
+        /// Number of tasks refused because the queue was full or the manager finished
+        std::uint64_t rejected_tasks{0};
+    };
+
+    explicit ThreadsManager(
+        std::size_t max_workers = DEFAULT_MAX_WORKERS, std::size_t max_queued_tasks = DEFAULT_MAX_QUEUED_TASKS);
     virtual ~ThreadsManager();
-    void register_thread(std::thread && thread);
-    void mark_thread_finished(std::thread::id thread_id);
-    void current_thread_finished() { mark_thread_finished(std::this_thread::get_id()); };
-    void join_threads(const bool only_finished);
+
+    /// Stops accepting new tasks, waits for the queued and running ones and joins the workers.
+    /// The metrics are logged when the manager finishes for the first time.
     void finish();
 
+    /// @return The current load statistics of the manager.
+    Metrics get_metrics();
+
     template <class S, bool UseLibdnf5Mutex = true>
     void handle_method(
         S & service,
         sdbus::MethodReply (S::*method)(sdbus::MethodCall &),
         sdbus::MethodCall & call,
         std::optional<std::string> thread_locale = std::nullopt) {
-        auto worker = std::thread(
-            [this](
-                S & service,
-                sdbus::MethodReply (S::*method)(sdbus::MethodCall &),
-                sdbus::MethodCall call,
-                std::optional<std::string> thread_locale = std::nullopt) {
-                locale_t new_locale{nullptr};
-                locale_t orig_locale{nullptr};
-
-                if (thread_locale) {
-                    try {
-                        orig_locale = set_thread_locale(thread_locale.value(), new_locale);
-                    } catch (const std::exception &) {
-                        // Cannot switch to the requested locale, continue with the current one
-                        thread_locale = std::nullopt;
-                    }
-                }
+        auto task = [&service, method, call, thread_locale]() mutable {
+            locale_t new_locale{nullptr};
+            locale_t orig_locale{nullptr};
 
-                sdbus::MethodReply reply;
-                try {
-                    // Use template parameter to control libdnf5 mutex usage per method
-                    // UseLibdnf5Mutex=true (default): Serialize D-Bus method calls that use libdnf5
-                    // UseLibdnf5Mutex=false: Skip mutex for methods that don't need synchronization
-                    std::optional<std::lock_guard<std::mutex>> libdnf5_lock;
-                    if constexpr (UseLibdnf5Mutex) {
-                        libdnf5_lock.emplace(service.get_session().get_libdnf5_mutex());
-                    }
-                    reply = (service.*method)(call);
-                } catch (const sdbus::Error & ex) {
-                    reply = call.createErrorReply(ex);
-                } catch (const std::exception & ex) {
-                    reply = call.createErrorReply(sdbus::Error(dnfdaemon::ERROR, ex.what()));
-                } catch (...) {
-                    reply = call.createErrorReply(sdbus::Error(dnfdaemon::ERROR, "Unknown exception caught"));
-                }
-                bool success = false;
-                std::string error_msg;
+            if (thread_locale) {
                 try {
-                    reply.send();
-                    success = true;
-                } catch (const std::exception & e) {
-                    error_msg = e.what();
-                } catch (...) {
-                    error_msg = "Unknown exception caught";
-                }
-                if (!success) {
-                    std::cerr << fmt::format(
-                                     "Error sending D-Bus reply to {}:{}() call: {}",
-                                     call.getInterfaceName(),
-                                     call.getMemberName(),
-                                     error_msg)
-                              << std::endl;
+                    orig_locale = set_thread_locale(thread_locale.value(), new_locale);
+                } catch (const std::exception &) {
+                    // Cannot switch to the requested locale, continue with the current one
+                    thread_locale = std::nullopt;
                 }
-
-                if (thread_locale) {
-                    uselocale(orig_locale);
-                    freelocale(new_locale);
+            }
+
+            sdbus::MethodReply reply;
+            try {
+                // Use template parameter to control libdnf5 mutex usage per method
+                // UseLibdnf5Mutex=true (default): Serialize D-Bus method calls that use libdnf5
+                // and let the session record the call, it may change the base
+                // UseLibdnf5Mutex=false: Skip mutex for methods that don't need synchronization
+                std::optional<std::lock_guard<std::mutex>> libdnf5_lock;
+                if constexpr (UseLibdnf5Mutex) {
+                    libdnf5_lock.emplace(service.get_session().get_libdnf5_mutex());
+                    service.get_session().note_method_call(call.getInterfaceName(), call.getMemberName());
                 }
-                current_thread_finished();
-            },
-            std::ref(service),
-            method,
-            call,
-            thread_locale);
-        register_thread(std::move(worker));
+                reply = (service.*method)(call);
+            } catch (const sdbus::Error & ex) {
+                reply = call.createErrorReply(ex);
+            } catch (const std::exception & ex) {
+                reply = call.createErrorReply(sdbus::Error(dnfdaemon::ERROR, ex.what()));
+            } catch (...) {
+                reply = call.createErrorReply(sdbus::Error(dnfdaemon::ERROR, "Unknown exception caught"));
+            }
+            send_reply(call, reply);
+
+            if (thread_locale) {
+                uselocale(orig_locale);
+                freelocale(new_locale);
+            }
+        };
+        if (!submit(std::move(task), UseLibdnf5Mutex)) {
+            reject_method(call);
+        }
     }
 
     template <class S, bool UseLibdnf5Mutex = true>
@@ -124,116 +137,114 @@ public:
         void (S::*method)(sdbus::MethodCall &, const std::string &),
         sdbus::MethodCall & call,
         std::optional<std::string> thread_locale = std::nullopt) {
-        auto worker = std::thread(
-            [this](
-                S & service,
-                void (S::*method)(sdbus::MethodCall &, const std::string &),
-                sdbus::MethodCall call,
-                std::optional<std::string> thread_locale = std::nullopt) {
-                static unsigned int counter{0};
-                locale_t new_locale{nullptr};
-                locale_t orig_locale{nullptr};
-
-                if (thread_locale) {
-                    try {
-                        orig_locale = set_thread_locale(thread_locale.value(), new_locale);
-                    } catch (const std::exception &) {
-                        // Cannot switch to the requested locale, continue with the current one
-                        thread_locale = std::nullopt;
-                    }
-                }
+        auto task = [&service, method, call, thread_locale]() mutable {
+            static unsigned int counter{0};
+            locale_t new_locale{nullptr};
+            locale_t orig_locale{nullptr};
 
-                sdbus::MethodReply reply = call.createReply();
-                // generate unique transfer id based on client bus name and counter
-                const std::string transfer_id = fmt::format("{}-{}", call.getSender(), ++counter);
-                reply << transfer_id;
-
-                std::string error_msg;
+            if (thread_locale) {
                 try {
-                    reply.send();
-                } catch (const std::exception & e) {
-                    error_msg = e.what();
-                } catch (...) {
-                    error_msg = "Unknown exception caught";
+                    orig_locale = set_thread_locale(thread_locale.value(), new_locale);
+                } catch (const std::exception &) {
+                    // Cannot switch to the requested locale, continue with the current one
+                    thread_locale = std::nullopt;
                 }
+            }
 
-                if (error_msg.empty()) {
-                    try {
-                        // Use template parameter to control libdnf5 mutex usage per method
-                        // UseLibdnf5Mutex=true (default): Serialize D-Bus method calls that use libdnf5
-                        // UseLibdnf5Mutex=false: Skip mutex for methods that don't need synchronization
-                        std::optional<std::lock_guard<std::mutex>> libdnf5_lock;
-                        if constexpr (UseLibdnf5Mutex) {
-                            libdnf5_lock.emplace(service.get_session().get_libdnf5_mutex());
-                        }
-                        (service.*method)(call, transfer_id);
-                    } catch (...) {
-                        // TODO(mblaha): log the error
-                    }
-                } else {
-                    std::cerr << fmt::format(
-                                     "Error sending D-Bus reply to {}:{}() call: {}",
-                                     call.getInterfaceName(),
-                                     call.getMemberName(),
-                                     error_msg)
-                              << std::endl;
-                }
+            sdbus::MethodReply reply = call.createReply();
+            // generate unique transfer id based on client bus name and counter
+            const std::string transfer_id = fmt::format("{}-{}", call.getSender(), ++counter);
+            reply << transfer_id;
 
-                if (thread_locale) {
-                    uselocale(orig_locale);
-                    freelocale(new_locale);
+            if (send_reply(call, reply)) {
+                try {
+                    // Use template parameter to control libdnf5 mutex usage per method
+                    // UseLibdnf5Mutex=true (default): Serialize D-Bus method calls that use libdnf5
+                    // and let the session record the call, it may change the base
+                    // UseLibdnf5Mutex=false: Skip mutex for methods that don't need synchronization
+                    std::optional<std::lock_guard<std::mutex>> libdnf5_lock;
+                    if constexpr (UseLibdnf5Mutex) {
+                        libdnf5_lock.emplace(service.get_session().get_libdnf5_mutex());
+                        service.get_session().note_method_call(call.getInterfaceName(), call.getMemberName());
+                    }
+                    (service.*method)(call, transfer_id);
+                } catch (...) {
+                    // TODO(mblaha): log the error
                 }
-
-                current_thread_finished();
-            },
-            std::ref(service),
-            method,
-            call,
-            thread_locale);
-        register_thread(std::move(worker));
+            }
+
+            if (thread_locale) {
+                uselocale(orig_locale);
+                freelocale(new_locale);
+            }
+        };
+        if (!submit(std::move(task), UseLibdnf5Mutex)) {
+            reject_method(call);
+        }
     }
 
     template <class S>
     void handle_signal(S & service, void (S::*method)(sdbus::Signal &), sdbus::Signal & signal) {
-        auto worker = std::thread(
-            [this](S & service, void (S::*method)(sdbus::Signal &), sdbus::Signal signal) {
-                bool success = false;
-                std::string error_msg;
-                try {
-                    (service.*method)(signal);
-                    success = true;
-                } catch (const std::exception & ex) {
-                    error_msg = ex.what();
-                } catch (...) {
-                    error_msg = "Unknown exception caught";
-                }
-                if (!success) {
-                    std::cerr << fmt::format(
-                                     "Error handling signal {}:{}: {}",
-                                     signal.getInterfaceName(),
-                                     signal.getMemberName(),
-                                     error_msg)
-                              << std::endl;
-                }
-                current_thread_finished();
-            },
-            std::ref(service),
-            method,
-            signal);
-        register_thread(std::move(worker));
+        auto task = [&service, method, signal]() mutable {
+            bool success = false;
+            std::string error_msg;
+            try {
+                (service.*method)(signal);
+                success = true;
+            } catch (const std::exception & ex) {
+                error_msg = ex.what();
+            } catch (...) {
+                error_msg = "Unknown exception caught";
+            }
+            if (!success) {
+                std::cerr << fmt::format(
+                                 "Error handling signal {}:{}: {}",
+                                 signal.getInterfaceName(),
+                                 signal.getMemberName(),
+                                 error_msg)
+                          << std::endl;
+            }
+        };
+        // signals are not refused when the queue is full, only after the manager finished
+        if (!submit(std::move(task), false, false)) {
+            std::cerr << fmt::format(
+                             "Signal {}:{} ignored, the daemon is shutting down",
+                             signal.getInterfaceName(),
+                             signal.getMemberName())
+                      << std::endl;
+        }
     }
 
 private:
-    std::mutex running_threads_mutex;
-    // flag whether to break the finished threads collector infinite loop
-    std::atomic<bool> finish_collector{false};
-    // thread that joins finished worker threads
-    std::thread running_threads_collector;
-    // vector of started worker threads
-    std::vector<std::thread> running_threads{};
-    // vector of finished threads id
-    std::vector<std::thread::id> finished_threads{};
+    /// Queues the `task`, starts a new worker if there are more queued tasks than idle workers.
+    /// @param serial  Whether the task runs in the serial lane.
+    /// @param limit_queue  Whether the task is refused when the queue is full.
+    /// @return `false` if the task was refused.
+    bool submit(std::function<void()> && task, bool serial, bool limit_queue = true);
+    void run_worker();
+
+    /// Sends the method reply, logs the error if it cannot be sent.
+    /// @return `true` if the reply was sent.
+    static bool send_reply(sdbus::MethodCall & call, sdbus::MethodReply & reply);
+    /// Replies with an error to a method call that was not queued.
+    void reject_method(sdbus::MethodCall & call);
     static locale_t set_thread_locale(const std::string & thread_locale, locale_t & new_locale);
+
+    const std::size_t max_workers;
+    const std::size_t max_queued_tasks;
+
+    std::mutex tasks_mutex;
+    std::condition_variable tasks_condition;
+    // tasks that can be run by any idle worker
+    std::deque<std::function<void()>> tasks;
+    // tasks run one at a time in the order of their arrival
+    std::deque<std::function<void()>> serial_tasks;
+    bool serial_task_running{false};
+    // flag whether new tasks are refused and idle workers exit
+    bool finishing{false};
+    std::size_t idle_workers{0};
+    std::vector<std::thread> workers;
+    Metrics metrics;
 };
 
 #endif
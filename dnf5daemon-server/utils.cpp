@@ -80,4 +80,29 @@ bool write_to_fd(const std::string & message, int out_fd, std::string & error_ms
     return success;
 }
 
+BufferedFdWriter::BufferedFdWriter(int out_fd, std::size_t batch_size) : out_fd(out_fd), batch_size(batch_size) {
+    // a larger pipe takes a batch in fewer writes, the capacity stays unchanged if it cannot be enlarged
+    if (fcntl(out_fd, F_GETPIPE_SZ) > 0) {
+        fcntl(out_fd, F_SETPIPE_SZ, static_cast<int>(batch_size));
+    }
+    buffer.reserve(batch_size);
+}
+
+bool BufferedFdWriter::write(std::string_view message, std::string & error_msg) {
+    buffer.append(message);
+    if (buffer.size() < batch_size) {
+        return true;
+    }
+    return flush(error_msg);
+}
+
+bool BufferedFdWriter::flush(std::string & error_msg) {
+    if (buffer.empty()) {
+        return true;
+    }
+    bool success = write_to_fd(buffer, out_fd, error_msg);
+    buffer.clear();
+    return success;
+}
+
 }  // namespace dnfdaemon
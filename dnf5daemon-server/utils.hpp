@@ -26,7 +26,9 @@
 #include <fmt/format.h>
 #include <sdbus-c++/sdbus-c++.h>
 
+#include <cstddef>
 #include <string>
+#include <string_view>
 
 namespace dnfdaemon {
 
@@ -64,6 +66,32 @@ ItemType key_value_map_get(
 /// @return True in case the write succeeded, False otherwise.
 bool write_to_fd(const std::string & message, int out_fd, std::string & error_msg);
 
+/// Collects messages and writes them to the file descriptor in large batches instead of one write per message.
+class BufferedFdWriter {
+public:
+    static constexpr std::size_t DEFAULT_BATCH_SIZE = 1024 * 1024;
+
+    /// If the file descriptor is a pipe, tries to enlarge its capacity to `batch_size`.
+    /// @param out_fd Open file descriptor
+    /// @param batch_size Amount of collected data that triggers writing to the file descriptor
+    explicit BufferedFdWriter(int out_fd, std::size_t batch_size = DEFAULT_BATCH_SIZE);
+
+    /// Appends the message, writes the collected data once there is at least `batch_size` of them.
+    /// @param error_msg In case of error this string contains error description
+    /// @return True in case the write succeeded or was postponed, False otherwise.
+    bool write(std::string_view message, std::string & error_msg);
+
+    /// Writes the collected data.
+    /// @param error_msg In case of error this string contains error description
+    /// @return True in case the write succeeded, False otherwise.
+    bool flush(std::string & error_msg);
+
+private:
+    int out_fd;
+    std::size_t batch_size;
+    std::string buffer;
+};
+
 }  // namespace dnfdaemon
 
 #endif
@@ -108,6 +108,10 @@ public:
     /// The destination directory for downloaded RPMs is taken from the `destdir`
     /// configuration option. If it's not specified, the standard location of
     /// repo cachedir/packages is used.
+    ///
+    /// Unless the `downloadonly` option is set, signatures of the packages are verified
+    /// in background threads as soon as they are downloaded. The passed checks are then
+    /// reused by `check_gpg_signatures()`.
     void download();
 
     /// Check the transaction by running it with RPMTRANS_FLAG_TEST. The import
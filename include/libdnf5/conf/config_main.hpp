@@ -228,6 +228,8 @@ public:
     const OptionBool & get_protect_running_kernel_option() const;
     OptionBool & get_build_cache_option();
     const OptionBool & get_build_cache_option() const;
+    OptionBool & get_build_search_index_option();
+    const OptionBool & get_build_search_index_option() const;
     OptionBool & get_skip_system_repo_lock_option();
     const OptionBool & get_skip_system_repo_lock_option() const;
 
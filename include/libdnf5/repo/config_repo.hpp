@@ -149,6 +149,10 @@ public:
     /// If true it will create libsolv cache that will speed up the next loading process
     OptionChild<OptionBool> & get_build_cache_option();
     const OptionChild<OptionBool> & get_build_cache_option() const;
+    /// If true it will create an index that will speed up the substring search in package summaries,
+    /// descriptions and URLs
+    OptionChild<OptionBool> & get_build_search_index_option();
+    const OptionChild<OptionBool> & get_build_search_index_option() const;
 
     // option recognized by other tools, e.g. gnome-software, but unused in dnf
     OptionString & get_enabled_metadata_option();
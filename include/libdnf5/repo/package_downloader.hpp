@@ -26,13 +26,18 @@
 #include "libdnf5/defs.h"
 #include "libdnf5/rpm/package.hpp"
 
+#include <functional>
 #include <memory>
 #include <optional>
+#include <string>
 
 namespace libdnf5::repo {
 
 class LIBDNF_API PackageDownloader {
 public:
+    /// Function called with a package and the path of its file in the destination directory.
+    using PackageReadyCallback = std::function<void(const libdnf5::rpm::Package & package, const std::string & path)>;
+
     explicit PackageDownloader(const libdnf5::BaseWeakPtr & base);
     explicit PackageDownloader(libdnf5::Base & base);
     ~PackageDownloader();
@@ -70,6 +75,13 @@ public:
     /// the next successful transaction.
     void force_keep_packages(bool value);
 
+    /// Set a function that is called for each package as soon as its file is complete in the destination
+    /// directory (downloaded or already present), while other packages may still be downloading.
+    /// This allows to pipeline the processing of packages (e.g. signature checks) with the download.
+    /// The function is called from the thread running `download()`.
+    /// @param callback The function to call, an empty function unsets the callback.
+    void set_package_ready_callback(PackageReadyCallback callback);
+
 private:
     class LIBDNF_LOCAL Impl;
     std::unique_ptr<Impl> p_impl;
@@ -41,6 +41,7 @@ class Pool;
 
 namespace libdnf5::rpm {
 class Package;
+class PackageQuery;
 class PackageSack;
 }  // namespace libdnf5::rpm
 
@@ -321,10 +322,12 @@ private:
     class LIBDNF_LOCAL Impl;
     friend class RepoSack;
     friend class rpm::Package;
+    friend class rpm::PackageQuery;
     friend class rpm::PackageSack;
     friend class FileDownloader;
     friend class PackageDownloader;
     friend class RepoDownloader;
+    friend class SolvRepo;
     friend class solv::Pool;
 
     /// Loads the repository objects into sacks.
@@ -332,6 +335,12 @@ private:
     /// Also writes the libsolv's solv/solvx cache files.
     LIBDNF_LOCAL void load();
 
+    /// Writes the libsolv's solv/solvx cache files of an available repository without loading it into sacks.
+    ///
+    /// Metadata are parsed into a private pool, so it can be called concurrently for different repositories.
+    /// A following `load()` then only reads the cache files.
+    LIBDNF_LOCAL void build_solv_cache();
+
     LIBDNF_LOCAL void add_libsolv_testcase(const std::string & path);
 
     /// Adds an RPM package at `path` to the repository.
@@ -368,6 +377,10 @@ private:
 
     LIBDNF_LOCAL bool is_loaded() const;
 
+    /// @return `false` if the loaded repo is outdated: the metadata of an available repo expired or changed on disk,
+    ///         or the rpmdb loaded into the system repo changed. A repo that is not loaded is always current.
+    LIBDNF_LOCAL bool is_loaded_data_current() const;
+
     /// Requires that the repo is loaded
     LIBDNF_LOCAL SolvRepo & get_solv_repo() const;
 
@@ -133,6 +133,21 @@ public:
     /// It also sets up modular filtering.
     void load_repos();
 
+    /// Completes the solv cache files of the loaded repositories, so that the following runs find them up to date.
+    /// The caches are written while the repositories are loaded, this also computes the file provides which are
+    /// otherwise added to the caches by the first query or goal that needs them.
+    /// Repositories with disabled `build_cache` option are skipped.
+    /// If the file provides were already computed, the caches were completed at that time and nothing is written.
+    /// @since 5.4
+    void build_solv_caches();
+
+    /// Checks whether the loaded repositories still reflect the data on the disk: the metadata of the available
+    /// repositories are neither expired nor replaced and the rpmdb loaded into the system repository did not change.
+    /// Allows a long-running process to reuse the loaded repositories until they become outdated.
+    /// @return `false` if any loaded repository is outdated.
+    /// @since 5.4
+    bool is_loaded_data_current() const;
+
     RepoSackWeakPtr get_weak_ptr();
 
     /// @return The `Base` object to which this object belongs.
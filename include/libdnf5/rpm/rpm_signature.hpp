@@ -28,6 +28,7 @@
 
 #include <functional>
 #include <string>
+#include <vector>
 
 namespace libdnf5::rpm {
 
@@ -95,6 +96,13 @@ public:
     ///         CheckResult::FAILED - check failed for another reason
     CheckResult check_package_signature(const Package & pkg) const;
 
+    /// Check signatures of the `packages` using public keys stored in rpm database.
+    /// The packages are verified concurrently by a pool of worker threads. Each
+    /// package is handled the same way as by `check_package_signature(const Package &)`.
+    /// @param packages: packages to check.
+    /// @return Check results in the same order as the `packages`.
+    std::vector<CheckResult> check_package_signatures(const std::vector<Package> & packages) const;
+
     /// Check signature of rpm file in `path` location using public keys stored in
     /// rpm database.
     /// @param package: package to check.
@@ -142,15 +142,18 @@ bool AdvisoryPackage::Impl::is_resolved_in(const libdnf5::rpm::PackageSet & pkgs
         sorted_solvables.begin(),
         sorted_solvables.end(),
         *this,
-        libdnf5::advisory::AdvisoryPackage::Impl::name_arch_compare_lower_solvable);
-    while (low != sorted_solvables.end() && (*low)->name == get_name_id() && (*low)->arch == get_arch_id()) {
-        int libsolv_cmp = pool.evrcmp((*low)->evr, get_evr_id(), EVRCMP_COMPARE);
+        libdnf5::rpm::solvable_id_cmp(pool, AdvisoryPackage::Impl::name_arch_compare_lower_solvable));
+    for (; low != sorted_solvables.end(); ++low) {
+        Solvable * solvable = pool.id2solvable(*low);
+        if (solvable->name != get_name_id() || solvable->arch != get_arch_id()) {
+            break;
+        }
+        int libsolv_cmp = pool.evrcmp(solvable->evr, get_evr_id(), EVRCMP_COMPARE);
         if (libsolv_cmp >= 0) {  // We are interested only in lower or equal evr
-            if (pkgs.p_impl->contains(pool.solvable2id(*low))) {
+            if (pkgs.p_impl->contains(*low)) {
                 return true;
             }
         }
-        ++low;
     }
 
     return false;
@@ -28,6 +28,7 @@
 #include "../repo/repo_sack_private.hpp"
 #include "repo/temp_files_memory.hpp"
 #include "rpm/package_set_impl.hpp"
+#include "rpm/signature_check_pool.hpp"
 #include "solv/pool.hpp"
 #include "solver_problems_internal.hpp"
 #include "transaction/transaction_sr.hpp"
@@ -55,6 +56,7 @@
 
 #include <filesystem>
 #include <iostream>
+#include <optional>
 #include <ranges>
 #include <sstream>
 #include <string_view>
@@ -419,7 +421,23 @@ void Transaction::download() {
             downloader.add(tspkg.get_package());
         }
     }
+
+    // Check signatures of the downloaded packages while the others are still downloading.
+    // It is not worth it when the transaction is not going to be run.
+    std::optional<libdnf5::rpm::SignatureCheckPool> signature_check_pool;
+    if (!p_impl->base->get_config().get_downloadonly_option().get_value()) {
+        signature_check_pool.emplace(p_impl->base);
+        downloader.set_package_ready_callback(
+            [&signature_check_pool](const libdnf5::rpm::Package & package, const std::string & path) {
+                signature_check_pool->add(package, path);
+            });
+    }
+
     downloader.download();
+
+    if (signature_check_pool) {
+        p_impl->prechecked_signatures = signature_check_pool->finish();
+    }
 }
 
 Transaction::TransactionRunResult Transaction::test() {
@@ -1425,62 +1443,115 @@ ImportRepoKeysResult Transaction::Impl::import_repo_keys(libdnf5::repo::Repo & r
     return ImportRepoKeysResult::OK;
 }
 
+std::optional<SignatureCheckProblem> resolve_signature_check_results(
+    std::vector<libdnf5::rpm::RpmSignature::CheckResult> & check_results,
+    const std::vector<std::string> & repo_ids,
+    const std::function<libdnf5::rpm::RpmSignature::CheckResult(std::size_t)> & check_package,
+    const std::function<ImportRepoKeysResult(std::size_t)> & import_keys) {
+    using CheckResult = libdnf5::rpm::RpmSignature::CheckResult;
+    // these two errors are possibly recoverable by importing the correct public key
+    auto is_error_recoverable = [](CheckResult check_result) {
+        return check_result == CheckResult::FAILED_KEY_MISSING || check_result == CheckResult::FAILED_NOT_TRUSTED;
+    };
+
+    std::set<std::string> processed_repos;
+    bool keys_imported{false};
+    for (std::size_t idx = 0; idx < check_results.size(); ++idx) {
+        auto & check_result = check_results[idx];
+        if (is_error_recoverable(check_result) && keys_imported) {
+            // the package was verified before some keys were imported, they can belong to any repository
+            check_result = check_package(idx);
+        }
+        if (check_result == CheckResult::OK || check_result == CheckResult::SKIPPED) {
+            continue;
+        }
+        if (!is_error_recoverable(check_result)) {
+            return SignatureCheckProblem{idx, check_result, std::nullopt};
+        }
+
+        // do not try to import keys for the same repo twice
+        if (!processed_repos.insert(repo_ids[idx]).second) {
+            return SignatureCheckProblem{idx, check_result, ImportRepoKeysResult::ALREADY_PRESENT};
+        }
+        auto import_result = import_keys(idx);
+        if (import_result != ImportRepoKeysResult::OK) {
+            return SignatureCheckProblem{idx, check_result, import_result};
+        }
+        keys_imported = true;
+        check_result = check_package(idx);
+        if (check_result != CheckResult::OK) {
+            return SignatureCheckProblem{idx, check_result, ImportRepoKeysResult::OK};
+        }
+    }
+    return std::nullopt;
+}
+
 bool Transaction::Impl::check_gpg_signatures() {
     bool result{true};
     // TODO(mblaha): DNSsec key verification
     libdnf5::rpm::RpmSignature rpm_signature(base);
-    std::set<std::string> processed_repos{};
     unsigned long num_checks_skipped = 0;
     std::set<std::string> repos_with_skipped_checks;
+
+    // verify all inbound packages concurrently, the results are then processed in the transaction order
+    std::vector<libdnf5::rpm::Package> inbound_packages;
     for (const auto & trans_pkg : packages) {
         if (transaction_item_action_is_inbound(trans_pkg.get_action())) {
-            auto const & pkg = trans_pkg.get_package();
-            auto repo = pkg.get_repo();
-            auto err_msg = utils::sformat(
-                _("OpenPGP check for package \"{}\" ({}) from repo \"{}\" has failed: "),
-                pkg.get_nevra(),
-                pkg.get_package_path(),
-                repo->get_id());
-            auto check_result = rpm_signature.check_package_signature(pkg);
-            if (check_result == libdnf5::rpm::RpmSignature::CheckResult::SKIPPED) {
-                num_checks_skipped += 1;
-                repos_with_skipped_checks.insert(pkg.get_repo_id());
-            } else if (check_result != libdnf5::rpm::RpmSignature::CheckResult::OK) {
-                // these two errors are possibly recoverable by importing the correct public key
-                auto is_error_recoverable =
-                    check_result == libdnf5::rpm::RpmSignature::CheckResult::FAILED_KEY_MISSING ||
-                    check_result == libdnf5::rpm::RpmSignature::CheckResult::FAILED_NOT_TRUSTED;
-                if (is_error_recoverable) {
-                    // do not try to import keys for the same repo twice
-                    auto repo_id = repo->get_id();
-                    if (processed_repos.contains(repo_id)) {
-                        signature_problems.push_back(
-                            err_msg + import_repo_keys_result_to_string(ImportRepoKeysResult::ALREADY_PRESENT));
-                        result = false;
-                        break;
-                    }
-                    processed_repos.emplace(repo_id);
-
-                    auto import_result = import_repo_keys(*repo);
-                    if (import_result == ImportRepoKeysResult::OK) {
-                        auto check_again = rpm_signature.check_package_signature(pkg);
-                        if (check_again != libdnf5::rpm::RpmSignature::CheckResult::OK) {
-                            signature_problems.push_back(err_msg + _("Import of the key didn't help, wrong key?"));
-                            result = false;
-                            break;
-                        }
-                    } else {
-                        signature_problems.push_back(err_msg + import_repo_keys_result_to_string(import_result));
-                        result = false;
-                        break;
-                    }
-                } else {
-                    signature_problems.push_back(err_msg + rpm_signature.check_result_to_string(check_result));
-                    result = false;
-                    break;
-                }
-            }
+            inbound_packages.push_back(trans_pkg.get_package());
+        }
+    }
+
+    // packages with signatures verified already during the download need not be checked again
+    std::vector<libdnf5::rpm::RpmSignature::CheckResult> check_results(
+        inbound_packages.size(), libdnf5::rpm::RpmSignature::CheckResult::OK);
+    std::vector<libdnf5::rpm::Package> unchecked_packages;
+    std::vector<std::size_t> unchecked_idxs;
+    for (std::size_t idx = 0; idx < inbound_packages.size(); ++idx) {
+        auto precheck = prechecked_signatures.find(inbound_packages[idx].get_package_path());
+        if (precheck == prechecked_signatures.end() ||
+            precheck->second != libdnf5::rpm::RpmSignature::CheckResult::OK) {
+            unchecked_packages.push_back(inbound_packages[idx]);
+            unchecked_idxs.push_back(idx);
+        }
+    }
+    auto unchecked_results = rpm_signature.check_package_signatures(unchecked_packages);
+    for (std::size_t i = 0; i < unchecked_idxs.size(); ++i) {
+        check_results[unchecked_idxs[i]] = unchecked_results[i];
+    }
+
+    std::vector<std::string> repo_ids;
+    repo_ids.reserve(inbound_packages.size());
+    for (const auto & pkg : inbound_packages) {
+        repo_ids.push_back(pkg.get_repo_id());
+    }
+    auto problem = resolve_signature_check_results(
+        check_results,
+        repo_ids,
+        [&](std::size_t idx) { return rpm_signature.check_package_signature(inbound_packages[idx]); },
+        [&](std::size_t idx) { return import_repo_keys(*inbound_packages[idx].get_repo()); });
+
+    auto checked_count = problem ? problem->package_idx : inbound_packages.size();
+    for (std::size_t idx = 0; idx < checked_count; ++idx) {
+        if (check_results[idx] == libdnf5::rpm::RpmSignature::CheckResult::SKIPPED) {
+            num_checks_skipped += 1;
+            repos_with_skipped_checks.insert(repo_ids[idx]);
+        }
+    }
+    if (problem) {
+        auto const & pkg = inbound_packages[problem->package_idx];
+        auto err_msg = utils::sformat(
+            _("OpenPGP check for package \"{}\" ({}) from repo \"{}\" has failed: "),
+            pkg.get_nevra(),
+            pkg.get_package_path(),
+            pkg.get_repo_id());
+        if (!problem->import_result) {
+            signature_problems.push_back(err_msg + rpm_signature.check_result_to_string(problem->check_result));
+        } else if (*problem->import_result == ImportRepoKeysResult::OK) {
+            signature_problems.push_back(err_msg + _("Import of the key didn't help, wrong key?"));
+        } else {
+            signature_problems.push_back(err_msg + import_repo_keys_result_to_string(*problem->import_result));
         }
+        result = false;
     }
     if (num_checks_skipped > 0) {
         auto repo_string = libdnf5::utils::string::join(
@@ -37,13 +37,40 @@
 
 #include <solv/transaction.h>
 
+#include <functional>
+#include <map>
 #include <mutex>
+#include <optional>
 
 
 namespace libdnf5::base {
 
 enum class ImportRepoKeysResult { OK, NO_KEYS, ALREADY_PRESENT, IMPORT_DECLINED, IMPORT_FAILED };
 
+/// The first inbound package whose signature could not be verified, see resolve_signature_check_results().
+struct SignatureCheckProblem {
+    std::size_t package_idx;
+    libdnf5::rpm::RpmSignature::CheckResult check_result;
+    /// Result of the key import attempt, empty if the failure is not recoverable by a key import.
+    /// `OK` means the keys were imported but the package still failed the check.
+    std::optional<ImportRepoKeysResult> import_result;
+};
+
+/// Process signature check results of inbound packages in the transaction order. Recoverable failures
+/// (missing or untrusted key) trigger an import of the keys of the package's repository, each repository
+/// is processed at most once. Once any key has been imported, every later recoverable failure is checked
+/// again before importing, since the imported key may be shared by several repositories.
+/// @param check_results Results of the initial checks, updated in place by the rechecks.
+/// @param repo_ids Repository ids of the packages, indexed like `check_results`.
+/// @param check_package Checks the signature of the package with the given index again.
+/// @param import_keys Imports the keys of the repository of the package with the given index.
+/// @return The first problem that could not be resolved, or empty if all packages passed or were skipped.
+std::optional<SignatureCheckProblem> resolve_signature_check_results(
+    std::vector<libdnf5::rpm::RpmSignature::CheckResult> & check_results,
+    const std::vector<std::string> & repo_ids,
+    const std::function<libdnf5::rpm::RpmSignature::CheckResult(std::size_t)> & check_package,
+    const std::function<ImportRepoKeysResult(std::size_t)> & import_keys);
+
 class Transaction::Impl {
 public:
     Impl(Transaction & transaction, const BaseWeakPtr & base);
@@ -126,6 +153,8 @@ private:
 
     std::vector<std::string> transaction_problems{};
     std::vector<std::string> signature_problems{};
+    // results of the signature checks done while downloading the packages, keyed by package paths
+    std::map<std::string, libdnf5::rpm::RpmSignature::CheckResult> prechecked_signatures{};
 
     std::vector<std::vector<std::pair<libdnf5::ProblemRules, std::vector<std::string>>>> solver_problems{};
     std::vector<libdnf5::rpm::Package> broken_dependency_packages;
@@ -234,6 +234,7 @@ class ConfigMain::Impl {
     OptionBool countme{false};
     OptionBool protect_running_kernel{true};
     OptionBool build_cache{true};
+    OptionBool build_search_index{false};
     OptionBool skip_system_repo_lock{false};
 
     // Repo main config
@@ -413,6 +414,7 @@ ConfigMain::Impl::Impl(Config & owner) : owner(owner) {
     owner.opt_binds().add("countme", countme);
     owner.opt_binds().add("protect_running_kernel", protect_running_kernel);
     owner.opt_binds().add("build_cache", build_cache);
+    owner.opt_binds().add("build_search_index", build_search_index);
     owner.opt_binds().add("skip_system_repo_lock", skip_system_repo_lock);
 
     // Repo main config
@@ -1065,6 +1067,12 @@ OptionBool & ConfigMain::get_build_cache_option() {
 const OptionBool & ConfigMain::get_build_cache_option() const {
     return p_impl->build_cache;
 }
+OptionBool & ConfigMain::get_build_search_index_option() {
+    return p_impl->build_search_index;
+}
+const OptionBool & ConfigMain::get_build_search_index_option() const {
+    return p_impl->build_search_index;
+}
 OptionBool & ConfigMain::get_skip_system_repo_lock_option() {
     return p_impl->skip_system_repo_lock;
 }
@@ -1468,6 +1476,7 @@ void ConfigMain::Impl::load_from_config(const ConfigMain::Impl & other) {
     load_option(countme, other.countme);
     load_option(protect_running_kernel, other.protect_running_kernel);
     load_option(build_cache, other.build_cache);
+    load_option(build_search_index, other.build_search_index);
     load_option(skip_system_repo_lock, other.skip_system_repo_lock);
 
     // Repo main config
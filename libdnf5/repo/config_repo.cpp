@@ -97,6 +97,7 @@ class ConfigRepo::Impl {
     OptionChild<OptionBool> countme{main_config.get_countme_option()};
     OptionEnum failovermethod{"priority", {"priority", "roundrobin"}};
     OptionChild<OptionBool> build_cache{main_config.get_build_cache_option()};
+    OptionChild<OptionBool> build_search_index{main_config.get_build_search_index_option()};
 };
 
 ConfigRepo::Impl::Impl(Config & owner, ConfigMain & main_config, const std::string & id)
@@ -184,6 +185,7 @@ ConfigRepo::Impl::Impl(Config & owner, ConfigMain & main_config, const std::stri
     owner.opt_binds().add("user_agent", user_agent);
     owner.opt_binds().add("countme", countme);
     owner.opt_binds().add("build_cache", build_cache);
+    owner.opt_binds().add("build_search_index", build_search_index);
 }
 
 ConfigRepo::ConfigRepo(ConfigMain & main_config, const std::string & id) : p_impl(new Impl(*this, main_config, id)) {}
@@ -569,6 +571,13 @@ const OptionChild<OptionBool> & ConfigRepo::get_build_cache_option() const {
     return p_impl->build_cache;
 }
 
+OptionChild<OptionBool> & ConfigRepo::get_build_search_index_option() {
+    return p_impl->build_search_index;
+}
+const OptionChild<OptionBool> & ConfigRepo::get_build_search_index_option() const {
+    return p_impl->build_search_index;
+}
+
 
 std::string ConfigRepo::get_unique_id() const {
     std::string tmp;
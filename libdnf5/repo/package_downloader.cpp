@@ -70,12 +70,25 @@ public:
     void * user_data;
     void * user_cb_data{nullptr};
     bool need_call_end_callback{false};
+    const PackageDownloader::PackageReadyCallback * ready_callback{nullptr};
+
+    /// Notify the ready callback about the completed package file.
+    void package_ready() const {
+        if (ready_callback && *ready_callback) {
+            (*ready_callback)(
+                package,
+                std::filesystem::path(destination) / std::filesystem::path(package.get_location()).filename());
+        }
+    }
 };
 
 static int end_callback(void * data, LrTransferStatus status, const char * msg) {
     libdnf_assert(data != nullptr, "data in callback must be set");
 
     auto * package_target = static_cast<PackageTarget *>(data);
+    if (status == LR_TRANSFER_SUCCESSFUL || status == LR_TRANSFER_ALREADYEXISTS) {
+        package_target->package_ready();
+    }
     auto cb_status = static_cast<DownloadCallbacks::TransferStatus>(status);
     if (auto * download_callbacks = package_target->package.get_base()->get_download_callbacks()) {
         libdnf_assert(package_target->need_call_end_callback == true, "unexpected end_callback call");
@@ -116,6 +129,7 @@ private:
     BaseWeakPtr base;
 
     std::vector<PackageTarget> targets;
+    PackageReadyCallback ready_callback;
     std::optional<bool> keep_packages;
     bool fail_fast;
     bool resume;
@@ -157,6 +171,7 @@ void PackageDownloader::download() try {
         }
 
         std::filesystem::create_directories(pkg_target.destination);
+        pkg_target.ready_callback = &p_impl->ready_callback;
 
         if (auto * download_callbacks = pkg_target.package.get_base()->get_download_callbacks()) {
             pkg_target.user_cb_data = download_callbacks->add_new_download(
@@ -229,6 +244,9 @@ void PackageDownloader::download() try {
         if (!same_file) {
             std::filesystem::copy(source, destination, std::filesystem::copy_options::overwrite_existing, ec);
         }
+        if (!ec) {
+            local_pkg_target->package_ready();
+        }
         if (auto * download_callbacks = local_pkg_target->package.get_base()->get_download_callbacks()) {
             std::string msg;
             DownloadCallbacks::TransferStatus status;
@@ -301,4 +319,8 @@ void PackageDownloader::force_keep_packages(bool value) {
     p_impl->keep_packages = value;
 }
 
+void PackageDownloader::set_package_ready_callback(PackageReadyCallback callback) {
+    p_impl->ready_callback = std::move(callback);
+}
+
 }  // namespace libdnf5::repo
@@ -265,6 +265,31 @@ void Repo::load() {
     p_impl->base->get_rpm_package_sack()->p_impl->invalidate_provides();
 }
 
+void Repo::build_solv_cache() {
+    if (p_impl->type != Type::AVAILABLE || is_loaded()) {
+        return;
+    }
+
+    // Only the types that extend the rpm pool, comps use a separate pool
+    auto optional_metadata = p_impl->config.get_main_config().get_optional_metadata_types_option().get_value();
+    const bool all_metadata = optional_metadata.contains(libdnf5::METADATA_TYPE_ALL);
+    std::vector<RepodataType> ext_types;
+    if (all_metadata || optional_metadata.contains(libdnf5::METADATA_TYPE_FILELISTS)) {
+        ext_types.push_back(RepodataType::FILELISTS);
+    }
+    if (all_metadata || optional_metadata.contains(libdnf5::METADATA_TYPE_OTHER)) {
+        ext_types.push_back(RepodataType::OTHER);
+    }
+    if (all_metadata || optional_metadata.contains(libdnf5::METADATA_TYPE_PRESTO)) {
+        ext_types.push_back(RepodataType::PRESTO);
+    }
+    if (all_metadata || optional_metadata.contains(libdnf5::METADATA_TYPE_UPDATEINFO)) {
+        ext_types.push_back(RepodataType::UPDATEINFO);
+    }
+
+    SolvRepo::build_cache(p_impl->base, p_impl->config, *p_impl->downloader, ext_types);
+}
+
 void Repo::add_libsolv_testcase(const std::string & path) {
     make_solv_repo();
 
@@ -672,6 +697,25 @@ bool Repo::is_loaded() const {
     return p_impl->solv_repo.get();
 }
 
+bool Repo::is_loaded_data_current() const {
+    if (!is_loaded()) {
+        return true;
+    }
+    switch (p_impl->type) {
+        case Type::AVAILABLE:
+            try {
+                return !is_expired() && p_impl->solv_repo->is_repomd_current(p_impl->downloader->repomd_filename);
+            } catch (const std::exception &) {
+                return false;
+            }
+        case Type::SYSTEM:
+            return p_impl->solv_repo->is_rpmdb_current();
+        case Type::COMMANDLINE:
+            break;
+    }
+    return true;
+}
+
 SolvRepo & Repo::get_solv_repo() const {
     libdnf_user_assert(p_impl->solv_repo, "repo must be loaded to acess solv_repo");
     return *p_impl->solv_repo;
@@ -30,6 +30,7 @@
 #include "conf/config.h"
 #include "repo_cache_private.hpp"
 #include "repo_sack_private.hpp"
+#include "rpm/package_sack_impl.hpp"
 #include "solv/pool.hpp"
 #include "solv/solver.hpp"
 #include "solv_repo.hpp"
@@ -56,6 +57,7 @@ extern "C" {
 #include <solv/testcase.h>
 }
 
+#include <algorithm>
 #include <atomic>
 #include <condition_variable>
 #include <filesystem>
@@ -119,7 +121,10 @@ public:
     /// potentially downloads fresh metadata (by calling the
     /// `download_metadata()` method) and then queues them for loading. This
     /// speeds up the process by loading repos into memory while others are being
-    /// downloaded.
+    /// downloaded. Queued repos without a valid solv cache are first parsed
+    /// concurrently by a group of cache builder threads (calling their
+    /// `build_solv_cache()` method), the loading thread then only reads
+    /// the written cache files.
     ///
     /// @param repos The repositories to update and load
     /// @param import_keys If true, attempts to download and import keys for repositories that failed key validation
@@ -396,20 +401,62 @@ void RepoSack::Impl::update_and_load_repos(libdnf5::repo::RepoQuery & repos, boo
                                                      // a default-constructed std::exception_ptr is a null pointer
 
     std::vector<Repo *> prepared_repos;            // array of repositories prepared to load into solv sack
-    std::mutex prepared_repos_mutex;               // mutex for the array
-    std::condition_variable signal_prepared_repo;  // signals that next item is added into array
+    std::vector<bool> solv_cache_built;            // true for items of `prepared_repos` processed by cache builders
+    std::mutex prepared_repos_mutex;               // mutex for the arrays
+    std::condition_variable signal_prepared_repo;  // signals that next item is added or its cache was built
     std::size_t num_repos_loaded{0};               // number of repositories already loaded into solv sack
+    std::size_t num_repos_taken_by_builders{0};    // number of repositories taken by the cache builder threads
 
     prepared_repos.reserve(repos.size() + 1);  // optimization: preallocate memory to avoid realocations, +1 stop tag
+    solv_cache_built.reserve(repos.size() + 1);
+
+    // These threads parse metadata of prepared repositories concurrently, each into its own staging pool,
+    // and write the solv cache files. The libsolv pool is not thread-safe, so merging the repositories
+    // into the shared pool (loading the written cache files) is left to the single thread_sack_loader.
+    const auto num_cache_builders =
+        std::max<std::size_t>(1, std::min<std::size_t>(std::thread::hardware_concurrency(), repos.size()));
+    std::vector<std::thread> threads_cache_builder;
+    threads_cache_builder.reserve(num_cache_builders);
+    for (std::size_t i = 0; i < num_cache_builders; ++i) {
+        threads_cache_builder.emplace_back([&]() {
+            while (true) {
+                std::unique_lock<std::mutex> lock(prepared_repos_mutex);
+                signal_prepared_repo.wait(lock, [&]() { return prepared_repos.size() > num_repos_taken_by_builders; });
+                const auto idx = num_repos_taken_by_builders;
+                auto repo = prepared_repos[idx];
+                if (!repo) {
+                    break;  // nullptr mark - work is done, the mark is left in place for the other builders
+                }
+                ++num_repos_taken_by_builders;
+                lock.unlock();
 
-    // This thread loads prepared repositories into solvable sack
+                if (!except_in_main_thread) {
+                    try {
+                        repo->build_solv_cache();
+                    } catch (const std::exception & ex) {
+                        // Not fatal. The repository is parsed directly into the shared pool by thread_sack_loader
+                        // which also reports the error if the problem persists.
+                        logger->debug("Cannot build solv cache for repo \"{}\": {}", repo->get_id(), ex.what());
+                    }
+                }
+
+                lock.lock();
+                solv_cache_built[idx] = true;
+                lock.unlock();
+                signal_prepared_repo.notify_all();
+            }
+        });
+    }
+
+    // This thread loads prepared repositories into solvable sack in the order in which they were prepared
     std::thread thread_sack_loader([&]() {
         try {
             while (true) {
                 std::unique_lock<std::mutex> lock(prepared_repos_mutex);
-                while (prepared_repos.size() <= num_repos_loaded) {
-                    signal_prepared_repo.wait(lock);
-                }
+                signal_prepared_repo.wait(lock, [&]() {
+                    return prepared_repos.size() > num_repos_loaded &&
+                           (!prepared_repos[num_repos_loaded] || solv_cache_built[num_repos_loaded]);
+                });
                 auto repo = prepared_repos[num_repos_loaded];
                 lock.unlock();
 
@@ -418,6 +465,8 @@ void RepoSack::Impl::update_and_load_repos(libdnf5::repo::RepoQuery & repos, boo
                 }
 
                 repo->load();
+
+                lock.lock();
                 ++num_repos_loaded;
             }
         } catch (std::runtime_error & ex) {
@@ -431,25 +480,38 @@ void RepoSack::Impl::update_and_load_repos(libdnf5::repo::RepoQuery & repos, boo
         {
             std::lock_guard<std::mutex> lock(prepared_repos_mutex);
             prepared_repos.push_back(repo);
+            solv_cache_built.push_back(false);
         }
-        signal_prepared_repo.notify_one();
+        signal_prepared_repo.notify_all();
     };
 
-    // Adds information that all repos are updated (nullptr tag) and is waiting for thread_sack_loader to complete.
+    // Adds information that all repos are updated (nullptr tag) and is waiting for thread_sack_loader
+    // and the cache builder threads to complete.
+    bool sack_loader_finished{false};
     auto finish_sack_loader = [&]() {
-        send_to_sack_loader(nullptr);
-        thread_sack_loader.join();  // waits for the thread_sack_loader to finish its execution
+        if (!sack_loader_finished) {
+            sack_loader_finished = true;
+            send_to_sack_loader(nullptr);
+        }
+        if (thread_sack_loader.joinable()) {
+            thread_sack_loader.join();  // waits for the thread_sack_loader to finish its execution
+        }
+        for (auto & thread : threads_cache_builder) {
+            if (thread.joinable()) {
+                thread.join();
+            }
+        }
     };
 
     // Ensures that when update_and_load_repos is unexpectedly exited due to an exception,
-    // the thread_sack_loader is properly terminated and joined.
+    // the thread_sack_loader and the cache builder threads are properly terminated and joined.
     utils::OnScopeExit finish_sack_loader_on_exit([&]() noexcept {
         try {
-            if (thread_sack_loader.joinable()) {
-                // thread_sack_loader not yet joined -> update_and_load_repos exits due to exception
+            if (!sack_loader_finished) {
+                // threads not yet finished -> update_and_load_repos exits due to exception
                 except_in_main_thread = true;
-                finish_sack_loader();
             }
+            finish_sack_loader();
         } catch (...) {
         }
     });
@@ -900,6 +962,22 @@ void RepoSack::enable_debug_repos() {
     }
 }
 
+void RepoSack::build_solv_caches() {
+    // Computing the provides adds the file provides to the repositories and rewrites their caches. Once the provides
+    // are ready, the caches of all the loaded repositories already contain them and there is nothing to rewrite.
+    p_impl->base->get_rpm_package_sack()->p_impl->make_provides_ready();
+}
+
+bool RepoSack::is_loaded_data_current() const {
+    auto rq = RepoQuery(p_impl->base);
+    for (const auto & repo : rq.get_data()) {
+        if (!repo->is_loaded_data_current()) {
+            return false;
+        }
+    }
+    return !p_impl->system_repo || p_impl->system_repo->is_loaded_data_current();
+}
+
 void RepoSack::internalize_repos() {
     auto rq = RepoQuery(p_impl->base);
     for (auto & repo : rq.get_data()) {
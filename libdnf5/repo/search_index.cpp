@@ -0,0 +1,278 @@
+// Copyright Contributors to the DNF5 project.
+// Copyright Contributors to the libdnf project.
+// SPDX-License-Identifier: LGPL-2.1-or-later
+//
+// This file is part of libdnf: https://github.com/rpm-software-management/libdnf/
+//
+// Libdnf is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 2.1 of the License, or
+// (at your option) any later version.
+//
+// Libdnf is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
+
+#include "search_index.hpp"
+
+#include "libdnf5/utils/fs/temp.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+
+
+namespace libdnf5::repo {
+
+namespace {
+
+constexpr std::array<char, 8> SEARCH_INDEX_MAGIC{'\0', 'd', 'n', 'f', 's', 'i', 'd', 'x'};
+constexpr std::uint32_t SEARCH_INDEX_VERSION = 1;
+constexpr std::size_t TRIGRAM_SIZE = 3;
+
+// The file starts with the header followed by `trigrams_count` entries sorted by the trigram
+// and by the postings of all trigrams. The file is only read on the machine that wrote it,
+// integers are stored in the native byte order.
+struct Header {
+    char magic[SEARCH_INDEX_MAGIC.size()];
+    std::uint32_t version;
+    std::uint32_t packages_count;
+    std::uint32_t trigrams_count;
+    std::uint32_t reserved;
+    unsigned char checksum[SEARCH_INDEX_CHECKSUM_BYTES];
+};
+
+inline unsigned char fold_case(char c) noexcept {
+    auto uc = static_cast<unsigned char>(c);
+    return uc >= 'A' && uc <= 'Z' ? static_cast<unsigned char>(uc - 'A' + 'a') : uc;
+}
+
+// Calls `callback` for each case folded trigram of `text`.
+template <typename Callback>
+void for_each_trigram(std::string_view text, Callback callback) {
+    if (text.size() < TRIGRAM_SIZE) {
+        return;
+    }
+    std::uint32_t trigram = (std::uint32_t{fold_case(text[0])} << 8) | fold_case(text[1]);
+    for (std::size_t i = TRIGRAM_SIZE - 1; i < text.size(); ++i) {
+        trigram = ((trigram << 8) | fold_case(text[i])) & 0xFFFFFF;
+        callback(trigram);
+    }
+}
+
+void append_varint(std::string & data, std::uint32_t value) {
+    while (value >= 0x80) {
+        data.push_back(static_cast<char>((value & 0x7F) | 0x80));
+        value >>= 7;
+    }
+    data.push_back(static_cast<char>(value));
+}
+
+// Decodes the ranks in postings `data`, calls `callback` for each of them.
+// Returns `false` if the data are malformed.
+template <typename Callback>
+bool decode_postings(const unsigned char * data, std::size_t size, Callback callback) {
+    std::uint32_t next_rank = 0;
+    std::uint32_t value = 0;
+    unsigned shift = 0;
+    for (std::size_t i = 0; i < size; ++i) {
+        if (shift > 28) {
+            return false;
+        }
+        value |= std::uint32_t{data[i] & 0x7Fu} << shift;
+        if ((data[i] & 0x80) != 0) {
+            shift += 7;
+            continue;
+        }
+        std::uint32_t rank = next_rank + value;
+        callback(rank);
+        next_rank = rank + 1;
+        value = 0;
+        shift = 0;
+    }
+    return shift == 0;
+}
+
+}  // namespace
+
+
+struct SearchIndex::Entry {
+    std::uint32_t trigram;
+    std::uint32_t postings_offset;
+    std::uint32_t postings_size;
+};
+
+
+void SearchIndexBuilder::add(std::uint32_t rank, std::string_view text) {
+    for_each_trigram(text, [this, rank](std::uint32_t trigram) {
+        auto & postings = trigrams[trigram];
+        if (postings.next_rank > rank) {
+            // the package already has this trigram
+            return;
+        }
+        append_varint(postings.data, rank - postings.next_rank);
+        postings.next_rank = rank + 1;
+    });
+}
+
+
+void SearchIndexBuilder::write(
+    const std::filesystem::path & path, const unsigned char * checksum, std::uint32_t packages_count) const {
+    std::vector<std::uint32_t> sorted_trigrams;
+    sorted_trigrams.reserve(trigrams.size());
+    for (const auto & [trigram, postings] : trigrams) {
+        sorted_trigrams.push_back(trigram);
+    }
+    std::sort(sorted_trigrams.begin(), sorted_trigrams.end());
+
+    Header header{};
+    memcpy(header.magic, SEARCH_INDEX_MAGIC.data(), SEARCH_INDEX_MAGIC.size());
+    header.version = SEARCH_INDEX_VERSION;
+    header.packages_count = packages_count;
+    header.trigrams_count = static_cast<std::uint32_t>(sorted_trigrams.size());
+    memcpy(header.checksum, checksum, SEARCH_INDEX_CHECKSUM_BYTES);
+
+    std::vector<SearchIndex::Entry> entries;
+    entries.reserve(sorted_trigrams.size());
+    std::uint32_t postings_offset = 0;
+    for (auto trigram : sorted_trigrams) {
+        auto postings_size = static_cast<std::uint32_t>(trigrams.at(trigram).data.size());
+        entries.push_back({trigram, postings_offset, postings_size});
+        postings_offset += postings_size;
+    }
+
+    auto tmp_file = utils::fs::TempFile(path.parent_path(), path.filename());
+    auto & file = tmp_file.open_as_file("w");
+    file.write(&header, sizeof(header));
+    file.write(entries.data(), entries.size() * sizeof(SearchIndex::Entry));
+    for (auto trigram : sorted_trigrams) {
+        file.write(trigrams.at(trigram).data);
+    }
+    tmp_file.close();
+
+    std::filesystem::permissions(
+        tmp_file.get_path(),
+        std::filesystem::perms::group_read | std::filesystem::perms::others_read,
+        std::filesystem::perm_options::add);
+    std::filesystem::rename(tmp_file.get_path(), path);
+    tmp_file.release();
+}
+
+
+SearchIndex::SearchIndex(const std::filesystem::path & path) : file(path) {
+    if (file.size() < sizeof(Header)) {
+        return;
+    }
+    Header header;
+    memcpy(&header, file.data(), sizeof(header));
+    std::size_t entries_size = std::size_t{header.trigrams_count} * sizeof(Entry);
+    if (file.size() - sizeof(Header) < entries_size) {
+        return;
+    }
+    // the mapping is page aligned and the header size is a multiple of the entry alignment
+    static_assert(sizeof(Header) % alignof(Entry) == 0);
+    entries = reinterpret_cast<const Entry *>(file.data() + sizeof(Header));
+    entries_count = header.trigrams_count;
+    postings = file.data() + sizeof(Header) + entries_size;
+    postings_size = file.size() - sizeof(Header) - entries_size;
+}
+
+
+bool SearchIndex::is_valid(const unsigned char * checksum, std::uint32_t packages_count) const noexcept {
+    if (!postings) {
+        return false;
+    }
+    Header header;
+    memcpy(&header, file.data(), sizeof(header));
+    if (memcmp(header.magic, SEARCH_INDEX_MAGIC.data(), SEARCH_INDEX_MAGIC.size()) != 0 ||
+        header.version != SEARCH_INDEX_VERSION || header.packages_count != packages_count ||
+        memcmp(header.checksum, checksum, SEARCH_INDEX_CHECKSUM_BYTES) != 0) {
+        return false;
+    }
+    if (entries_count > 0) {
+        const auto & last = entries[entries_count - 1];
+        if (std::size_t{last.postings_offset} + last.postings_size != postings_size) {
+            return false;
+        }
+    }
+    return true;
+}
+
+
+const SearchIndex::Entry * SearchIndex::find_entry(std::uint32_t trigram) const noexcept {
+    const auto * end = entries + entries_count;
+    const auto * it = std::lower_bound(
+        entries, end, trigram, [](const Entry & entry, std::uint32_t value) { return entry.trigram < value; });
+    return it != end && it->trigram == trigram ? it : nullptr;
+}
+
+
+std::optional<std::vector<std::uint32_t>> SearchIndex::find_candidates(std::string_view substring) const {
+    if (substring.size() < TRIGRAM_SIZE) {
+        return std::nullopt;
+    }
+
+    std::vector<const Entry *> substring_entries;
+    bool missing_trigram = false;
+    for_each_trigram(substring, [&](std::uint32_t trigram) {
+        const auto * entry = find_entry(trigram);
+        if (!entry) {
+            missing_trigram = true;
+        } else if (std::find(substring_entries.begin(), substring_entries.end(), entry) == substring_entries.end()) {
+            substring_entries.push_back(entry);
+        }
+    });
+
+    std::vector<std::uint32_t> candidates;
+    if (missing_trigram) {
+        return candidates;
+    }
+
+    // Start with the shortest postings, it is the most selective trigram
+    std::sort(substring_entries.begin(), substring_entries.end(), [](const Entry * first, const Entry * second) {
+        return first->postings_size < second->postings_size;
+    });
+
+    std::vector<std::uint32_t> intersection;
+    for (const auto * entry : substring_entries) {
+        if (std::size_t{entry->postings_offset} + entry->postings_size > postings_size) {
+            return std::nullopt;
+        }
+        const auto * entry_postings = postings + entry->postings_offset;
+
+        if (entry == substring_entries.front()) {
+            if (!decode_postings(entry_postings, entry->postings_size, [&candidates](std::uint32_t rank) {
+                    candidates.push_back(rank);
+                })) {
+                return std::nullopt;
+            }
+            continue;
+        }
+
+        intersection.clear();
+        auto candidate_it = candidates.cbegin();
+        bool postings_valid = decode_postings(entry_postings, entry->postings_size, [&](std::uint32_t rank) {
+            while (candidate_it != candidates.cend() && *candidate_it < rank) {
+                ++candidate_it;
+            }
+            if (candidate_it != candidates.cend() && *candidate_it == rank) {
+                intersection.push_back(rank);
+            }
+        });
+        if (!postings_valid) {
+            return std::nullopt;
+        }
+        candidates.swap(intersection);
+        if (candidates.empty()) {
+            break;
+        }
+    }
+
+    return candidates;
+}
+
+}  // namespace libdnf5::repo
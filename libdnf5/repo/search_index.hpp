@@ -0,0 +1,101 @@
+// Copyright Contributors to the DNF5 project.
+// Copyright Contributors to the libdnf project.
+// SPDX-License-Identifier: LGPL-2.1-or-later
+//
+// This file is part of libdnf: https://github.com/rpm-software-management/libdnf/
+//
+// Libdnf is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 2.1 of the License, or
+// (at your option) any later version.
+//
+// Libdnf is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
+
+#ifndef LIBDNF5_REPO_SEARCH_INDEX_HPP
+#define LIBDNF5_REPO_SEARCH_INDEX_HPP
+
+#include "utils/fs/mapped_file.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+
+namespace libdnf5::repo {
+
+/// Size of the repository metadata checksum stored in the search index.
+constexpr std::size_t SEARCH_INDEX_CHECKSUM_BYTES = 32;
+
+/// Collects trigrams of strings of the packages of a repository and writes them to a search index file.
+///
+/// Packages are identified by their rank, the position among the indexed packages of the repository.
+/// Trigrams are case insensitive (ASCII letters are folded to lower case).
+class SearchIndexBuilder {
+public:
+    /// Adds trigrams of `text` to the package with `rank`.
+    /// The packages must be added in ascending order of their ranks.
+    void add(std::uint32_t rank, std::string_view text);
+
+    /// Writes the index of `packages_count` packages to `path`, the file is replaced atomically.
+    /// @param checksum  Checksum of the repository metadata the index was built from,
+    ///                  `SEARCH_INDEX_CHECKSUM_BYTES` long.
+    void write(
+        const std::filesystem::path & path, const unsigned char * checksum, std::uint32_t packages_count) const;
+
+private:
+    struct Postings {
+        // Rank of the last added package plus one, 0 when no package was added yet
+        std::uint32_t next_rank{0};
+        // Ranks of the packages encoded as varint deltas
+        std::string data;
+    };
+
+    std::unordered_map<std::uint32_t, Postings> trigrams;
+};
+
+
+/// A read-only search index of a repository mapped from a file written by `SearchIndexBuilder`.
+class SearchIndex {
+public:
+    /// Maps the index file at `path`.
+    /// @throws libdnf5::FileSystemError if the file cannot be opened or mapped.
+    explicit SearchIndex(const std::filesystem::path & path);
+
+    /// @return `true` if the index is well formed and was built for `packages_count` packages from
+    ///         the repository metadata with `checksum`.
+    bool is_valid(const unsigned char * checksum, std::uint32_t packages_count) const noexcept;
+
+    /// Finds the packages whose indexed strings may contain `substring` ignoring case.
+    /// The caller still has to verify the returned packages, the index only rules out the others.
+    /// @return Sorted ranks of the candidate packages, or `std::nullopt` if the index cannot narrow
+    ///         the search (the substring is shorter than a trigram).
+    std::optional<std::vector<std::uint32_t>> find_candidates(std::string_view substring) const;
+
+private:
+    friend class SearchIndexBuilder;
+
+    struct Entry;
+
+    const Entry * find_entry(std::uint32_t trigram) const noexcept;
+
+    utils::fs::MappedFile file;
+    const Entry * entries{nullptr};
+    std::uint32_t entries_count{0};
+    const unsigned char * postings{nullptr};
+    std::size_t postings_size{0};
+};
+
+}  // namespace libdnf5::repo
+
+#endif  // LIBDNF5_REPO_SEARCH_INDEX_HPP
@@ -22,9 +22,12 @@
 #include "base/base_impl.hpp"
 #include "repo_cache_private.hpp"
 #include "repo_downloader.hpp"
+#include "rpm/transaction.hpp"
 #include "solv/pool.hpp"
+#include "utils/fs/mapped_file.hpp"
 
 #include "libdnf5/base/base.hpp"
+#include "libdnf5/repo/repo.hpp"
 #include "libdnf5/utils/bgettext/bgettext-mark-domain.h"
 #include "libdnf5/utils/fs/temp.hpp"
 #include "libdnf5/utils/to_underlying.hpp"
@@ -41,6 +44,13 @@ extern "C" {
 #include <solv/repo_write.h>
 }
 
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <exception>
+#include <unordered_map>
+#include <utility>
+
 
 namespace libdnf5::repo {
 
@@ -50,6 +60,27 @@ namespace fs = libdnf5::utils::fs;
 constexpr auto CHKSUM_TYPE = REPOKEY_TYPE_SHA256;
 constexpr const char * CHKSUM_IDENT = "H000";
 
+static_assert(CHKSUM_BYTES == SEARCH_INDEX_CHECKSUM_BYTES, "The search index stores the repomd checksum");
+
+// Keys of the strings of the main solvables indexed in the search index
+constexpr std::array<Id, 3> SEARCH_INDEX_KEYS{SOLVABLE_SUMMARY, SOLVABLE_DESCRIPTION, SOLVABLE_URL};
+
+// Repository metadata keys of the main .solv cache which are replaced when the cache is updated incrementally
+constexpr std::array<Id, 8> MAIN_CACHE_META_KEYS{
+    REPOSITORY_TIMESTAMP,
+    REPOSITORY_EXPIRE,
+    REPOSITORY_REVISION,
+    REPOSITORY_UPDATES,
+    REPOSITORY_DISTROS,
+    REPOSITORY_KEYWORDS,
+    REPOSITORY_REPOMD,
+    REPOSITORY_ADDEDFILEPROVIDES};
+
+// The main cache is rebuilt from scratch if more than this percentage of packages was added or removed
+constexpr std::size_t MAIN_CACHE_UPDATE_MAX_CHANGED_PERCENT = 25;
+
+constexpr std::size_t PRIMARY_READ_CHUNK_SIZE = 1 << 16;
+
 
 static std::array<char, SOLV_USERDATA_SOLV_TOOLVERSION_SIZE> get_padded_solv_toolversion() {
     std::array<char, SOLV_USERDATA_SOLV_TOOLVERSION_SIZE> padded_solv_toolversion{};
@@ -73,18 +104,24 @@ void SolvRepo::userdata_fill(SolvUserdata * userdata) {
     memcpy(userdata->checksum, checksum, CHKSUM_BYTES);
 }
 
-bool SolvRepo::can_use_solvfile_cache(solv::Pool & pool, fs::File & solvfile_cache) {
+bool SolvRepo::can_use_solvfile_cache(
+    solv::Pool & pool, const fs::MappedFile & solvfile_cache, bool check_checksum) {
     auto & logger = *base->get_logger();
 
-    if (!solvfile_cache) {
-        logger.debug(("Missing solvfile cache: \"{}\""), solvfile_cache.get_path().native());
+    if (solvfile_cache.size() == 0) {
+        logger.debug(("Empty solvfile cache: \"{}\""), solvfile_cache.get_path().native());
         return false;
     }
 
-    unsigned char * dnf_solv_userdata_read;
-    int dnf_solv_userdata_len_read;
+    unsigned char * dnf_solv_userdata_read{nullptr};
+    int dnf_solv_userdata_len_read{0};
 
-    int ret_code = solv_read_userdata(solvfile_cache.get(), &dnf_solv_userdata_read, &dnf_solv_userdata_len_read);
+    // The userdata are parsed directly from the mapped header, the file is not read through a stream.
+    int ret_code = -1;
+    if (auto * header = fmemopen(const_cast<unsigned char *>(solvfile_cache.data()), solvfile_cache.size(), "r")) {
+        ret_code = solv_read_userdata(header, &dnf_solv_userdata_read, &dnf_solv_userdata_len_read);
+        fclose(header);
+    }
     if (ret_code != 0) {
         logger.warning(
             ("Failed to read solv userdata: \"{}\": for: {}"), pool_errstr(*pool), solvfile_cache.get_path().native());
@@ -136,7 +173,7 @@ bool SolvRepo::can_use_solvfile_cache(solv::Pool & pool, fs::File & solvfile_cac
     }
 
     // check solvfile checksum
-    if (memcmp(solv_userdata->checksum, checksum, CHKSUM_BYTES) != 0) {
+    if (check_checksum && memcmp(solv_userdata->checksum, checksum, CHKSUM_BYTES) != 0) {
         logger.debug(
             "Solvfile's repomd checksum doesn't match, read: \"{}\" vs. expected repomd checksum: \"{}\" for: {}",
             pool_bin2hex(*pool, solv_userdata->checksum, sizeof solv_userdata->checksum),
@@ -145,29 +182,30 @@ bool SolvRepo::can_use_solvfile_cache(solv::Pool & pool, fs::File & solvfile_cac
         return false;
     }
 
-    solvfile_cache.rewind();
     return true;
 }
 
 
-// Computes checksum of data in opened file.
-// Calls rewind(fp) before returning.
-void checksum_calc(unsigned char * out, fs::File & file) {
+// Computes checksum of `size` bytes of `data`.
+static void checksum_calc(unsigned char * out, const unsigned char * data, std::size_t size) {
     // based on calc_checksum_fp in libsolv's solv.c
-    char buf[4096];
     auto h = solv_chksum_create(CHKSUM_TYPE);
-    int l;
 
-    file.rewind();
     solv_chksum_add(h, CHKSUM_IDENT, strlen(CHKSUM_IDENT));
-    while ((l = static_cast<int>(file.read(buf, sizeof(buf)))) > 0) {
-        solv_chksum_add(h, buf, l);
+    if (size > 0) {
+        solv_chksum_add(h, data, static_cast<int>(size));
     }
-    file.rewind();
     solv_chksum_free(h, out);
 }
 
 
+// Computes checksum of data in the file at `path`.
+void checksum_calc(unsigned char * out, const std::filesystem::path & path) {
+    fs::MappedFile file(path);
+    checksum_calc(out, file.data(), file.size());
+}
+
+
 static const char * repodata_type_to_name(RepodataType type) {
     switch (type) {
         case RepodataType::FILELISTS:
@@ -226,6 +264,7 @@ bool is_one_piece(::Repo * repo) {
 SolvRepo::SolvRepo(const libdnf5::BaseWeakPtr & base, const ConfigRepo & config, void * appdata)
     : base(base),
       config(config),
+      rpm_pool(get_rpm_pool(base)),
       repo(repo_create(*get_rpm_pool(base), config.get_id().c_str())),
       comps_repo(repo_create(*get_comps_pool(base), config.get_id().c_str())) {
     repo->appdata = appdata;
@@ -233,32 +272,50 @@ SolvRepo::SolvRepo(const libdnf5::BaseWeakPtr & base, const ConfigRepo & config,
 }
 
 
+SolvRepo::SolvRepo(const libdnf5::BaseWeakPtr & base, const ConfigRepo & config, solv::Pool & staging_pool)
+    : base(base),
+      config(config),
+      rpm_pool(staging_pool),
+      staging(true),
+      repo(repo_create(*staging_pool, config.get_id().c_str())) {}
+
+
 SolvRepo::~SolvRepo() {
     repo->appdata = nullptr;
-    comps_repo->appdata = nullptr;
+    if (comps_repo) {
+        comps_repo->appdata = nullptr;
+    }
 }
 
 
 void SolvRepo::load_repo_main(const std::string & repomd_fn, const std::string & primary_fn) {
     auto & logger = *base->get_logger();
-    auto & pool = get_rpm_pool(base);
-
-    fs::File repomd_file(repomd_fn, "r");
+    auto & pool = rpm_pool;
 
-    checksum_calc(checksum, repomd_file);
+    checksum_calc(checksum, repomd_fn);
 
     int solvables_start = pool->nsolvables;
     int repodata_start = repo->nrepodata;
 
-    if (load_solv_cache(pool, nullptr, 0)) {
+    bool cache_loaded = load_solv_cache(pool, nullptr, 0);
+    if (!cache_loaded && config.get_build_cache_option().get_value() && update_main_cache(repomd_fn, primary_fn)) {
+        cache_loaded = load_solv_cache(pool, nullptr, 0);
+    }
+
+    if (cache_loaded) {
         main_solvables_start = solvables_start;
         main_solvables_end = pool->nsolvables;
         main_repodata_start = repodata_start;
         main_repodata_end = repo->nrepodata;
 
+        if (config.get_build_search_index_option().get_value()) {
+            load_search_index();
+        }
+
         return;
     }
 
+    fs::File repomd_file(repomd_fn, "r");
     fs::File primary_file(primary_fn, "r", true);
 
     logger.debug("Loading repomd and primary for repo \"{}\"", config.get_id());
@@ -284,8 +341,57 @@ void SolvRepo::load_repo_main(const std::string & repomd_fn, const std::string &
     main_repodata_end = repo->nrepodata;
 
     if (config.get_build_cache_option().get_value()) {
-        write_main(true);
+        // the staging repo is thrown away right after writing, there is no point in re-loading it
+        write_main(!staging);
+    }
+
+    if (config.get_build_search_index_option().get_value()) {
+        load_search_index();
+    }
+}
+
+
+void SolvRepo::build_cache(
+    const libdnf5::BaseWeakPtr & base,
+    const ConfigRepo & config,
+    const DownloadData & download_data,
+    const std::vector<RepodataType> & ext_types) {
+    if (!config.get_build_cache_option().get_value()) {
+        return;
+    }
+
+    auto primary_fn = download_data.get_metadata_path(RepoDownloader::MD_FILENAME_PRIMARY);
+    if (primary_fn.empty()) {
+        return;
+    }
+
+    solv::Pool staging_pool;
+    SolvRepo staging_repo(base, config, staging_pool);
+
+    checksum_calc(staging_repo.checksum, download_data.repomd_filename);
+
+    bool cache_valid = staging_repo.is_solv_cache_valid(nullptr);
+    for (auto type : ext_types) {
+        if (!cache_valid) {
+            break;
+        }
+        const char * type_name = repodata_type_to_name(type);
+        if (!download_data.get_metadata_path(type_name).empty()) {
+            cache_valid = staging_repo.is_solv_cache_valid(type_name);
+        }
+    }
+    if (cache_valid) {
+        return;
+    }
+
+    base->get_logger()->debug("Building solv cache for repo \"{}\" in a staging pool", config.get_id());
+
+    staging_repo.load_repo_main(download_data.repomd_filename, primary_fn);
+    for (auto type : ext_types) {
+        staging_repo.load_repo_ext(type, download_data);
     }
+    // the caller loads the cache files right after they are built
+    staging_repo.wait_for_cache_writes();
 }
 
 
@@ -331,8 +437,7 @@ void SolvRepo::load_repo_ext(RepodataType type, const DownloadData & download_da
 
 void SolvRepo::load_repo_ext(RepodataType type, const std::string & in_type_name, const DownloadData & download_data) {
     auto & logger = *base->get_logger();
-    solv::Pool & pool = type == RepodataType::COMPS ? static_cast<solv::Pool &>(get_comps_pool(base))
-                                                    : static_cast<solv::Pool &>(get_rpm_pool(base));
+    solv::Pool & pool = type == RepodataType::COMPS ? static_cast<solv::Pool &>(get_comps_pool(base)) : rpm_pool;
 
     std::string type_name = in_type_name.empty() ? repodata_type_to_name(type) : in_type_name;
 
@@ -354,6 +459,10 @@ void SolvRepo::load_repo_ext(RepodataType type, const std::string & in_type_name
 
     int solvables_start = pool->nsolvables;
 
+    if (type == RepodataType::FILELISTS && !staging && add_filelists_stub(type_name)) {
+        return;
+    }
+
     if (load_solv_cache(pool, type_name.c_str(), repodata_type_to_flags(type))) {
         if (type == RepodataType::UPDATEINFO) {
             updateinfo_solvables_start = solvables_start;
@@ -396,7 +505,7 @@ void SolvRepo::load_repo_ext(RepodataType type, const std::string & in_type_name
             type_name,
             config.get_id(),
             ext_fn,
-            std::string(pool_errstr(*get_rpm_pool(base))));
+            std::string(pool_errstr(*rpm_pool)));
     }
 
     if (config.get_build_cache_option().get_value()) {
@@ -424,13 +533,48 @@ void SolvRepo::load_system_repo(const std::string & rootdir) {
     int solvables_start = pool->nsolvables;
     int repodata_start = repo->nrepodata;
 
-    // TODO(egoode) investigate performance hit of RPM_ADD_WITH_CHANGELOG, possibly make this configurable
-    int flagsrpm = REPO_REUSE_REPODATA | RPM_ADD_WITH_HDRID | REPO_USE_ROOTDIR | RPM_ADD_WITH_CHANGELOG;
-    if (repo_add_rpmdb(repo, nullptr, flagsrpm) != 0) {
-        throw SolvError(
-            M_("Failed to load system repo from root \"{}\": {}"),
-            real_rootdir,
-            std::string(pool_errstr(*get_rpm_pool(base))));
+    // The solv cache is used only for the rpmdb in the installroot, it is valid as long as the rpmdb cookie
+    // does not change. The cookie is read before the rpmdb, a cache written while the rpmdb is being changed
+    // is thus outdated already in the next run.
+    // The cookie is remembered also without the cache, it tells whether the loaded packages are still current.
+    bool use_cache = false;
+    if (rootdir.empty()) {
+        try {
+            loaded_rpmdb_cookie = rpm::Transaction(base).get_db_cookie();
+            use_cache = config.get_build_cache_option().get_value() && !loaded_rpmdb_cookie.empty();
+        } catch (const std::exception & e) {
+            logger.debug("Cannot get rpmdb cookie, system repo solv cache is not used: {}", e.what());
+            loaded_rpmdb_cookie.clear();
+        }
+    }
+    if (use_cache) {
+        checksum_calc(
+            checksum,
+            reinterpret_cast<const unsigned char *>(loaded_rpmdb_cookie.data()),
+            loaded_rpmdb_cookie.size());
+    }
+
+    bool loaded_from_cache = use_cache && load_solv_cache(pool, nullptr, 0);
+    if (!loaded_from_cache) {
+        // Changelogs are not loaded, rpm::Package::get_changelogs() reads them from the rpmdb on demand
+        int flagsrpm = REPO_REUSE_REPODATA | RPM_ADD_WITH_HDRID | REPO_USE_ROOTDIR;
+
+        // An outdated cache is used as a reference, only the headers added since it was written are read from
+        // the rpmdb, the packages with unchanged header ids are copied from the cache.
+        fs::File reference_file;
+        if (use_cache) {
+            try {
+                reference_file.open(solv_file_path(), "r");
+            } catch (const FileSystemError &) {
+            }
+        }
+
+        if (repo_add_rpmdb_reffp(repo, reference_file ? reference_file.get() : nullptr, flagsrpm) != 0) {
+            throw SolvError(
+                M_("Failed to load system repo from root \"{}\": {}"),
+                real_rootdir,
+                std::string(pool_errstr(*get_rpm_pool(base))));
+        }
     }
 
     if (!rootdir.empty()) {
@@ -444,6 +588,38 @@ void SolvRepo::load_system_repo(const std::string & rootdir) {
     main_solvables_end = pool->nsolvables;
     main_repodata_start = repodata_start;
     main_repodata_end = repo->nrepodata;
+
+    if (use_cache && !loaded_from_cache) {
+        try {
+            std::filesystem::create_directories(solv_file_path().parent_path());
+            write_main(false);
+        } catch (const std::exception & e) {
+            logger.warning("Cannot write system repo solv cache: {}", e.what());
+        }
+    }
+}
+
+
+bool SolvRepo::is_repomd_current(const std::string & repomd_fn) const {
+    try {
+        unsigned char current_checksum[CHKSUM_BYTES];
+        checksum_calc(current_checksum, repomd_fn);
+        return memcmp(current_checksum, checksum, CHKSUM_BYTES) == 0;
+    } catch (const std::exception &) {
+        return false;
+    }
+}
+
+
+bool SolvRepo::is_rpmdb_current() const {
+    if (loaded_rpmdb_cookie.empty()) {
+        return false;
+    }
+    try {
+        return rpm::Transaction(base).get_db_cookie() == loaded_rpmdb_cookie;
+    } catch (const std::exception &) {
+        return false;
+    }
 }
 
 
@@ -504,6 +680,44 @@ void SolvRepo::internalize() {
 }
 
 
+void SolvRepo::load_data_for_concurrent_search(Id keyname) {
+    internalize();
+    int data_id;
+    Repodata * data;
+    FOR_REPODATAS(repo, data_id, data) {
+        if (repodata_has_keyname(data, keyname) != 0) {
+            repodata_disable_paging(data);
+        }
+    }
+}
+
+
+void SolvRepo::filter_search_index_candidates(std::string_view substring, solv::SolvMap & candidates) const {
+    if (!search_index) {
+        return;
+    }
+    auto index_candidates = search_index->find_candidates(substring);
+    if (!index_candidates) {
+        return;
+    }
+
+    auto candidate_it = index_candidates->cbegin();
+    std::uint32_t rank = 0;
+    const auto end = std::min(main_solvables_end, candidates.allocated_size());
+    for (Id id = main_solvables_start; id < end; ++id) {
+        if (rpm_pool.id2solvable(id)->repo != repo) {
+            continue;
+        }
+        if (candidate_it != index_candidates->cend() && *candidate_it == rank) {
+            ++candidate_it;
+        } else {
+            candidates.remove_unsafe(id);
+        }
+        ++rank;
+    }
+}
+
+
 void SolvRepo::set_priority(int priority) {
     repo->priority = priority;
 }
@@ -520,10 +734,15 @@ bool SolvRepo::load_solv_cache(solv::Pool & pool, const char * type_name, int fl
     auto path = solv_file_path(type_name);
 
     try {
-        fs::File cache_file(path, "r");
+        fs::MappedFile cache_mapping(path);
 
-        if (can_use_solvfile_cache(pool, cache_file)) {
+        if (can_use_solvfile_cache(pool, cache_mapping)) {
             logger.debug("Loading solv cache file: \"{}\"", path.native());
+            // Let the kernel read the rest of the file ahead while libsolv processes its beginning.
+            // libsolv needs a stream backed by a real file descriptor, it keeps a duplicate
+            // of it to load the paged data lazily on demand.
+            cache_mapping.will_need();
+            auto cache_file = cache_mapping.open_file();
             if (repo_add_solv(
                     type_name && std::string_view(type_name) == RepoDownloader::MD_FILENAME_GROUP ? comps_repo : repo,
                     cache_file.get(),
@@ -533,7 +752,7 @@ bool SolvRepo::load_solv_cache(solv::Pool & pool, const char * type_name, int fl
                     type_name ? std::string(type_name) : "primary",
                     config.get_id(),
                     path.native(),
-                    std::string(pool_errstr(*get_rpm_pool(base))));
+                    std::string(pool_errstr(*rpm_pool)));
             }
             return true;
         }
@@ -550,9 +769,382 @@ bool SolvRepo::load_solv_cache(solv::Pool & pool, const char * type_name, int fl
 }
 
 
+bool SolvRepo::is_solv_cache_valid(const char * type_name) {
+    try {
+        fs::MappedFile cache_mapping(solv_file_path(type_name));
+        return can_use_solvfile_cache(rpm_pool, cache_mapping);
+    } catch (const FileSystemError &) {
+        return false;
+    }
+}
+
+
+// Splits primary.xml into the text preceding the first package and the texts of the `<package>` elements
+// without parsing the XML. The file is read in chunks, only the currently processed package is kept in memory.
+// Returns false if the file doesn't look like a complete primary.xml.
+template <typename PackageCallback>
+static bool split_primary(fs::File & primary_file, std::string & header, PackageCallback package_callback) {
+    static constexpr std::string_view PACKAGE_START = "<package";
+    static constexpr std::string_view PACKAGE_END = "</package>";
+    static constexpr std::string_view METADATA_END = "</metadata>";
+
+    std::string buffer;
+    std::size_t begin = 0;
+    bool header_found = false;
+    for (;;) {
+        auto chunk = primary_file.read(PRIMARY_READ_CHUNK_SIZE);
+        buffer.append(chunk);
+
+        for (;;) {
+            auto start = buffer.find(PACKAGE_START, begin);
+            if (start == std::string::npos) {
+                break;
+            }
+            if (!header_found) {
+                header.assign(buffer, 0, start);
+                header_found = true;
+            }
+            auto end = buffer.find(PACKAGE_END, start);
+            if (end == std::string::npos) {
+                begin = start;
+                break;
+            }
+            end += PACKAGE_END.size();
+            package_callback(std::string_view(buffer).substr(start, end - start));
+            begin = end;
+        }
+
+        if (chunk.empty()) {
+            break;
+        }
+
+        if (header_found) {
+            // keep only the unprocessed text, it can end with an incomplete tag
+            buffer.erase(0, begin);
+            begin = 0;
+        }
+    }
+
+    // the rest must be the end of the metadata element, an incomplete package means a truncated file
+    auto metadata_end = buffer.find(METADATA_END, begin);
+    if (metadata_end == std::string::npos || buffer.find(PACKAGE_START, begin) != std::string::npos) {
+        return false;
+    }
+    if (!header_found) {
+        // no packages in the repository
+        header.assign(buffer, 0, metadata_end);
+    }
+    return true;
+}
+
+
+// Returns the pkgid (the checksum) of a `<package>` element text from primary.xml.
+static std::string_view get_primary_package_pkgid(std::string_view package) {
+    auto checksum_start = package.find("<checksum ");
+    if (checksum_start == std::string_view::npos) {
+        return {};
+    }
+    auto value_start = package.find('>', checksum_start);
+    if (value_start == std::string_view::npos) {
+        return {};
+    }
+    ++value_start;
+    auto value_end = package.find("</checksum>", value_start);
+    if (value_end == std::string_view::npos) {
+        return {};
+    }
+    return package.substr(value_start, value_end - value_start);
+}
+
+
+bool SolvRepo::update_main_cache(const std::string & repomd_fn, const std::string & primary_fn) {
+    auto & logger = *base->get_logger();
+
+    const auto path = solv_file_path();
+    std::unique_ptr<fs::MappedFile> stale_cache;
+    try {
+        stale_cache = std::make_unique<fs::MappedFile>(path);
+    } catch (const FileSystemError &) {
+        return false;
+    }
+    if (!can_use_solvfile_cache(rpm_pool, *stale_cache, false)) {
+        return false;
+    }
+
+    try {
+        // The packages are merged in a private pool, the result is written to the cache and loaded from it.
+        solv::Pool update_pool;
+        SolvRepo update_repo(base, config, update_pool);
+        memcpy(update_repo.checksum, checksum, CHKSUM_BYTES);
+        auto * update_solv_repo = update_repo.repo;
+
+        {
+            auto stale_cache_file = stale_cache->open_file();
+            if (repo_add_solv(update_solv_repo, stale_cache_file.get(), 0) != 0) {
+                return false;
+            }
+        }
+        // repo_add_solv() loads the cache into a single repodata appended to the repo, the first repodata
+        // of an empty repo is at index 1 (index 0 is reserved by libsolv)
+        int repodata_start = update_solv_repo->nrepodata - 1;
+        if (repodata_start <= 0) {
+            return false;
+        }
+        Repodata * data = repo_id2repodata(update_solv_repo, repodata_start);
+
+        std::unordered_map<std::string, Id> stale_packages;
+        for (Id id = update_solv_repo->start; id < update_solv_repo->end; ++id) {
+            Solvable * solvable = update_pool.id2solvable(id);
+            if (solvable->repo != update_solv_repo) {
+                continue;
+            }
+            Id type;
+            const char * pkgid = solvable_lookup_checksum(solvable, SOLVABLE_CHECKSUM, &type);
+            if (pkgid == nullptr) {
+                return false;
+            }
+            stale_packages.emplace(pkgid, id);
+        }
+        const auto stale_packages_count = static_cast<std::size_t>(update_solv_repo->nsolvables);
+
+        std::string header;
+        std::string added_packages;
+        std::size_t added_packages_count = 0;
+        std::size_t packages_count = 0;
+        bool pkgids_found = true;
+        {
+            fs::File primary_file(primary_fn, "r", true);
+            bool primary_complete = split_primary(primary_file, header, [&](std::string_view package) {
+                ++packages_count;
+                auto pkgid = get_primary_package_pkgid(package);
+                if (pkgid.empty()) {
+                    pkgids_found = false;
+                    return;
+                }
+                if (auto it = stale_packages.find(std::string(pkgid)); it != stale_packages.end()) {
+                    stale_packages.erase(it);
+                } else {
+                    added_packages.append(package);
+                    added_packages.push_back('\n');
+                    ++added_packages_count;
+                }
+            });
+            if (!primary_complete || !pkgids_found) {
+                logger.debug("Cannot split primary \"{}\" into packages", primary_fn);
+                return false;
+            }
+        }
+
+        const auto removed_packages_count = stale_packages.size();
+        const auto changed_packages_count = added_packages_count + removed_packages_count;
+        if (changed_packages_count * 100 >
+            std::max(packages_count, stale_packages_count) * MAIN_CACHE_UPDATE_MAX_CHANGED_PERCENT) {
+            logger.debug(
+                "Too many changed packages in repo \"{}\" ({} added, {} removed), rebuilding the cache",
+                config.get_id(),
+                added_packages_count,
+                removed_packages_count);
+            return false;
+        }
+
+        logger.debug(
+            "Updating primary cache for repo \"{}\": {} packages added, {} removed",
+            config.get_id(),
+            added_packages_count,
+            removed_packages_count);
+
+        for (const auto & [pkgid, id] : stale_packages) {
+            repo_free_solvable(update_solv_repo, id, 0);
+        }
+
+        // The repository metadata come from the new repomd, added file provides are computed again
+        // because the added packages don't have them
+        for (auto key : MAIN_CACHE_META_KEYS) {
+            repodata_unset(data, SOLVID_META, key);
+        }
+        repodata_internalize(data);
+
+        fs::File repomd_file(repomd_fn, "r");
+        if (repo_add_repomdxml(update_solv_repo, repomd_file.get(), 0) != 0) {
+            return false;
+        }
+
+        if (added_packages_count > 0) {
+            // the packages count in the header is only a hint, make it match the parsed packages
+            static constexpr std::string_view PACKAGES_ATTR = " packages=\"";
+            if (auto attr_start = header.find(PACKAGES_ATTR); attr_start != std::string::npos) {
+                attr_start += PACKAGES_ATTR.size();
+                auto attr_end = header.find('"', attr_start);
+                if (attr_end != std::string::npos) {
+                    header.replace(attr_start, attr_end - attr_start, std::to_string(added_packages_count));
+                }
+            }
+
+            std::string added_primary = header + added_packages + "</metadata>\n";
+            std::unique_ptr<std::FILE, decltype(&fclose)> added_primary_file(
+                fmemopen(added_primary.data(), added_primary.size(), "r"), &fclose);
+            if (!added_primary_file || repo_add_rpmmd(update_solv_repo, added_primary_file.get(), 0, 0) != 0) {
+                logger.debug(
+                    "Failed to load added packages of repo \"{}\": {}", config.get_id(), pool_errstr(*update_pool));
+                return false;
+            }
+        }
+
+        update_repo.main_solvables_start = update_solv_repo->start;
+        update_repo.main_solvables_end = update_solv_repo->end;
+        update_repo.main_repodata_start = repodata_start;
+        update_repo.main_repodata_end = update_solv_repo->nrepodata;
+        update_repo.write_main(false);
+        update_repo.wait_for_cache_writes();
+    } catch (const std::exception & e) {
+        logger.warning("Cannot update primary cache for repo \"{}\", rebuilding it: {}", config.get_id(), e.what());
+        return false;
+    }
+
+    return true;
+}
+
+
+bool SolvRepo::add_filelists_stub(const std::string & type_name) {
+    auto & logger = *base->get_logger();
+
+    std::unique_ptr<fs::MappedFile> cache;
+    try {
+        cache = std::make_unique<fs::MappedFile>(solv_file_path(type_name.c_str()));
+    } catch (const FileSystemError &) {
+        return false;
+    }
+    if (!can_use_solvfile_cache(rpm_pool, *cache)) {
+        return false;
+    }
+
+    logger.debug("Attaching {} cache file \"{}\" to be loaded on demand", type_name, cache->get_path().native());
+
+    // Describe the cache as an external repodata providing the full file lists, based on repomd_add_ext()
+    // in libsolv's solv.c
+    Repodata * data = repo_add_repodata(repo, 0);
+    Id handle = repodata_new_handle(data);
+    repodata_set_str(data, handle, REPOSITORY_REPOMD_TYPE, type_name.c_str());
+    repodata_add_idarray(data, handle, REPOSITORY_KEYS, SOLVABLE_FILELIST);
+    repodata_add_idarray(data, handle, REPOSITORY_KEYS, REPOKEY_TYPE_DIRSTRARRAY);
+    repodata_add_flexarray(data, SOLVID_META, REPOSITORY_EXTERNAL, handle);
+    repodata_internalize(data);
+    repodata_create_stubs(data);
+
+    pool_setloadcallback(*rpm_pool, &SolvRepo::load_stub_callback, nullptr);
+    filelists_stub_cache = std::move(cache);
+
+    return true;
+}
+
+
+int SolvRepo::load_stub_callback(::Pool *, Repodata * data, void *) {
+    auto * libdnf_repo = static_cast<Repo *>(data->repo->appdata);
+    if (libdnf_repo == nullptr) {
+        return 0;
+    }
+    auto & solv_repo = libdnf_repo->get_solv_repo();
+    const char * type_name = repodata_lookup_str(data, SOLVID_META, REPOSITORY_REPOMD_TYPE);
+    if (!solv_repo.filelists_stub_cache || type_name == nullptr ||
+        std::string_view(type_name) != repodata_type_to_name(RepodataType::FILELISTS)) {
+        return 0;
+    }
+
+    auto & logger = *solv_repo.base->get_logger();
+    auto cache = std::move(solv_repo.filelists_stub_cache);
+    try {
+        logger.debug("Loading solv cache file: \"{}\"", cache->get_path().native());
+        auto cache_file = cache->open_file();
+        // The stub is in the REPODATA_LOADING state, REPO_USE_LOADING makes libsolv load the data into it
+        if (repo_add_solv(
+                data->repo, cache_file.get(), repodata_type_to_flags(RepodataType::FILELISTS) | REPO_USE_LOADING) !=
+            0) {
+            logger.warning(
+                "Failed to load {} cache for repo \"{}\" from \"{}\": {}",
+                type_name,
+                solv_repo.config.get_id(),
+                cache->get_path().native(),
+                pool_errstr(*solv_repo.rpm_pool));
+            return 0;
+        }
+    } catch (const std::exception & e) {
+        logger.warning("Error loading {} cache, ignoring: {}", type_name, e.what());
+        return 0;
+    }
+
+    return 1;
+}
+
+
+// Serializes the repository data selected by the `writer` into `data`.
+static int repowriter_write_to_memory(Repowriter * writer, SerializedSolvCache & data) {
+    char * buffer = nullptr;
+    std::size_t size = 0;
+    auto * stream = open_memstream(&buffer, &size);
+    if (!stream) {
+        return -1;
+    }
+    int res = repowriter_write(writer, stream);
+    // the buffer and size are valid after the stream is closed
+    if (fclose(stream) != 0) {
+        res = -1;
+    }
+    // the buffer is handed over without copying
+    data.buffer.reset(buffer);
+    data.size = size;
+    return res;
+}
+
+
+// Writes `data` to a temporary file next to `path` and renames it to `path`.
+static void write_cache_file(const std::filesystem::path & path, const SerializedSolvCache & data) {
+    auto cache_tmp_file = fs::TempFile(path.parent_path(), path.filename());
+    cache_tmp_file.open_as_file("w").write(data.buffer.get(), data.size);
+    cache_tmp_file.close();
+
+    std::filesystem::permissions(
+        cache_tmp_file.get_path(),
+        std::filesystem::perms::group_read | std::filesystem::perms::others_read,
+        std::filesystem::perm_options::add);
+    std::filesystem::rename(cache_tmp_file.get_path(), path);
+    cache_tmp_file.release();
+}
+
+
+void SolvRepo::write_cache_file_async(std::filesystem::path path, SerializedSolvCache data) {
+    wait_for_pending_cache_write();
+    pending_cache_write = std::async(
+        std::launch::async,
+        [path = std::move(path), data = std::move(data)]() { write_cache_file(path, data); });
+}
+
+
+void SolvRepo::wait_for_pending_cache_write() {
+    if (!pending_cache_write.valid()) {
+        return;
+    }
+    try {
+        pending_cache_write.get();
+    } catch (...) {
+        if (!cache_write_error) {
+            cache_write_error = std::current_exception();
+        }
+    }
+}
+
+
+void SolvRepo::wait_for_cache_writes() {
+    // all the writes are waited for, the first error is rethrown
+    wait_for_pending_cache_write();
+    if (auto error = std::exchange(cache_write_error, nullptr)) {
+        std::rethrow_exception(error);
+    }
+}
+
+
 void SolvRepo::write_main(bool load_after_write) {
     auto & logger = *base->get_logger();
-    auto & pool = get_rpm_pool(base);
+    auto & pool = rpm_pool;
 
     const char * chksum = pool_bin2hex(*pool, checksum, solv_chksum_len(CHKSUM_TYPE));
 
@@ -561,6 +1153,36 @@ void SolvRepo::write_main(bool load_after_write) {
 
     std::filesystem::create_directory(solvfile_parent_dir);
 
+    SolvUserdata solv_userdata{};
+    userdata_fill(&solv_userdata);
+
+    std::unique_ptr<Repowriter, decltype(&repowriter_free)> writer(repowriter_create(repo), &repowriter_free);
+    repowriter_set_userdata(writer.get(), &solv_userdata, SOLV_USERDATA_SIZE);
+    repowriter_set_solvablerange(writer.get(), main_solvables_start, main_solvables_end);
+    repowriter_set_repodatarange(writer.get(), main_repodata_start, main_repodata_end);
+
+    if (staging) {
+        // The staging pool belongs to the calling thread, so the repo is serialized here. The file is written
+        // in the background while the next metadata are parsed, the staging repo is never re-loaded from it.
+        logger.trace(
+            "Writing primary cache for repo \"{}\" to \"{}\" in the background (checksum: 0x{})",
+            config.get_id(),
+            solvfile_path.native(),
+            chksum);
+
+        SerializedSolvCache data;
+        int res = repowriter_write_to_memory(writer.get(), data);
+        if (res != 0) {
+            throw SolvError(
+                M_("Failed to write primary cache for repo \"{}\" to \"{}\": {}"),
+                config.get_id(),
+                solvfile_path.native(),
+                std::string(pool_errstr(*pool)));
+        }
+        write_cache_file_async(solvfile_path, std::move(data));
+        return;
+    }
+
     auto cache_tmp_file = fs::TempFile(solvfile_parent_dir, solvfile_path.filename());
     auto & cache_file = cache_tmp_file.open_as_file("w+");
 
@@ -570,16 +1192,8 @@ void SolvRepo::write_main(bool load_after_write) {
         cache_tmp_file.get_path().native(),
         chksum);
 
-    SolvUserdata solv_userdata{};
-    userdata_fill(&solv_userdata);
-
-
-    Repowriter * writer = repowriter_create(repo);
-    repowriter_set_userdata(writer, &solv_userdata, SOLV_USERDATA_SIZE);
-    repowriter_set_solvablerange(writer, main_solvables_start, main_solvables_end);
-    repowriter_set_repodatarange(writer, main_repodata_start, main_repodata_end);
-    int res = repowriter_write(writer, cache_file.get());
-    repowriter_free(writer);
+    int res = repowriter_write(writer.get(), cache_file.get());
+    writer.reset();
 
     if (res != 0) {
         throw SolvError(
@@ -596,7 +1210,7 @@ void SolvRepo::write_main(bool load_after_write) {
         // keeps the file open and lazily loads some data on-demand.
         fs::File file(cache_tmp_file.get_path(), "r");
 
-        repo_empty(repo, 1);
+        pool.empty_repo(repo, true);
 
         // While the number of solvables (main_solvables_start/end) doesn't
         // change when we reload the repo from solv file the repodata can/do change.
@@ -627,46 +1241,62 @@ void SolvRepo::write_ext(Id repodata_id, RepodataType type, const std::string &
     libdnf_assert(repodata_id != 0, "0 is not a valid repodata id");
 
     auto & logger = *base->get_logger();
-    solv::Pool & pool = type == RepodataType::COMPS ? static_cast<solv::Pool &>(get_comps_pool(base))
-                                                    : static_cast<solv::Pool &>(get_rpm_pool(base));
+    solv::Pool & pool = type == RepodataType::COMPS ? static_cast<solv::Pool &>(get_comps_pool(base)) : rpm_pool;
 
     const auto solvfile_path = solv_file_path(type_name.c_str());
     const auto solvfile_parent_dir = solvfile_path.parent_path();
 
     std::filesystem::create_directory(solvfile_parent_dir);
 
-    auto cache_tmp_file = fs::TempFile(solvfile_parent_dir, solvfile_path.filename());
-    auto & cache_file = cache_tmp_file.open_as_file("w+");
-
-    logger.trace(
-        "Writing {} extension cache for repo \"{}\" to \"{}\"",
-        type_name,
-        config.get_id(),
-        cache_tmp_file.get_path().native());
-
-
     SolvUserdata solv_userdata{};
     userdata_fill(&solv_userdata);
 
-    Repowriter * writer;
-    if (type == RepodataType::COMPS) {
-        writer = repowriter_create(comps_repo);
-    } else {
-        writer = repowriter_create(repo);
-    }
-    repowriter_set_userdata(writer, &solv_userdata, SOLV_USERDATA_SIZE);
-    repowriter_set_repodatarange(writer, repodata_id, repodata_id + 1);
+    std::unique_ptr<Repowriter, decltype(&repowriter_free)> writer(
+        repowriter_create(type == RepodataType::COMPS ? comps_repo : repo), &repowriter_free);
+    repowriter_set_userdata(writer.get(), &solv_userdata, SOLV_USERDATA_SIZE);
+    repowriter_set_repodatarange(writer.get(), repodata_id, repodata_id + 1);
 
     if (type == RepodataType::UPDATEINFO) {
-        repowriter_set_solvablerange(writer, updateinfo_solvables_start, updateinfo_solvables_end);
+        repowriter_set_solvablerange(writer.get(), updateinfo_solvables_start, updateinfo_solvables_end);
     }
 
     if (type != RepodataType::COMPS && type != RepodataType::UPDATEINFO) {
-        repowriter_set_flags(writer, REPOWRITER_NO_STORAGE_SOLVABLE);
+        repowriter_set_flags(writer.get(), REPOWRITER_NO_STORAGE_SOLVABLE);
     }
 
-    int res = repowriter_write(writer, cache_file.get());
-    repowriter_free(writer);
+    if (staging) {
+        // Written in the background the same way as the primary cache, see `write_main()`
+        logger.trace(
+            "Writing {} extension cache for repo \"{}\" to \"{}\" in the background",
+            type_name,
+            config.get_id(),
+            solvfile_path.native());
+
+        SerializedSolvCache data;
+        int res = repowriter_write_to_memory(writer.get(), data);
+        if (res != 0) {
+            throw SolvError(
+                M_("Failed to write {} cache for repo \"{}\" to \"{}\": {}"),
+                type_name,
+                config.get_id(),
+                solvfile_path.native(),
+                std::string(pool_errstr(*pool)));
+        }
+        write_cache_file_async(solvfile_path, std::move(data));
+        return;
+    }
+
+    auto cache_tmp_file = fs::TempFile(solvfile_parent_dir, solvfile_path.filename());
+    auto & cache_file = cache_tmp_file.open_as_file("w+");
+
+    logger.trace(
+        "Writing {} extension cache for repo \"{}\" to \"{}\"",
+        type_name,
+        config.get_id(),
+        cache_tmp_file.get_path().native());
+
+    int res = repowriter_write(writer.get(), cache_file.get());
+    writer.reset();
 
     if (res != 0) {
         throw SolvError(
@@ -679,7 +1309,7 @@ void SolvRepo::write_ext(Id repodata_id, RepodataType type, const std::string &
 
     cache_tmp_file.close();
 
-    if (is_one_piece(repo) && type != RepodataType::UPDATEINFO && type != RepodataType::COMPS) {
+    if (!staging && is_one_piece(repo) && type != RepodataType::UPDATEINFO && type != RepodataType::COMPS) {
         // this saves memory, libsolv doesn't load all the data from a solv file, it dup()s the fd,
         // keeps the file open and lazily loads some data on-demand.
         fs::File file(cache_tmp_file.get_path(), "r");
@@ -722,6 +1352,57 @@ std::filesystem::path SolvRepo::solv_file_path(const char * type) {
     return std::filesystem::path(config.get_cachedir()) / CACHE_SOLV_FILES_DIR / solv_file_name(type);
 }
 
+void SolvRepo::load_search_index() {
+    auto & logger = *base->get_logger();
+    auto & pool = rpm_pool;
+
+    const auto index_path =
+        std::filesystem::path(config.get_cachedir()) / CACHE_SOLV_FILES_DIR / (config.get_id() + "-search.idx");
+
+    std::uint32_t packages_count = 0;
+    for (Id id = main_solvables_start; id < main_solvables_end; ++id) {
+        if (pool.id2solvable(id)->repo == repo) {
+            ++packages_count;
+        }
+    }
+
+    try {
+        search_index = std::make_unique<SearchIndex>(index_path);
+        if (search_index->is_valid(checksum, packages_count)) {
+            return;
+        }
+        logger.debug("Search index \"{}\" is outdated", index_path.native());
+    } catch (const FileSystemError & e) {
+        logger.trace("Cannot open search index, ignoring: {}", e.what());
+    }
+    search_index.reset();
+
+    logger.debug("Building search index for repo \"{}\"", config.get_id());
+    SearchIndexBuilder builder;
+    std::uint32_t rank = 0;
+    for (Id id = main_solvables_start; id < main_solvables_end; ++id) {
+        auto * solvable = pool.id2solvable(id);
+        if (solvable->repo != repo) {
+            continue;
+        }
+        for (auto keyname : SEARCH_INDEX_KEYS) {
+            if (const char * str = solvable_lookup_str(solvable, keyname)) {
+                builder.add(rank, str);
+            }
+        }
+        ++rank;
+    }
+
+    try {
+        std::filesystem::create_directory(index_path.parent_path());
+        builder.write(index_path, checksum, packages_count);
+        search_index = std::make_unique<SearchIndex>(index_path);
+    } catch (const std::exception & e) {
+        logger.warning("Cannot write search index for repo \"{}\": {}", config.get_id(), e.what());
+    }
+}
+
+
 bool SolvRepo::read_group_solvable_from_xml(const std::string & path) {
     auto & logger = *base->get_logger();
     bool read_success = true;
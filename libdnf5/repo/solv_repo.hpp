@@ -21,8 +21,11 @@
 #define LIBDNF5_REPO_SOLV_REPO_HPP
 
 #include "download_data.hpp"
+#include "search_index.hpp"
 #include "solv/id_queue.hpp"
 #include "solv/pool.hpp"
+#include "solv/solv_map.hpp"
+#include "utils/fs/mapped_file.hpp"
 
 #include "libdnf5/base/base_weak.hpp"
 #include "libdnf5/common/exception.hpp"
@@ -31,7 +34,13 @@
 
 #include <solv/repo.h>
 
+#include <cstdlib>
+#include <exception>
 #include <filesystem>
+#include <future>
+#include <memory>
+#include <string_view>
+#include <vector>
 
 
 static const constexpr size_t CHKSUM_BYTES = 32;
@@ -55,6 +64,13 @@ using LibsolvRepo = ::Repo;
 enum class RepodataType { FILELISTS, PRESTO, UPDATEINFO, COMPS, OTHER, APPSTREAM };
 
 
+/// Serialized solv cache file, the buffer is allocated by `open_memstream()`
+struct SerializedSolvCache {
+    std::unique_ptr<char, void (*)(void *)> buffer{nullptr, &free};
+    std::size_t size{0};
+};
+
+
 class SolvError : public Error {
     using Error::Error;
 
@@ -77,21 +93,49 @@ public:
 
     /// Loads system repository into the pool.
     ///
+    /// The installroot rpmdb is cached in a solv file validated by the rpmdb cookie ("build_cache" option).
+    /// When the cookie changes, only the rpm headers that are not in the outdated cache are read.
+    ///
     /// @param rootdir If empty, loads the installroot rpmdb, if not loads rpmdb from this root path
-    /// TODO(jrohel): Performance: Implement libsolv cache ("build_cache" argument) of system repo in future.
     void load_system_repo(const std::string & rootdir = "");
 
     /// Loads additional system repo metadata (comps, modules)
     void load_system_repo_ext(RepodataType type);
 
+    /// Parses the main metadata and the `ext_types` extended metadata of an available repo into a private
+    /// staging pool and writes the solv/solvx cache files that are missing or outdated.
+    /// The shared pools of `base` are not touched, the method can be called concurrently for different repos.
+    /// A following load of the repo into the shared pool then only reads the cache files.
+    static void build_cache(
+        const libdnf5::BaseWeakPtr & base,
+        const ConfigRepo & config,
+        const DownloadData & download_data,
+        const std::vector<RepodataType> & ext_types);
+
     void rewrite_repo(libdnf5::solv::IdQueue & fileprovides);
 
     // Internalize repository if needed.
     void internalize();
 
+    /// Internalizes the repository if needed and loads the `keyname` data of all its repodata into memory.
+    /// Dataiterators then only read the repodata (stubs are loaded and paging is disabled)
+    /// and can search the `keyname` data of the repository concurrently.
+    void load_data_for_concurrent_search(Id keyname);
+
+    /// @return `true` if the main metadata were loaded from the repomd file `repomd_fn` in its current content.
+    bool is_repomd_current(const std::string & repomd_fn) const;
+
+    /// @return `true` if the installroot rpmdb did not change since it was loaded into the system repo.
+    bool is_rpmdb_current() const;
+
     void set_priority(int priority);
     void set_subpriority(int subpriority);
 
+    /// Removes from `candidates` the main solvables whose summary, description and url cannot contain
+    /// `substring` (ignoring case) according to the search index of the repo.
+    /// Does nothing if the repo has no search index or the index cannot narrow the search.
+    void filter_search_index_candidates(std::string_view substring, solv::SolvMap & candidates) const;
+
     // Checksum of data in .solv file. Used for validity check of .solvx files.
     unsigned char checksum[CHKSUM_BYTES];
 
@@ -122,21 +166,63 @@ public:
     bool read_group_solvable_from_xml(const std::string & path);
 
 private:
+    /// Creates a repo in the `staging_pool` instead of the shared rpm pool. Comps are not supported.
+    SolvRepo(const libdnf5::BaseWeakPtr & base, const ConfigRepo & config, solv::Pool & staging_pool);
+
     // "type_name == nullptr" means load "primary" cache (.solv file)
     bool load_solv_cache(solv::Pool & pool, const char * type_name, int flags);
 
+    /// Returns true if the solv cache file exists and matches the current repomd checksum.
+    bool is_solv_cache_valid(const char * type_name);
+
+    /// Updates an outdated main .solv cache to the new primary.xml. Packages are matched by their pkgid,
+    /// only the added packages are parsed from the primary and the removed ones are dropped from the cache.
+    /// Returns false if there is no outdated cache or too many packages changed, the caller parses
+    /// the whole primary then.
+    bool update_main_cache(const std::string & repomd_fn, const std::string & primary_fn);
+
+    /// Attaches a valid filelists cache as a stub repodata. libsolv loads the cache only when it needs
+    /// a file which is not in the primary file list (e.g. for a file dependency or a file query).
+    /// Returns false if there is no valid cache.
+    bool add_filelists_stub(const std::string & type_name);
+
+    /// libsolv pool load callback, loads stub repodata attached by `add_filelists_stub()`.
+    static int load_stub_callback(::Pool * pool, Repodata * data, void * callback_data);
+
     /// Writes libsolv's .solv cache file with main libsolv repodata.
     void write_main(bool load_after_write);
 
     /// Writes libsolv's .solvx cache file with extended libsolv repodata.
     void write_ext(Id repodata_id, RepodataType type, const std::string & type_name);
 
+    /// Writes the serialized cache `data` to the cache file `path` in a background thread.
+    /// Used by the staging repo, the cache files of the staging repo are not loaded back.
+    /// At most one write is in progress, a new write first waits for the previous one. The number of writer
+    /// threads is thus bounded by the number of the cache builder threads, each of them builds one staging repo.
+    void write_cache_file_async(std::filesystem::path path, SerializedSolvCache data);
+
+    /// Waits until the cache files written in the background are renamed to their final paths.
+    /// Rethrows the first error of the background writes.
+    void wait_for_cache_writes();
+
+    /// Waits for the write in progress, its error is kept for `wait_for_cache_writes()`.
+    void wait_for_pending_cache_write();
+
     std::string solv_file_name(const char * type = nullptr);
     std::filesystem::path solv_file_path(const char * type = nullptr);
 
+    /// Opens the search index of the main solvables, an outdated or missing index is built and written first.
+    void load_search_index();
+
     libdnf5::BaseWeakPtr base;
     const ConfigRepo & config;
 
+    /// The pool containing `repo`, either the rpm pool of `base` or a private staging pool
+    solv::Pool & rpm_pool;
+
+    /// True if the repo lives in a private staging pool, used only for writing cache files
+    bool staging{false};
+
     bool needs_internalizing{false};
 
     /// Ranges of solvables for different types of data, used for writing libsolv cache files
@@ -150,7 +236,22 @@ private:
     int updateinfo_solvables_start{0};
     int updateinfo_solvables_end{0};
 
-    bool can_use_solvfile_cache(solv::Pool & pool, utils::fs::File & solvfile_cache);
+    /// Trigram index of the main solvables, packages in the index are ranked in the order of their ids
+    std::unique_ptr<SearchIndex> search_index;
+
+    /// Validated filelists cache waiting to be loaded into the stub repodata
+    std::unique_ptr<utils::fs::MappedFile> filelists_stub_cache;
+
+    /// Cookie of the installroot rpmdb loaded into the system repo, empty if unknown
+    std::string loaded_rpmdb_cookie;
+
+    /// Cache file being written in the background, the destructor of the future waits for the write
+    std::future<void> pending_cache_write;
+    /// The first error of the background writes not yet reported by `wait_for_cache_writes()`
+    std::exception_ptr cache_write_error;
+
+    bool can_use_solvfile_cache(
+        solv::Pool & pool, const utils::fs::MappedFile & solvfile_cache, bool check_checksum = true);
     void userdata_fill(SolvUserdata * userdata);
 
     /// List of system repo groups without valid file with xml definition
@@ -0,0 +1,198 @@
+// Copyright Contributors to the DNF5 project.
+// Copyright Contributors to the libdnf project.
+// SPDX-License-Identifier: LGPL-2.1-or-later
+//
+// This file is part of libdnf: https://github.com/rpm-software-management/libdnf/
+//
+// Libdnf is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 2.1 of the License, or
+// (at your option) any later version.
+//
+// Libdnf is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
+
+#include "dependency_graph.hpp"
+
+#include "solv/id_queue.hpp"
+
+extern "C" {
+#include <solv/pool.h>
+}
+
+#include <algorithm>
+#include <limits>
+#include <utility>
+
+
+namespace libdnf5::rpm {
+
+namespace {
+
+constexpr unsigned int NO_NODE = std::numeric_limits<unsigned int>::max();
+
+}  // namespace
+
+
+DependencyGraph::DependencyGraph(libdnf5::solv::RpmPool & spool, std::vector<Id> packages, bool use_recommends)
+    : packages(std::move(packages)),
+      use_recommends(use_recommends) {
+    ::Pool * pool = *spool;
+
+    std::vector<unsigned int> node_of(static_cast<std::size_t>(pool->nsolvables), NO_NODE);
+    for (unsigned int node = 0; node < this->packages.size(); ++node) {
+        node_of[static_cast<std::size_t>(this->packages[node])] = node;
+    }
+
+    offsets.reserve(this->packages.size() + 1);
+    offsets.push_back(0);
+
+    libdnf5::solv::IdQueue deps;
+    libdnf5::solv::IdQueue recommends;
+    std::vector<unsigned int> node_targets;
+    Id provider;
+    Id pp;
+    for (unsigned int node = 0; node < this->packages.size(); ++node) {
+        Solvable * solvable = spool.id2solvable(this->packages[node]);
+        deps.clear();
+        solvable_lookup_idarray(solvable, SOLVABLE_REQUIRES, &deps.get_queue());
+        if (use_recommends) {
+            recommends.clear();
+            solvable_lookup_idarray(solvable, SOLVABLE_RECOMMENDS, &recommends.get_queue());
+            deps += recommends;
+        }
+
+        // add an edge if there is exactly one package of the set satisfying the dependency
+        node_targets.clear();
+        for (Id dep : deps) {
+            if (dep == SOLVABLE_PREREQMARKER) {
+                continue;
+            }
+            unsigned int target = NO_NODE;
+            bool single_provider = false;
+            FOR_PROVIDES(provider, pp, dep) {
+                auto provider_node = node_of[static_cast<std::size_t>(provider)];
+                if (provider_node == NO_NODE) {
+                    continue;
+                }
+                if (target != NO_NODE) {
+                    single_provider = false;
+                    break;
+                }
+                target = provider_node;
+                single_provider = true;
+            }
+            // self-edges are not needed
+            if (single_provider && target != node) {
+                node_targets.push_back(target);
+            }
+        }
+        std::sort(node_targets.begin(), node_targets.end());
+        node_targets.erase(std::unique(node_targets.begin(), node_targets.end()), node_targets.end());
+        targets.insert(targets.end(), node_targets.begin(), node_targets.end());
+        offsets.push_back(targets.size());
+    }
+}
+
+
+const std::vector<std::vector<unsigned int>> & DependencyGraph::get_leaves() {
+    if (leaves) {
+        return *leaves;
+    }
+
+    const auto nodes_count = static_cast<unsigned int>(packages.size());
+
+    // Iterative Tarjan's algorithm, the recursion is replaced by a stack of <node, next edge> frames
+    struct Frame {
+        unsigned int node;
+        std::size_t next_edge;
+    };
+    std::vector<unsigned int> index(nodes_count, NO_NODE);
+    std::vector<unsigned int> lowlink(nodes_count, 0);
+    std::vector<unsigned int> component(nodes_count, NO_NODE);
+    std::vector<bool> on_stack(nodes_count, false);
+    std::vector<unsigned int> scc_stack;
+    std::vector<Frame> call_stack;
+    unsigned int next_index = 0;
+    unsigned int components_count = 0;
+
+    for (unsigned int root = 0; root < nodes_count; ++root) {
+        if (index[root] != NO_NODE) {
+            continue;
+        }
+
+        index[root] = lowlink[root] = next_index++;
+        scc_stack.push_back(root);
+        on_stack[root] = true;
+        call_stack.push_back({root, offsets[root]});
+
+        while (!call_stack.empty()) {
+            const auto node = call_stack.back().node;
+            auto & next_edge = call_stack.back().next_edge;
+            if (next_edge < offsets[node + 1]) {
+                const auto target = targets[next_edge++];
+                if (index[target] == NO_NODE) {
+                    index[target] = lowlink[target] = next_index++;
+                    scc_stack.push_back(target);
+                    on_stack[target] = true;
+                    call_stack.push_back({target, offsets[target]});
+                } else if (on_stack[target]) {
+                    lowlink[node] = std::min(lowlink[node], index[target]);
+                }
+                continue;
+            }
+
+            if (lowlink[node] == index[node]) {
+                // the node is the root of a component, the component is on the top of the stack
+                unsigned int member;
+                do {
+                    member = scc_stack.back();
+                    scc_stack.pop_back();
+                    on_stack[member] = false;
+                    component[member] = components_count;
+                } while (member != node);
+                ++components_count;
+            }
+
+            call_stack.pop_back();
+            if (!call_stack.empty()) {
+                const auto parent = call_stack.back().node;
+                lowlink[parent] = std::min(lowlink[parent], lowlink[node]);
+            }
+        }
+    }
+
+    // a component is a leaf if no other component has an edge to it
+    std::vector<bool> has_incoming_edge(components_count, false);
+    for (unsigned int node = 0; node < nodes_count; ++node) {
+        for (auto edge = offsets[node]; edge < offsets[node + 1]; ++edge) {
+            const auto target = targets[edge];
+            if (component[target] != component[node]) {
+                has_incoming_edge[component[target]] = true;
+            }
+        }
+    }
+
+    leaves.emplace();
+    std::vector<unsigned int> leaf_of_component(components_count, NO_NODE);
+    for (unsigned int node = 0; node < nodes_count; ++node) {
+        const auto node_component = component[node];
+        if (has_incoming_edge[node_component]) {
+            continue;
+        }
+        if (leaf_of_component[node_component] == NO_NODE) {
+            leaf_of_component[node_component] = static_cast<unsigned int>(leaves->size());
+            leaves->emplace_back();
+        }
+        (*leaves)[leaf_of_component[node_component]].push_back(node);
+    }
+
+    return *leaves;
+}
+
+}  // namespace libdnf5::rpm
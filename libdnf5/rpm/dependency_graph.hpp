@@ -0,0 +1,63 @@
+// Copyright Contributors to the DNF5 project.
+// Copyright Contributors to the libdnf project.
+// SPDX-License-Identifier: LGPL-2.1-or-later
+//
+// This file is part of libdnf: https://github.com/rpm-software-management/libdnf/
+//
+// Libdnf is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 2.1 of the License, or
+// (at your option) any later version.
+//
+// Libdnf is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
+
+#ifndef LIBDNF5_RPM_DEPENDENCY_GRAPH_HPP
+#define LIBDNF5_RPM_DEPENDENCY_GRAPH_HPP
+
+#include "solv/pool.hpp"
+
+#include <cstddef>
+#include <optional>
+#include <vector>
+
+
+namespace libdnf5::rpm {
+
+/// Directed graph of the dependencies between packages of a set stored in compressed sparse row arrays.
+/// The nodes are indices into the sorted package ids of the set. Package `i` has an edge to package `j`
+/// when `j` is the only package of the set satisfying one of the dependencies of `i`.
+class DependencyGraph {
+public:
+    /// Builds the graph of `packages` from their requires and optionally recommends.
+    /// The provides of the pool must be ready.
+    /// @param packages  Sorted ids of the package solvables.
+    DependencyGraph(libdnf5::solv::RpmPool & pool, std::vector<Id> packages, bool use_recommends);
+
+    const std::vector<Id> & get_packages() const noexcept { return packages; }
+    bool get_use_recommends() const noexcept { return use_recommends; }
+
+    /// Returns the strongly connected components without incoming edges from other components.
+    /// Each component is a sorted list of node indices, the components are ordered by their first node.
+    /// The components are computed by an iterative Tarjan's algorithm on the first call and cached.
+    const std::vector<std::vector<unsigned int>> & get_leaves();
+
+private:
+    std::vector<Id> packages;
+    bool use_recommends;
+
+    /// Edges of the node `i` are `targets[offsets[i]]` to `targets[offsets[i + 1]]`
+    std::vector<std::size_t> offsets;
+    std::vector<unsigned int> targets;
+
+    std::optional<std::vector<std::vector<unsigned int>>> leaves;
+};
+
+}  // namespace libdnf5::rpm
+
+#endif  // LIBDNF5_RPM_DEPENDENCY_GRAPH_HPP
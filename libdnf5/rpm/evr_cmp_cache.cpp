@@ -0,0 +1,110 @@
+// Copyright Contributors to the DNF5 project.
+// Copyright Contributors to the libdnf project.
+// SPDX-License-Identifier: LGPL-2.1-or-later
+//
+// This file is part of libdnf: https://github.com/rpm-software-management/libdnf/
+//
+// Libdnf is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 2.1 of the License, or
+// (at your option) any later version.
+//
+// Libdnf is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
+
+#include "evr_cmp_cache.hpp"
+
+
+namespace libdnf5::rpm {
+
+namespace {
+
+// The memoized results are dropped when they grow over the limit, it bounds the memory used by long-running
+// processes which query many different patterns.
+constexpr std::size_t EVR_CMP_CACHE_MAX_SIZE = 1 << 20;
+
+}  // namespace
+
+
+EvrCmpCache::PatternCmp::PatternCmp(
+    EvrCmpCache & cache,
+    libdnf5::solv::RpmPool & pool,
+    Part part,
+    std::string_view pattern,
+    std::unordered_map<Id, int> & results)
+    : cache(cache),
+      pool(pool),
+      part(part),
+      results(results) {
+    switch (part) {
+        case Part::EVR:
+            formatted_pattern = pattern;
+            break;
+        case Part::VERSION:
+            formatted_pattern.append(pattern).append("-0");
+            break;
+        case Part::RELEASE:
+            formatted_pattern.append("0-").append(pattern);
+            break;
+    }
+}
+
+
+int EvrCmpCache::PatternCmp::compare(Id evr_id) {
+    if (auto it = results.find(evr_id); it != results.end()) {
+        return it->second;
+    }
+
+    const char * evr = nullptr;
+    switch (part) {
+        case Part::EVR:
+            evr = pool.id2str(evr_id);
+            break;
+        case Part::VERSION:
+            evr = cache.get_split_evr(pool, evr_id).version.c_str();
+            break;
+        case Part::RELEASE:
+            evr = cache.get_split_evr(pool, evr_id).release.c_str();
+            break;
+    }
+    int cmp = pool.evrcmp_str(evr, formatted_pattern.c_str(), EVRCMP_COMPARE);
+    results.emplace(evr_id, cmp);
+    ++cache.results_count;
+    return cmp;
+}
+
+
+EvrCmpCache::PatternCmp EvrCmpCache::get_pattern_cmp(
+    libdnf5::solv::RpmPool & pool, Part part, std::string_view pattern) {
+    // dropped here, the maps referenced by the comparators handed out before are not in use any more
+    if (results_count >= EVR_CMP_CACHE_MAX_SIZE) {
+        for (auto & part_results : results) {
+            part_results.clear();
+        }
+        results_count = 0;
+    }
+    auto & pattern_results = results[static_cast<std::size_t>(part)][std::string(pattern)];
+    return PatternCmp(*this, pool, part, pattern, pattern_results);
+}
+
+
+const EvrCmpCache::SplitEvr & EvrCmpCache::get_split_evr(libdnf5::solv::RpmPool & pool, Id evr_id) {
+    auto [it, inserted] = split_evrs.try_emplace(evr_id);
+    if (inserted) {
+        auto evr = pool.split_evr(pool.id2str(evr_id));
+        it->second.version = evr.v;
+        it->second.version.append("-0");
+        it->second.release = "0-";
+        if (evr.r) {
+            it->second.release.append(evr.r);
+        }
+    }
+    return it->second;
+}
+
+}  // namespace libdnf5::rpm
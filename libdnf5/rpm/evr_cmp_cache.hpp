@@ -0,0 +1,91 @@
+// Copyright Contributors to the DNF5 project.
+// Copyright Contributors to the libdnf project.
+// SPDX-License-Identifier: LGPL-2.1-or-later
+//
+// This file is part of libdnf: https://github.com/rpm-software-management/libdnf/
+//
+// Libdnf is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 2.1 of the License, or
+// (at your option) any later version.
+//
+// Libdnf is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
+
+#ifndef LIBDNF5_RPM_EVR_CMP_CACHE_HPP
+#define LIBDNF5_RPM_EVR_CMP_CACHE_HPP
+
+#include "solv/pool.hpp"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+
+namespace libdnf5::rpm {
+
+/// Memoized comparisons of package EVRs with the patterns of the EVR, version and release filters.
+/// The EVRs are identified by their Ids in the string pool, which are never reused. The patterns are kept as strings,
+/// so that querying arbitrary user input does not grow the string pool.
+class EvrCmpCache {
+public:
+    /// The part of the package EVR compared with a pattern
+    enum class Part { EVR, VERSION, RELEASE };
+
+    /// Compares the parts of package EVRs with one pattern and memoizes the results
+    class PatternCmp {
+    public:
+        /// Compares the part of the EVR `evr_id` with the pattern the same way as `pool_evrcmp_str()`.
+        /// @return A value less than, equal to or greater than zero if the part is older than, equal to or newer
+        ///         than the pattern.
+        int compare(Id evr_id);
+
+    private:
+        friend EvrCmpCache;
+
+        PatternCmp(
+            EvrCmpCache & cache,
+            libdnf5::solv::RpmPool & pool,
+            Part part,
+            std::string_view pattern,
+            std::unordered_map<Id, int> & results);
+
+        EvrCmpCache & cache;
+        libdnf5::solv::RpmPool & pool;
+        Part part;
+        std::string formatted_pattern;
+        std::unordered_map<Id, int> & results;
+    };
+
+    /// Returns the comparator of the `part` of package EVRs with `pattern`.
+    /// It is valid until the next call of `get_pattern_cmp()`.
+    PatternCmp get_pattern_cmp(libdnf5::solv::RpmPool & pool, Part part, std::string_view pattern);
+
+private:
+    /// Version and release of an EVR formatted as EVRs, so they can be compared by `pool_evrcmp_str()`
+    struct SplitEvr {
+        std::string version;  // "<version>-0"
+        std::string release;  // "0-<release>"
+    };
+
+    const SplitEvr & get_split_evr(libdnf5::solv::RpmPool & pool, Id evr_id);
+
+    /// evr Id -> version and release of the EVR
+    std::unordered_map<Id, SplitEvr> split_evrs;
+    /// pattern -> evr Id -> result of the comparison, one map per part
+    std::array<std::unordered_map<std::string, std::unordered_map<Id, int>>, 3> results;
+    /// The number of memoized results in all the maps
+    std::size_t results_count{0};
+};
+
+}  // namespace libdnf5::rpm
+
+#endif  // LIBDNF5_RPM_EVR_CMP_CACHE_HPP
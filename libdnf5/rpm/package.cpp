@@ -237,6 +237,13 @@ std::vector<libdnf5::rpm::Changelog> Package::get_changelogs() const {
     }
     dataiterator_free(&di);
 
+    if (changelogs.empty() && pool.is_installed(solvable)) {
+        if (auto rpmdb_id = solvable_lookup_num(solvable, RPM_RPMDBID, 0)) {
+            changelogs = p_impl->base->get_rpm_package_sack()->p_impl->read_installed_changelogs(
+                static_cast<unsigned int>(rpmdb_id));
+        }
+    }
+
     return changelogs;
 }
 
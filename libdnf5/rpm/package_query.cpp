@@ -22,7 +22,9 @@
 #include "common/sack/query_cmp_private.hpp"
 #include "package_query_impl.hpp"
 #include "package_set_impl.hpp"
+#include "repo/solv_repo.hpp"
 #include "solv/solver.hpp"
+#include "solv/sparse_solv_map.hpp"
 #include "utils/convert.hpp"
 
 #include "libdnf5/advisory/advisory_query.hpp"
@@ -32,14 +34,16 @@
 
 extern "C" {
 #include <solv/evr.h>
-#include <solv/selection.h>
+#include <solv/repodata.h>
 #include <solv/solvable.h>
 #include <solv/solver.h>
 }
 
 #include <fnmatch.h>
 
+#include <atomic>
 #include <filesystem>
+#include <thread>
 
 namespace libdnf5::rpm {
 
@@ -218,11 +222,7 @@ Id what_downgrades(libdnf5::solv::RpmPool & spool, const Solvable * solvable) {
     return l;
 }
 
-inline bool name_compare_lower_id(const Solvable * first, Id id_name) {
-    return first->name < id_name;
-}
-
-inline bool name_compare_icase_lower_id(const std::pair<Id, Solvable *> first, Id id_name) {
+inline bool name_compare_icase_lower_id(const std::pair<Id, Id> first, Id id_name) {
     return first.first < id_name;
 }
 
@@ -234,169 +234,77 @@ static inline bool name_arch_compare_lower(const Solvable * first, const T * sec
     return first->arch < second->arch;
 }
 
-void add_edges(
-    Base & base,
-    std::set<unsigned int> & edges,
-    const PackageQuery & full_query,
-    const std::map<PackageId, unsigned int> & pkg_id2idx,
-    const ReldepList & deps) {
-    // resolve dependencies and add an edge if there is exactly one package satisfying it
-    for (int i = 0; i < deps.size(); ++i) {
-        ReldepList req_in_list(base);
-        req_in_list.add(deps.get_id(i));
-        PackageQuery query(full_query);
-        query.filter_provides(req_in_list);
-        if (query.size() == 1) {
-            auto pkg = *query.begin();
-            edges.insert(pkg_id2idx.at(pkg.get_id()));
-        }
-    }
-}
-
-std::vector<std::vector<unsigned int>> build_graph(
-    Base & base, const PackageQuery & full_query, const std::vector<Package> & pkgs, bool use_recommends) {
-    // create pkg_id2idx to map Packages to their index in pkgs
-    std::map<PackageId, unsigned int> pkg_id2idx;
-    for (size_t i = 0; i < pkgs.size(); ++i) {
-        pkg_id2idx.emplace(pkgs[i].get_id(), i);
-    }
-
-    std::vector<std::vector<unsigned int>> graph;
-    graph.reserve(pkgs.size());
-
-    for (unsigned int i = 0; i < pkgs.size(); ++i) {
-        std::set<unsigned int> edges;
-        const auto & package = pkgs[i];
-        add_edges(base, edges, full_query, pkg_id2idx, package.get_requires());
-        if (use_recommends) {
-            add_edges(base, edges, full_query, pkg_id2idx, package.get_recommends());
-        }
-        edges.erase(i);  // remove self-edges
-        graph.emplace_back(edges.begin(), edges.end());
-    }
-
-    return graph;
-}
-
-std::vector<std::vector<unsigned int>> reverse_graph(const std::vector<std::vector<unsigned int>> & graph) {
-    std::vector<std::vector<unsigned int>> rgraph(graph.size());
-
-    // pre-allocate (reserve) memory to prevent reallocations
-    std::vector<unsigned int> lengths(graph.size(), 0);
-    for (const auto & edges : graph) {
-        for (auto edge : edges) {
-            ++lengths[edge];
-        }
-    }
-    for (unsigned int i = 0; i < graph.size(); ++i) {
-        rgraph[i].reserve(lengths[i]);
-    }
+// Smaller candidate sets are scanned by the calling thread, starting workers would cost more than it saves.
+constexpr std::size_t PARALLEL_SCAN_MIN_CANDIDATES_PER_WORKER = 4096;
 
-    // reverse graph
-    for (unsigned int i = 0; i < graph.size(); ++i) {
-        for (auto edge : graph[i]) {
-            rgraph[edge].push_back(i);
-        }
-    }
+// Number of id ranges per worker. Candidates are often clustered (e.g. in one repository), more ranges
+// than workers keep the workers evenly loaded.
+constexpr int PARALLEL_SCAN_RANGES_PER_WORKER = 8;
 
-    return rgraph;
+/// @return the number of workers scanning `candidates`, values below 2 mean the scan is not concurrent.
+std::size_t get_scan_workers_count(const libdnf5::solv::SolvMap & candidates) {
+    const auto hw_threads = static_cast<std::size_t>(std::max(1u, std::thread::hardware_concurrency()));
+    return std::min(hw_threads, candidates.size() / PARALLEL_SCAN_MIN_CANDIDATES_PER_WORKER);
 }
 
-std::vector<std::vector<unsigned int>> kosaraju(const std::vector<std::vector<unsigned int>> & graph) {
-    const auto N = static_cast<unsigned int>(graph.size());
-    std::vector<unsigned int> rstack(N);
-    std::vector<unsigned int> stack(N);
-    std::vector<bool> tag(N, false);
-    unsigned int r = N;
-    unsigned int top = 0;
-
-    // do depth-first searches in the graph and push nodes to rstack
-    // "on the way up" until all nodes have been pushed.
-    // tag nodes as they're processed so we don't visit them more than once
-    for (unsigned int i = 0; i < N; ++i) {
-        if (tag[i]) {
-            continue;
-        }
-
-        unsigned int u = i;
-        unsigned int j = 0;
-        tag[u] = true;
-        while (true) {
-            const auto & edges = graph[u];
-            if (j < edges.size()) {
-                const auto v = edges[j++];
-                if (!tag[v]) {
-                    rstack[top] = j;
-                    stack[top++] = u;
-                    u = v;
-                    j = 0;
-                    tag[u] = true;
-                }
-            } else {
-                rstack[--r] = u;
-                if (top == 0) {
-                    break;
-                }
-                u = stack[--top];
-                j = rstack[top];
+/// Adds candidates for which `match(candidate_id)` returns true to `filter_result`.
+///
+/// Large candidate sets are split into ranges of solvable ids which are scanned by concurrent workers,
+/// `match` must therefore be safe to call from multiple threads (it must not use the pool temporary space
+/// or load repodata). The partial results are added to `filter_result` in the calling thread in id order.
+template <typename FilterResult, typename Match>
+void scan_candidates(const libdnf5::solv::SolvMap & candidates, FilterResult & filter_result, Match match) {
+    const auto num_workers = get_scan_workers_count(candidates);
+
+    if (num_workers < 2) {
+        for (Id candidate_id : candidates) {
+            if (match(candidate_id)) {
+                filter_result.add_unsafe(candidate_id);
             }
         }
+        return;
     }
 
-    if (r != 0) {
-        throw std::logic_error("leaves: kosaraju(): r != 0");
-    }
-
-    // now searches beginning at nodes popped from rstack in the graph with all
-    // edges reversed will give us the strongly connected components.
-    // this time all nodes are tagged, so let's remove the tags as we visit each
-    // node.
-    // the incoming edges to each component is the union of incoming edges to
-    // each node in the component minus the incoming edges from component nodes
-    // themselves.
-    // if there are no such incoming edges the component is a leaf and we
-    // add it to the array of leaves.
-    auto rgraph = reverse_graph(graph);
-    std::set<unsigned int> sccredges;
-    std::vector<std::vector<unsigned int>> leaves;
-    for (; r < N; ++r) {
-        unsigned int u = rstack[r];
-        if (!tag[u]) {
-            continue;
-        }
-
-        stack[top++] = u;
-        tag[u] = false;
-        unsigned int s = N;
-        while (top) {
-            u = stack[--s] = stack[--top];
-            const auto & redges = rgraph[u];
-            for (unsigned int j = 0; j < redges.size(); ++j) {
-                const unsigned int v = redges[j];
-                sccredges.insert(v);
-                if (!tag[v]) {
-                    continue;
+    // Range boundaries are multiples of 8 so the ranges do not share bytes of the map
+    const int num_ranges = static_cast<int>(num_workers) * PARALLEL_SCAN_RANGES_PER_WORKER;
+    const int map_size = candidates.allocated_size();
+    const int range_size = ((map_size / num_ranges) | 7) + 1;
+
+    std::vector<std::vector<Id>> range_results(static_cast<std::size_t>(num_ranges));
+    std::atomic<int> next_range{0};
+    auto worker = [&]() {
+        for (int range = next_range++; range < num_ranges; range = next_range++) {
+            const Id range_begin = range * range_size;
+            const Id range_end = std::min(range_begin + range_size, map_size);
+            auto & result = range_results[static_cast<std::size_t>(range)];
+            auto it = candidates.begin();
+            for (it.jump(range_begin); it != candidates.end() && *it < range_end; ++it) {
+                if (match(*it)) {
+                    result.push_back(*it);
                 }
-
-                stack[top++] = v;
-                tag[v] = false;
             }
         }
+    };
 
-        for (unsigned int i = s; i < N; ++i) {
-            sccredges.erase(stack[i]);
+    std::vector<std::thread> workers;
+    workers.reserve(num_workers - 1);
+    try {
+        for (std::size_t i = 1; i < num_workers; ++i) {
+            workers.emplace_back(worker);
         }
+    } catch (const std::system_error &) {
+        // Failed to start a thread, the remaining ranges are scanned by the already running workers.
+    }
+    worker();
+    for (auto & thread : workers) {
+        thread.join();
+    }
 
-        if (sccredges.empty()) {
-            std::vector scc(stack.begin() + static_cast<std::vector<unsigned int>::difference_type>(s), stack.end());
-            std::sort(scc.begin(), scc.end());
-            leaves.emplace_back(std::move(scc));
-        } else {
-            sccredges.clear();
+    for (const auto & result : range_results) {
+        for (Id candidate_id : result) {
+            filter_result.add_unsafe(candidate_id);
         }
     }
-
-    return leaves;
 }
 
 
@@ -464,17 +372,27 @@ PackageQuery & PackageQuery::operator=(PackageQuery && src) noexcept = default;
 
 PackageQuery::~PackageQuery() = default;
 
-template <const char * (libdnf5::solv::Pool::*getter)(Id) const>
+template <const char * (libdnf5::solv::Pool::*getter)(Id) const, typename FilterResult>
 inline static void filter_glob_internal(
     libdnf5::solv::Pool & pool,
     const char * c_pattern,
     const libdnf5::solv::SolvMap & candidates,
-    libdnf5::solv::SolvMap & filter_result,
+    FilterResult & filter_result,
     int fnm_flags) {
-    for (Id candidate_id : candidates) {
-        const char * candidate_str = (pool.*getter)(candidate_id);
-        if (fnmatch(c_pattern, candidate_str, fnm_flags) == 0) {
-            filter_result.add_unsafe(candidate_id);
+    // Getters which only map an Id to a string can be called concurrently, the others use the pool temporary space
+    constexpr bool concurrent_getter = getter == &libdnf5::solv::Pool::get_name ||
+                                       getter == &libdnf5::solv::Pool::get_arch ||
+                                       getter == &libdnf5::solv::Pool::get_vendor;
+    if constexpr (concurrent_getter) {
+        scan_candidates(candidates, filter_result, [&pool, c_pattern, fnm_flags](Id candidate_id) {
+            return fnmatch(c_pattern, (pool.*getter)(candidate_id), fnm_flags) == 0;
+        });
+    } else {
+        for (Id candidate_id : candidates) {
+            const char * candidate_str = (pool.*getter)(candidate_id);
+            if (fnmatch(c_pattern, candidate_str, fnm_flags) == 0) {
+                filter_result.add_unsafe(candidate_id);
+            }
         }
     }
 }
@@ -482,8 +400,7 @@ inline static void filter_glob_internal(
 void PackageQuery::filter_name(const std::vector<std::string> & patterns, libdnf5::sack::QueryCmp cmp_type) {
     auto & pool = get_rpm_pool(p_impl->base);
     auto sack = p_impl->base->get_rpm_package_sack();
-    libdnf5::solv::SolvMap filter_result(pool.get_nsolvables());
-    auto & sorted_solvables = sack->p_impl->get_sorted_solvables();
+    libdnf5::solv::SparseSolvMap filter_result(pool.get_nsolvables());
 
     bool cmp_not = (cmp_type & libdnf5::sack::QueryCmp::NOT) == libdnf5::sack::QueryCmp::NOT;
     if (cmp_not) {
@@ -507,11 +424,8 @@ void PackageQuery::filter_name(const std::vector<std::string> & patterns, libdnf
                 if (name_id == 0) {
                     continue;
                 }
-                auto low =
-                    std::lower_bound(sorted_solvables.begin(), sorted_solvables.end(), name_id, name_compare_lower_id);
-                while (low != sorted_solvables.end() && (*low)->name == name_id) {
-                    filter_result.add_unsafe(pool.solvable2id(*low));
-                    ++low;
+                for (Id solvable_id : sack->p_impl->get_sorted_solvables_by_name(name_id)) {
+                    filter_result.add_unsafe(solvable_id);
                 }
             } break;
             case libdnf5::sack::QueryCmp::IEXACT: {
@@ -526,30 +440,24 @@ void PackageQuery::filter_name(const std::vector<std::string> & patterns, libdnf
                     icase_name,
                     name_compare_icase_lower_id);
                 while (low != sorted_icase_solvables.end() && (*low).first == icase_name) {
-                    filter_result.add_unsafe(pool.solvable2id((*low).second));
+                    filter_result.add_unsafe((*low).second);
                     ++low;
                 }
             } break;
-            case libdnf5::sack::QueryCmp::ICONTAINS: {
-                for (Id candidate_id : *p_impl) {
-                    const char * name = pool.get_name(candidate_id);
-                    if (strcasestr(name, c_pattern) != nullptr) {
-                        filter_result.add_unsafe(candidate_id);
-                    }
-                }
-            } break;
+            case libdnf5::sack::QueryCmp::ICONTAINS:
+                scan_candidates(*p_impl, filter_result, [&pool, c_pattern](Id candidate_id) {
+                    return strcasestr(pool.get_name(candidate_id), c_pattern) != nullptr;
+                });
+                break;
             case libdnf5::sack::QueryCmp::IGLOB:
                 filter_glob_internal<&libdnf5::solv::RpmPool::get_name>(
                     pool, c_pattern, *p_impl, filter_result, FNM_CASEFOLD);
                 break;
-            case libdnf5::sack::QueryCmp::CONTAINS: {
-                for (Id candidate_id : *p_impl) {
-                    const char * name = pool.get_name(candidate_id);
-                    if (strstr(name, c_pattern) != nullptr) {
-                        filter_result.add_unsafe(candidate_id);
-                    }
-                }
-            } break;
+            case libdnf5::sack::QueryCmp::CONTAINS:
+                scan_candidates(*p_impl, filter_result, [&pool, c_pattern](Id candidate_id) {
+                    return strstr(pool.get_name(candidate_id), c_pattern) != nullptr;
+                });
+                break;
             case libdnf5::sack::QueryCmp::GLOB:
                 filter_glob_internal<&libdnf5::solv::RpmPool::get_name>(pool, c_pattern, *p_impl, filter_result, 0);
                 break;
@@ -560,9 +468,9 @@ void PackageQuery::filter_name(const std::vector<std::string> & patterns, libdnf
 
     // Apply filter results to query
     if (cmp_not) {
-        *p_impl -= filter_result;
+        filter_result.apply_difference(*p_impl);
     } else {
-        *p_impl &= filter_result;
+        filter_result.apply_intersection(*p_impl);
     }
 }
 
@@ -572,27 +480,22 @@ void PackageQuery::filter_name(const PackageSet & package_set, libdnf5::sack::Qu
     }
     auto sack = p_impl->base->get_rpm_package_sack();
     auto & pool = get_rpm_pool(p_impl->base);
-    libdnf5::solv::SolvMap filter_result(sack->get_nsolvables());
+    libdnf5::solv::SparseSolvMap filter_result(sack->get_nsolvables());
 
     libdnf_assert_same_base(p_impl->base, package_set.get_base());
 
-    auto & sorted_solvables = sack->p_impl->get_sorted_solvables();
-
     for (Id pattern_id : *package_set.p_impl) {
         Id pattern_name_id = pool.id2solvable(pattern_id)->name;
-        auto low =
-            std::lower_bound(sorted_solvables.begin(), sorted_solvables.end(), pattern_name_id, name_compare_lower_id);
-        while (low != sorted_solvables.end() && (*low)->name == pattern_name_id) {
-            filter_result.add_unsafe(pool.solvable2id(*low));
-            ++low;
+        for (Id solvable_id : sack->p_impl->get_sorted_solvables_by_name(pattern_name_id)) {
+            filter_result.add_unsafe(solvable_id);
         }
     }
 
     // Apply filter results to query
     if (cmp_type == sack::QueryCmp::NEQ) {
-        *p_impl -= filter_result;
+        filter_result.apply_difference(*p_impl);
     } else {
-        *p_impl &= filter_result;
+        filter_result.apply_intersection(*p_impl);
     }
 }
 
@@ -602,28 +505,30 @@ void PackageQuery::filter_name_arch(const PackageSet & package_set, libdnf5::sac
     }
     auto sack = p_impl->base->get_rpm_package_sack();
     auto & pool = get_rpm_pool(p_impl->base);
-    libdnf5::solv::SolvMap filter_result(sack->get_nsolvables());
+    libdnf5::solv::SparseSolvMap filter_result(sack->get_nsolvables());
 
     libdnf_assert_same_base(p_impl->base, package_set.get_base());
 
-    auto & sorted_solvables = sack->p_impl->get_sorted_solvables();
-
     for (Id pattern_id : *package_set.p_impl) {
         Solvable * pattern_solvable = pool.id2solvable(pattern_id);
+        // the solvables with the same name are sorted by arch
+        auto same_name = sack->p_impl->get_sorted_solvables_by_name(pattern_solvable->name);
         auto low = std::lower_bound(
-            sorted_solvables.begin(), sorted_solvables.end(), pattern_solvable, name_arch_compare_lower<Solvable>);
-        while (low != sorted_solvables.end() && (*low)->name == pattern_solvable->name &&
-               (*low)->arch == pattern_solvable->arch) {
-            filter_result.add_unsafe(pool.solvable2id(*low));
+            same_name.begin(),
+            same_name.end(),
+            pattern_solvable,
+            solvable_id_cmp(pool, name_arch_compare_lower<Solvable>));
+        while (low != same_name.end() && pool.id2solvable(*low)->arch == pattern_solvable->arch) {
+            filter_result.add_unsafe(*low);
             ++low;
         }
     }
 
     // Apply filter results to query
     if (cmp_type == sack::QueryCmp::NEQ) {
-        *p_impl -= filter_result;
+        filter_result.apply_difference(*p_impl);
     } else {
-        *p_impl &= filter_result;
+        filter_result.apply_intersection(*p_impl);
     }
 }
 
@@ -653,13 +558,16 @@ inline static bool cmp_lte(int cmp) {
 
 template <bool (*cmp_fnc)(int value_to_cmp)>
 inline static void filter_evr_internal(
-    libdnf5::solv::RpmPool & pool, const std::vector<std::string> & patterns, libdnf5::solv::SolvMap & query_result) {
+    libdnf5::solv::RpmPool & pool,
+    EvrCmpCache & evr_cmp_cache,
+    const std::vector<std::string> & patterns,
+    libdnf5::solv::SolvMap & query_result) {
     libdnf5::solv::SolvMap filter_result(static_cast<int>(pool->nsolvables));
     for (auto & pattern : patterns) {
-        const char * pattern_c_str = pattern.c_str();
+        auto pattern_cmp = evr_cmp_cache.get_pattern_cmp(pool, EvrCmpCache::Part::EVR, pattern);
         for (Id candidate_id : query_result) {
             Solvable * solvable = pool.id2solvable(candidate_id);
-            int cmp = pool.evrcmp_str(pool.id2str(solvable->evr), pattern_c_str, EVRCMP_COMPARE);
+            int cmp = pattern_cmp.compare(solvable->evr);
             if (cmp_fnc(cmp)) {
                 filter_result.add_unsafe(candidate_id);
             }
@@ -671,24 +579,25 @@ inline static void filter_evr_internal(
 
 void PackageQuery::filter_evr(const std::vector<std::string> & patterns, libdnf5::sack::QueryCmp cmp_type) {
     auto & pool = get_rpm_pool(p_impl->base);
+    auto & evr_cmp_cache = p_impl->base->get_rpm_package_sack()->p_impl->get_evr_cmp_cache();
     switch (cmp_type) {
         case libdnf5::sack::QueryCmp::GT:
-            filter_evr_internal<cmp_gt>(pool, patterns, *p_impl);
+            filter_evr_internal<cmp_gt>(pool, evr_cmp_cache, patterns, *p_impl);
             break;
         case libdnf5::sack::QueryCmp::LT:
-            filter_evr_internal<cmp_lt>(pool, patterns, *p_impl);
+            filter_evr_internal<cmp_lt>(pool, evr_cmp_cache, patterns, *p_impl);
             break;
         case libdnf5::sack::QueryCmp::GTE:
-            filter_evr_internal<cmp_gte>(pool, patterns, *p_impl);
+            filter_evr_internal<cmp_gte>(pool, evr_cmp_cache, patterns, *p_impl);
             break;
         case libdnf5::sack::QueryCmp::LTE:
-            filter_evr_internal<cmp_lte>(pool, patterns, *p_impl);
+            filter_evr_internal<cmp_lte>(pool, evr_cmp_cache, patterns, *p_impl);
             break;
         case libdnf5::sack::QueryCmp::EQ:
-            filter_evr_internal<cmp_eq>(pool, patterns, *p_impl);
+            filter_evr_internal<cmp_eq>(pool, evr_cmp_cache, patterns, *p_impl);
             break;
         case libdnf5::sack::QueryCmp::NEQ:
-            filter_evr_internal<cmp_neq>(pool, patterns, *p_impl);
+            filter_evr_internal<cmp_neq>(pool, evr_cmp_cache, patterns, *p_impl);
             break;
         default:
             libdnf_throw_assert_unsupported_query_cmp_type(cmp_type);
@@ -917,21 +826,39 @@ static inline bool nevra_compare_lower_id(const Solvable * first, const NevraID
     return first->evr < nevra_id.evr;
 }
 
+/// Data of the comparators sorting package solvables by name, arch and EVR rank
+struct EvrRankCmpData {
+    libdnf5::solv::RpmPool & pool;
+    const std::vector<unsigned int> & evr_ranks;
+};
+
+inline int evr_rank_cmp(unsigned int rank1, unsigned int rank2) {
+    return rank1 < rank2 ? -1 : (rank1 > rank2 ? 1 : 0);
+}
+
+// The EVRs are compared by their ranks, the packages with the same name as the pattern are ranked together.
 template <bool (*cmp_fnc)(int value_to_cmp)>
 inline static void filter_nevra_internal_solvable(
     libdnf5::solv::RpmPool & pool,
-    Solvable * pattern_solvable,
-    const std::vector<Solvable *> & sorted_solvables,
+    Id pattern_id,
+    const std::vector<Id> & sorted_solvables,
+    const std::vector<unsigned int> & evr_ranks,
     libdnf5::solv::SolvMap & filter_result) {
+    Solvable * pattern_solvable = pool.id2solvable(pattern_id);
+    const auto pattern_rank = evr_ranks[static_cast<std::size_t>(pattern_id)];
     auto low = std::lower_bound(
-        sorted_solvables.begin(), sorted_solvables.end(), pattern_solvable, name_arch_compare_lower<Solvable>);
-    while (low != sorted_solvables.end() && (*low)->name == pattern_solvable->name &&
-           (*low)->arch == pattern_solvable->arch) {
-        int cmp = pool.evrcmp((*low)->evr, pattern_solvable->evr, EVRCMP_COMPARE);
-        if (cmp_fnc(cmp)) {
-            filter_result.add_unsafe(pool.solvable2id(*low));
+        sorted_solvables.begin(),
+        sorted_solvables.end(),
+        pattern_solvable,
+        solvable_id_cmp(pool, name_arch_compare_lower<Solvable>));
+    for (; low != sorted_solvables.end(); ++low) {
+        Solvable * solvable = pool.id2solvable(*low);
+        if (solvable->name != pattern_solvable->name || solvable->arch != pattern_solvable->arch) {
+            break;
+        }
+        if (cmp_fnc(evr_rank_cmp(evr_ranks[static_cast<std::size_t>(*low)], pattern_rank))) {
+            filter_result.add_unsafe(*low);
         }
-        ++low;
     }
 }
 
@@ -939,20 +866,26 @@ template <bool (*cmp_fnc)(int value_to_cmp)>
 inline static void filter_nevra_internal_str(
     libdnf5::solv::RpmPool & pool,
     const char * c_pattern,
-    const std::vector<Solvable *> & sorted_solvables,
+    const std::vector<Id> & sorted_solvables,
     libdnf5::solv::SolvMap & filter_result) {
     NevraID nevra_id;
     if (!nevra_id.parse(pool, c_pattern, false)) {
         return;
     }
-    auto low =
-        std::lower_bound(sorted_solvables.begin(), sorted_solvables.end(), &nevra_id, name_arch_compare_lower<NevraID>);
-    while (low != sorted_solvables.end() && (*low)->name == nevra_id.name && (*low)->arch == nevra_id.arch) {
-        int cmp = pool.evrcmp_str(pool.id2str((*low)->evr), nevra_id.evr_str.c_str(), EVRCMP_COMPARE);
+    auto low = std::lower_bound(
+        sorted_solvables.begin(),
+        sorted_solvables.end(),
+        &nevra_id,
+        solvable_id_cmp(pool, name_arch_compare_lower<NevraID>));
+    for (; low != sorted_solvables.end(); ++low) {
+        Solvable * solvable = pool.id2solvable(*low);
+        if (solvable->name != nevra_id.name || solvable->arch != nevra_id.arch) {
+            break;
+        }
+        int cmp = pool.evrcmp_str(pool.id2str(solvable->evr), nevra_id.evr_str.c_str(), EVRCMP_COMPARE);
         if (cmp_fnc(cmp)) {
-            filter_result.add_unsafe(pool.solvable2id(*low));
+            filter_result.add_unsafe(*low);
         }
-        ++low;
     }
 }
 
@@ -1018,42 +951,45 @@ void PackageQuery::filter_nevra(const PackageSet & package_set, libdnf5::sack::Q
     libdnf5::solv::SolvMap filter_result(sack->p_impl->get_nsolvables());
 
     auto & sorted_solvables = sack->p_impl->get_sorted_solvables();
+    auto & evr_ranks = sack->p_impl->get_evr_ranks();
 
     switch (cmp_type) {
         case libdnf5::sack::QueryCmp::EQ: {
             for (Id pattern_id : *package_set.p_impl) {
                 Solvable * pattern_solvable = pool.id2solvable(pattern_id);
+                auto same_name = sack->p_impl->get_sorted_solvables_by_name(pattern_solvable->name);
                 auto low = std::lower_bound(
-                    sorted_solvables.begin(), sorted_solvables.end(), pattern_solvable, nevra_solvable_cmp_key);
-                while (low != sorted_solvables.end() && (*low)->name == pattern_solvable->name &&
-                       (*low)->arch == pattern_solvable->arch && (*low)->evr == pattern_solvable->evr) {
-                    filter_result.add_unsafe(pool.solvable2id(*low));
-                    ++low;
+                    same_name.begin(),
+                    same_name.end(),
+                    pattern_solvable,
+                    solvable_id_cmp(pool, nevra_solvable_cmp_key));
+                for (; low != same_name.end(); ++low) {
+                    Solvable * solvable = pool.id2solvable(*low);
+                    if (solvable->arch != pattern_solvable->arch || solvable->evr != pattern_solvable->evr) {
+                        break;
+                    }
+                    filter_result.add_unsafe(*low);
                 }
             }
         } break;
         case libdnf5::sack::QueryCmp::GT: {
             for (Id pattern_id : *package_set.p_impl) {
-                Solvable * pattern_solvable = pool.id2solvable(pattern_id);
-                filter_nevra_internal_solvable<cmp_gt>(pool, pattern_solvable, sorted_solvables, filter_result);
+                filter_nevra_internal_solvable<cmp_gt>(pool, pattern_id, sorted_solvables, evr_ranks, filter_result);
             }
         } break;
         case libdnf5::sack::QueryCmp::GTE: {
             for (Id pattern_id : *package_set.p_impl) {
-                Solvable * pattern_solvable = pool.id2solvable(pattern_id);
-                filter_nevra_internal_solvable<cmp_gte>(pool, pattern_solvable, sorted_solvables, filter_result);
+                filter_nevra_internal_solvable<cmp_gte>(pool, pattern_id, sorted_solvables, evr_ranks, filter_result);
             }
         } break;
         case libdnf5::sack::QueryCmp::LT: {
             for (Id pattern_id : *package_set.p_impl) {
-                Solvable * pattern_solvable = pool.id2solvable(pattern_id);
-                filter_nevra_internal_solvable<cmp_lt>(pool, pattern_solvable, sorted_solvables, filter_result);
+                filter_nevra_internal_solvable<cmp_lt>(pool, pattern_id, sorted_solvables, evr_ranks, filter_result);
             }
         } break;
         case libdnf5::sack::QueryCmp::LTE: {
             for (Id pattern_id : *package_set.p_impl) {
-                Solvable * pattern_solvable = pool.id2solvable(pattern_id);
-                filter_nevra_internal_solvable<cmp_lte>(pool, pattern_solvable, sorted_solvables, filter_result);
+                filter_nevra_internal_solvable<cmp_lte>(pool, pattern_id, sorted_solvables, evr_ranks, filter_result);
             }
         } break;
         default:
@@ -1071,19 +1007,18 @@ void PackageQuery::filter_nevra(const PackageSet & package_set, libdnf5::sack::Q
 template <bool (*cmp_fnc)(int value_to_cmp)>
 inline static void filter_version_internal(
     libdnf5::solv::RpmPool & pool,
+    EvrCmpCache & evr_cmp_cache,
     const char * c_pattern,
     libdnf5::solv::SolvMap & candidates,
     libdnf5::solv::SolvMap & filter_result) {
-    char * formatted_c_pattern = solv_dupjoin(c_pattern, "-0", nullptr);
+    auto pattern_cmp = evr_cmp_cache.get_pattern_cmp(pool, EvrCmpCache::Part::VERSION, c_pattern);
     for (Id candidate_id : candidates) {
-        std::string vr(pool.split_evr(pool.get_evr(candidate_id)).v);
-        vr.append("-0");
-        int cmp = pool.evrcmp_str(vr.c_str(), formatted_c_pattern, EVRCMP_COMPARE);
+        Solvable * solvable = pool.id2solvable(candidate_id);
+        int cmp = pattern_cmp.compare(solvable->evr);
         if (cmp_fnc(cmp)) {
             filter_result.add_unsafe(candidate_id);
         }
     }
-    solv_free(formatted_c_pattern);
 }
 
 void PackageQuery::filter_version(const std::vector<std::string> & patterns, libdnf5::sack::QueryCmp cmp_type) {
@@ -1094,6 +1029,7 @@ void PackageQuery::filter_version(const std::vector<std::string> & patterns, lib
     }
 
     auto & pool = get_rpm_pool(p_impl->base);
+    auto & evr_cmp_cache = p_impl->base->get_rpm_package_sack()->p_impl->get_evr_cmp_cache();
     libdnf5::solv::SolvMap filter_result(pool.get_nsolvables());
     bool cmp_glob = (cmp_type & libdnf5::sack::QueryCmp::GLOB) == libdnf5::sack::QueryCmp::GLOB;
 
@@ -1106,22 +1042,22 @@ void PackageQuery::filter_version(const std::vector<std::string> & patterns, lib
         }
         switch (tmp_cmp_type) {
             case libdnf5::sack::QueryCmp::EQ:
-                filter_version_internal<cmp_eq>(pool, c_pattern, *p_impl, filter_result);
+                filter_version_internal<cmp_eq>(pool, evr_cmp_cache, c_pattern, *p_impl, filter_result);
                 break;
             case libdnf5::sack::QueryCmp::GLOB:
                 filter_glob_internal<&libdnf5::solv::RpmPool::get_version>(pool, c_pattern, *p_impl, filter_result, 0);
                 break;
             case libdnf5::sack::QueryCmp::GT:
-                filter_version_internal<cmp_gt>(pool, c_pattern, *p_impl, filter_result);
+                filter_version_internal<cmp_gt>(pool, evr_cmp_cache, c_pattern, *p_impl, filter_result);
                 break;
             case libdnf5::sack::QueryCmp::LT:
-                filter_version_internal<cmp_lt>(pool, c_pattern, *p_impl, filter_result);
+                filter_version_internal<cmp_lt>(pool, evr_cmp_cache, c_pattern, *p_impl, filter_result);
                 break;
             case libdnf5::sack::QueryCmp::GTE:
-                filter_version_internal<cmp_gte>(pool, c_pattern, *p_impl, filter_result);
+                filter_version_internal<cmp_gte>(pool, evr_cmp_cache, c_pattern, *p_impl, filter_result);
                 break;
             case libdnf5::sack::QueryCmp::LTE:
-                filter_version_internal<cmp_lte>(pool, c_pattern, *p_impl, filter_result);
+                filter_version_internal<cmp_lte>(pool, evr_cmp_cache, c_pattern, *p_impl, filter_result);
                 break;
             default:
                 libdnf_throw_assert_unsupported_query_cmp_type(cmp_type);
@@ -1139,19 +1075,18 @@ void PackageQuery::filter_version(const std::vector<std::string> & patterns, lib
 template <bool (*cmp_fnc)(int value_to_cmp)>
 inline static void filter_release_internal(
     libdnf5::solv::RpmPool & pool,
+    EvrCmpCache & evr_cmp_cache,
     const char * c_pattern,
     libdnf5::solv::SolvMap & candidates,
     libdnf5::solv::SolvMap & filter_result) {
-    char * formatted_c_pattern = solv_dupjoin("0-", c_pattern, nullptr);
+    auto pattern_cmp = evr_cmp_cache.get_pattern_cmp(pool, EvrCmpCache::Part::RELEASE, c_pattern);
     for (Id candidate_id : candidates) {
-        std::string vr("0-");
-        vr.append(pool.split_evr(pool.get_evr(candidate_id)).r);
-        int cmp = pool.evrcmp_str(vr.c_str(), formatted_c_pattern, EVRCMP_COMPARE);
+        Solvable * solvable = pool.id2solvable(candidate_id);
+        int cmp = pattern_cmp.compare(solvable->evr);
         if (cmp_fnc(cmp)) {
             filter_result.add_unsafe(candidate_id);
         }
     }
-    solv_free(formatted_c_pattern);
 }
 
 void PackageQuery::filter_release(const std::vector<std::string> & patterns, libdnf5::sack::QueryCmp cmp_type) {
@@ -1162,6 +1097,7 @@ void PackageQuery::filter_release(const std::vector<std::string> & patterns, lib
     }
 
     auto & pool = get_rpm_pool(p_impl->base);
+    auto & evr_cmp_cache = p_impl->base->get_rpm_package_sack()->p_impl->get_evr_cmp_cache();
     libdnf5::solv::SolvMap filter_result(pool.get_nsolvables());
     bool cmp_glob = (cmp_type & libdnf5::sack::QueryCmp::GLOB) == libdnf5::sack::QueryCmp::GLOB;
 
@@ -1174,22 +1110,22 @@ void PackageQuery::filter_release(const std::vector<std::string> & patterns, lib
         }
         switch (tmp_cmp_type) {
             case libdnf5::sack::QueryCmp::EQ:
-                filter_release_internal<cmp_eq>(pool, c_pattern, *p_impl, filter_result);
+                filter_release_internal<cmp_eq>(pool, evr_cmp_cache, c_pattern, *p_impl, filter_result);
                 break;
             case libdnf5::sack::QueryCmp::GLOB:
                 filter_glob_internal<&libdnf5::solv::RpmPool::get_release>(pool, c_pattern, *p_impl, filter_result, 0);
                 break;
             case libdnf5::sack::QueryCmp::GT:
-                filter_release_internal<cmp_gt>(pool, c_pattern, *p_impl, filter_result);
+                filter_release_internal<cmp_gt>(pool, evr_cmp_cache, c_pattern, *p_impl, filter_result);
                 break;
             case libdnf5::sack::QueryCmp::LT:
-                filter_release_internal<cmp_lt>(pool, c_pattern, *p_impl, filter_result);
+                filter_release_internal<cmp_lt>(pool, evr_cmp_cache, c_pattern, *p_impl, filter_result);
                 break;
             case libdnf5::sack::QueryCmp::GTE:
-                filter_release_internal<cmp_gte>(pool, c_pattern, *p_impl, filter_result);
+                filter_release_internal<cmp_gte>(pool, evr_cmp_cache, c_pattern, *p_impl, filter_result);
                 break;
             case libdnf5::sack::QueryCmp::LTE:
-                filter_release_internal<cmp_lte>(pool, c_pattern, *p_impl, filter_result);
+                filter_release_internal<cmp_lte>(pool, evr_cmp_cache, c_pattern, *p_impl, filter_result);
                 break;
             default:
                 libdnf_throw_assert_unsupported_query_cmp_type(cmp_type);
@@ -1492,6 +1428,17 @@ void PackageQuery::filter_epoch(const std::vector<std::string> & patterns, libdn
     }
 }
 
+/// Loads the `keyname` data of all repositories into memory, see SolvRepo::load_data_for_concurrent_search().
+static void load_repodata_for_concurrent_search(Pool * pool, Id keyname) {
+    int repo_id;
+    ::Repo * repo;
+    FOR_REPOS(repo_id, repo) {
+        if (repo->appdata != nullptr) {
+            static_cast<libdnf5::repo::Repo *>(repo->appdata)->get_solv_repo().load_data_for_concurrent_search(keyname);
+        }
+    }
+}
+
 static void filter_dataiterator(
     Pool * pool,
     Id keyname,
@@ -1499,19 +1446,78 @@ static void filter_dataiterator(
     libdnf5::solv::SolvMap & candidates,
     libdnf5::solv::SolvMap & filter_result,
     const char * c_pattern) {
-    Dataiterator di;
-
-    for (Id candidate_id : candidates) {
+    auto match = [pool, keyname, flags, c_pattern](Id candidate_id) {
+        Dataiterator di;
         dataiterator_init(&di, pool, nullptr, candidate_id, keyname, c_pattern, flags);
-        while (dataiterator_step(&di) != 0) {
-            filter_result.add_unsafe(candidate_id);
+        bool found = dataiterator_step(&di) != 0;
+        dataiterator_free(&di);
+        return found;
+    };
+
+    // File names are assembled in the pool temporary space, file lists cannot be searched concurrently
+    if (keyname == SOLVABLE_FILELIST || get_scan_workers_count(candidates) < 2) {
+        for (Id candidate_id : candidates) {
+            if (match(candidate_id)) {
+                filter_result.add_unsafe(candidate_id);
+            }
+        }
+        return;
+    }
+
+    load_repodata_for_concurrent_search(pool, keyname);
+    scan_candidates(candidates, filter_result, match);
+}
+
+/// @return The longest part of a glob `pattern` that is matched literally,
+///         an empty string if the pattern contains escaped characters.
+static std::string_view get_glob_literal(std::string_view pattern) {
+    if (pattern.find('\\') != std::string_view::npos) {
+        return {};
+    }
+    std::string_view longest;
+    std::size_t pos = 0;
+    while (pos < pattern.size()) {
+        auto special = pattern.find_first_of("*?[", pos);
+        auto literal = pattern.substr(pos, special == std::string_view::npos ? special : special - pos);
+        if (literal.size() > longest.size()) {
+            longest = literal;
+        }
+        if (special == std::string_view::npos) {
             break;
         }
-        dataiterator_free(&di);
+        pos = special + 1;
+        if (pattern[special] == '[') {
+            // Skip the bracket expression, "]" right after "[" or "[!" is a part of the set
+            if (pos < pattern.size() && (pattern[pos] == '!' || pattern[pos] == '^')) {
+                ++pos;
+            }
+            if (pos < pattern.size() && pattern[pos] == ']') {
+                ++pos;
+            }
+            auto closing = pattern.find(']', pos);
+            if (closing == std::string_view::npos) {
+                // Unterminated "[" is matched literally, ignore the rest
+                break;
+            }
+            pos = closing + 1;
+        }
     }
+    return longest;
 }
 
-static void filter_dataiterator_internal(
+void PackageQuery::PQImpl::filter_search_index_candidates(
+    Pool * pool, std::string_view substring, libdnf5::solv::SolvMap & candidates) {
+    int repo_id;
+    ::Repo * repo;
+    FOR_REPOS(repo_id, repo) {
+        if (repo->appdata != nullptr) {
+            auto & solv_repo = static_cast<libdnf5::repo::Repo *>(repo->appdata)->get_solv_repo();
+            solv_repo.filter_search_index_candidates(substring, candidates);
+        }
+    }
+}
+
+void PackageQuery::PQImpl::filter_dataiterator_internal(
     Pool * pool,
     Id keyname,
     libdnf5::solv::SolvMap & candidates,
@@ -1558,7 +1564,20 @@ static void filter_dataiterator_internal(
             default:
                 libdnf_throw_assert_unsupported_query_cmp_type(cmp_type);
         }
-        filter_dataiterator(pool, keyname, flags, candidates, filter_result, c_pattern);
+
+        if (keyname == SOLVABLE_SUMMARY || keyname == SOLVABLE_DESCRIPTION || keyname == SOLVABLE_URL) {
+            // Every match contains the literal part of the pattern, the search indexes rule out
+            // the packages that do not contain it
+            std::string_view literal = pattern;
+            if ((flags & SEARCH_GLOB) != 0) {
+                literal = get_glob_literal(pattern);
+            }
+            libdnf5::solv::SolvMap pattern_candidates(candidates);
+            filter_search_index_candidates(pool, literal, pattern_candidates);
+            filter_dataiterator(pool, keyname, flags, pattern_candidates, filter_result, c_pattern);
+        } else {
+            filter_dataiterator(pool, keyname, flags, candidates, filter_result, c_pattern);
+        }
     }
 
     // Apply filter results to query
@@ -1570,19 +1589,20 @@ static void filter_dataiterator_internal(
 }
 
 void PackageQuery::filter_file(const std::vector<std::string> & patterns, libdnf5::sack::QueryCmp cmp_type) {
-    filter_dataiterator_internal(*get_rpm_pool(p_impl->base), SOLVABLE_FILELIST, *p_impl, cmp_type, patterns);
+    PQImpl::filter_dataiterator_internal(*get_rpm_pool(p_impl->base), SOLVABLE_FILELIST, *p_impl, cmp_type, patterns);
 }
 
 void PackageQuery::filter_description(const std::vector<std::string> & patterns, libdnf5::sack::QueryCmp cmp_type) {
-    filter_dataiterator_internal(*get_rpm_pool(p_impl->base), SOLVABLE_DESCRIPTION, *p_impl, cmp_type, patterns);
+    PQImpl::filter_dataiterator_internal(
+        *get_rpm_pool(p_impl->base), SOLVABLE_DESCRIPTION, *p_impl, cmp_type, patterns);
 }
 
 void PackageQuery::filter_summary(const std::vector<std::string> & patterns, libdnf5::sack::QueryCmp cmp_type) {
-    filter_dataiterator_internal(*get_rpm_pool(p_impl->base), SOLVABLE_SUMMARY, *p_impl, cmp_type, patterns);
+    PQImpl::filter_dataiterator_internal(*get_rpm_pool(p_impl->base), SOLVABLE_SUMMARY, *p_impl, cmp_type, patterns);
 }
 
 void PackageQuery::filter_url(const std::vector<std::string> & patterns, libdnf5::sack::QueryCmp cmp_type) {
-    filter_dataiterator_internal(*get_rpm_pool(p_impl->base), SOLVABLE_URL, *p_impl, cmp_type, patterns);
+    PQImpl::filter_dataiterator_internal(*get_rpm_pool(p_impl->base), SOLVABLE_URL, *p_impl, cmp_type, patterns);
 }
 
 void PackageQuery::filter_location(const std::vector<std::string> & patterns, libdnf5::sack::QueryCmp cmp_type) {
@@ -1807,31 +1827,17 @@ void PackageQuery::PQImpl::filter_reldep(
 
     auto base = pkg_set.get_base();
     auto & pool = get_rpm_pool(base);
+    auto & sack = *base->get_rpm_package_sack()->p_impl;
 
-    base->get_rpm_package_sack()->p_impl->make_provides_ready();
+    sack.make_provides_ready();
 
     libdnf5::solv::SolvMap filter_result(pool.get_nsolvables());
 
-    libdnf5::solv::IdQueue out;
-
+    // The packages with a dependency provided by the package are looked up in the cached reverse dependency
+    // index instead of matching the dependencies of all packages in the pool for each package of the set.
     for (auto package_id : *package_set.p_impl) {
-        out.clear();
-
-        // queue_push2 because we are creating a selection, which contains pairs
-        // of <flags, Id>, SOLVER_SOOLVABLE_ALL is a special flag which includes
-        // all packages from specified pool, Id is ignored.
-        queue_push2(&out.get_queue(), SOLVER_SOLVABLE_ALL, 0);
-
-        int flags = 0;
-        flags |= SELECTION_FILTER | SELECTION_WITH_ALL;
-        selection_make_matchsolvable(*pool, &out.get_queue(), package_id, flags, libsolv_key, 0);
-
-        // Queue from selection_make_matchsolvable is a selection, which means
-        // it contains pairs <flags, Id>, flags refers to how was the Id
-        // matched, that is not important here, so skip it and iterate just
-        // over the Ids.
-        for (int j = 1; j < out.size(); j += 2) {
-            filter_result.add_unsafe(out[j]);
+        for (Id dependent_id : sack.get_reverse_dependencies(libsolv_key, package_id)) {
+            filter_result.add_unsafe(dependent_id);
         }
     }
 
@@ -1886,18 +1892,13 @@ void PackageQuery::PQImpl::filter_nevra(
     Id src = with_src ? 0 : pool.str2id("src", false);
 
     if (!name.empty()) {
-        auto & sorted_solvables = sack->p_impl->get_sorted_solvables();
-
         switch (name_cmp_type) {
             case libdnf5::sack::QueryCmp::EQ: {
                 Id name_id = pool.str2id(name_c_pattern, false);
                 if (name_id == 0) {
                     break;
                 }
-                auto low =
-                    std::lower_bound(sorted_solvables.begin(), sorted_solvables.end(), name_id, name_compare_lower_id);
-                while (low != sorted_solvables.end() && (*low)->name == name_id) {
-                    Id candidate_id = pool.solvable2id(*low);
+                for (Id candidate_id : sack->p_impl->get_sorted_solvables_by_name(name_id)) {
                     if (!is_valid_candidate(
                             pool,
                             candidate_id,
@@ -1914,11 +1915,9 @@ void PackageQuery::PQImpl::filter_nevra(
                             version_cmp_type,
                             release_cmp_type,
                             arch_cmp_type)) {
-                        ++low;
                         continue;
                     }
                     filter_result.add_unsafe(candidate_id);
-                    ++low;
                 }
             } break;
             case libdnf5::sack::QueryCmp::IEXACT: {
@@ -1933,7 +1932,7 @@ void PackageQuery::PQImpl::filter_nevra(
                     icase_name,
                     name_compare_icase_lower_id);
                 while (low != sorted_icase_solvables.end() && (*low).first == icase_name) {
-                    auto candidate_id = pool.solvable2id((*low).second);
+                    auto candidate_id = (*low).second;
                     if (!is_valid_candidate(
                             pool,
                             candidate_id,
@@ -1989,12 +1988,11 @@ void PackageQuery::PQImpl::filter_nevra(
                 auto & sorted_icase_solvables = sack->p_impl->get_sorted_icase_solvables();
                 auto icase_name = libdnf5::utils::to_lowercase(name);
                 auto icase_name_cstring = icase_name.c_str();
-                for (auto const & [name_id, solvable] : sorted_icase_solvables) {
+                for (auto const & [name_id, candidate_id] : sorted_icase_solvables) {
                     auto candidate_name = pool.id2str(name_id);
                     if (!all_names && fnmatch(icase_name_cstring, candidate_name, 0) != 0) {
                         continue;
                     }
-                    Id candidate_id = pool.solvable2id(solvable);
                     if (!is_valid_candidate(
                             pool,
                             candidate_id,
@@ -2046,7 +2044,7 @@ void PackageQuery::PQImpl::filter_nevra(
 
 void PackageQuery::PQImpl::filter_nevra(
     PackageSet & pkg_set,
-    const std::vector<Solvable *> & sorted_solvables,
+    const std::vector<Id> & sorted_solvables,
     const std::string & pattern,
     bool cmp_glob,
     libdnf5::sack::QueryCmp cmp_type,
@@ -2066,12 +2064,16 @@ void PackageQuery::PQImpl::filter_nevra(
             if (!nevra_id.parse(pool, c_pattern, true)) {
                 return;
             }
-            auto low =
-                std::lower_bound(sorted_solvables.begin(), sorted_solvables.end(), nevra_id, nevra_compare_lower_id);
-            while (low != sorted_solvables.end() && (*low)->name == nevra_id.name && (*low)->arch == nevra_id.arch &&
-                   (*low)->evr == nevra_id.evr) {
-                filter_result.add_unsafe(pool.solvable2id(*low));
-                ++low;
+            auto sack = pkg_set.get_base()->get_rpm_package_sack();
+            auto same_name = sack->p_impl->get_sorted_solvables_by_name(nevra_id.name);
+            auto low = std::lower_bound(
+                same_name.begin(), same_name.end(), nevra_id, solvable_id_cmp(pool, nevra_compare_lower_id));
+            for (; low != same_name.end(); ++low) {
+                Solvable * solvable = pool.id2solvable(*low);
+                if (solvable->arch != nevra_id.arch || solvable->evr != nevra_id.evr) {
+                    break;
+                }
+                filter_result.add_unsafe(*low);
             }
         } break;
         case libdnf5::sack::QueryCmp::GT:
@@ -2142,12 +2144,15 @@ void PackageQuery::PQImpl::filter_sorted_advisory_pkgs(
                     sorted_solvables.begin(),
                     sorted_solvables.end(),
                     *(adv_pkg.p_impl.get()),
-                    libdnf5::advisory::AdvisoryPackage::Impl::nevra_compare_lower_solvable);
-                while (low != sorted_solvables.end() && (*low)->name == adv_pkg.p_impl.get()->get_name_id() &&
-                       (*low)->arch == adv_pkg.p_impl.get()->get_arch_id() &&
-                       (*low)->evr == adv_pkg.p_impl.get()->get_evr_id()) {
-                    filter_result.add_unsafe(pool.solvable2id(*low));
-                    ++low;
+                    solvable_id_cmp(pool, libdnf5::advisory::AdvisoryPackage::Impl::nevra_compare_lower_solvable));
+                for (; low != sorted_solvables.end(); ++low) {
+                    Solvable * solvable = pool.id2solvable(*low);
+                    if (solvable->name != adv_pkg.p_impl.get()->get_name_id() ||
+                        solvable->arch != adv_pkg.p_impl.get()->get_arch_id() ||
+                        solvable->evr != adv_pkg.p_impl.get()->get_evr_id()) {
+                        break;
+                    }
+                    filter_result.add_unsafe(*low);
                 }
             }
         } break;
@@ -2160,16 +2165,19 @@ void PackageQuery::PQImpl::filter_sorted_advisory_pkgs(
                     sorted_solvables.begin(),
                     sorted_solvables.end(),
                     *(adv_pkg.p_impl.get()),
-                    libdnf5::advisory::AdvisoryPackage::Impl::name_arch_compare_lower_solvable);
-                while (low != sorted_solvables.end() && (*low)->name == adv_pkg.p_impl.get()->get_name_id() &&
-                       (*low)->arch == adv_pkg.p_impl.get()->get_arch_id()) {
-                    int libsolv_cmp = pool.evrcmp((*low)->evr, adv_pkg.p_impl.get()->get_evr_id(), EVRCMP_COMPARE);
+                    solvable_id_cmp(pool, libdnf5::advisory::AdvisoryPackage::Impl::name_arch_compare_lower_solvable));
+                for (; low != sorted_solvables.end(); ++low) {
+                    Solvable * solvable = pool.id2solvable(*low);
+                    if (solvable->name != adv_pkg.p_impl.get()->get_name_id() ||
+                        solvable->arch != adv_pkg.p_impl.get()->get_arch_id()) {
+                        break;
+                    }
+                    int libsolv_cmp = pool.evrcmp(solvable->evr, adv_pkg.p_impl.get()->get_evr_id(), EVRCMP_COMPARE);
                     if (((libsolv_cmp > 0) && ((cmp_type & sack::QueryCmp::GT) == sack::QueryCmp::GT)) ||
                         ((libsolv_cmp < 0) && ((cmp_type & sack::QueryCmp::LT) == sack::QueryCmp::LT)) ||
                         ((libsolv_cmp == 0) && ((cmp_type & sack::QueryCmp::EQ) == sack::QueryCmp::EQ))) {
-                        filter_result.add_unsafe(pool.solvable2id(*low));
+                        filter_result.add_unsafe(*low);
                     }
-                    ++low;
                 }
             }
         } break;
@@ -2563,9 +2571,9 @@ static void add_block_to_map(
     }
 }
 
-static int latest_cmp(const Id * ap, const Id * bp, libdnf5::solv::RpmPool * pool) {
-    Solvable * sa = pool->id2solvable(*ap);
-    Solvable * sb = pool->id2solvable(*bp);
+static int latest_cmp(const Id * ap, const Id * bp, EvrRankCmpData * data) {
+    Solvable * sa = data->pool.id2solvable(*ap);
+    Solvable * sb = data->pool.id2solvable(*bp);
     int r;
     r = sa->name - sb->name;
     if (r)
@@ -2573,28 +2581,28 @@ static int latest_cmp(const Id * ap, const Id * bp, libdnf5::solv::RpmPool * poo
     r = sa->arch - sb->arch;
     if (r)
         return r;
-    r = pool->evrcmp(sb->evr, sa->evr, EVRCMP_COMPARE);
+    r = evr_rank_cmp(data->evr_ranks[static_cast<std::size_t>(*bp)], data->evr_ranks[static_cast<std::size_t>(*ap)]);
     if (r)
         return r;
     return *ap - *bp;
 }
 
-static int latest_ignore_arch_cmp(const Id * ap, const Id * bp, libdnf5::solv::RpmPool * pool) {
-    Solvable * sa = pool->id2solvable(*ap);
-    Solvable * sb = pool->id2solvable(*bp);
+static int latest_ignore_arch_cmp(const Id * ap, const Id * bp, EvrRankCmpData * data) {
+    Solvable * sa = data->pool.id2solvable(*ap);
+    Solvable * sb = data->pool.id2solvable(*bp);
     int r;
     r = sa->name - sb->name;
     if (r)
         return r;
-    r = pool->evrcmp(sb->evr, sa->evr, EVRCMP_COMPARE);
+    r = evr_rank_cmp(data->evr_ranks[static_cast<std::size_t>(*bp)], data->evr_ranks[static_cast<std::size_t>(*ap)]);
     if (r)
         return r;
     return *ap - *bp;
 }
 
-static int earliest_cmp(const Id * ap, const Id * bp, libdnf5::solv::RpmPool * pool) {
-    Solvable * sa = pool->id2solvable(*ap);
-    Solvable * sb = pool->id2solvable(*bp);
+static int earliest_cmp(const Id * ap, const Id * bp, EvrRankCmpData * data) {
+    Solvable * sa = data->pool.id2solvable(*ap);
+    Solvable * sb = data->pool.id2solvable(*bp);
     int r;
     r = sa->name - sb->name;
     if (r)
@@ -2602,40 +2610,38 @@ static int earliest_cmp(const Id * ap, const Id * bp, libdnf5::solv::RpmPool * p
     r = sa->arch - sb->arch;
     if (r)
         return r;
-    r = pool->evrcmp(sb->evr, sa->evr, EVRCMP_COMPARE);
-    if (r > 0)
-        return -1;
-    if (r < 0)
-        return 1;
+    r = evr_rank_cmp(data->evr_ranks[static_cast<std::size_t>(*ap)], data->evr_ranks[static_cast<std::size_t>(*bp)]);
+    if (r)
+        return r;
     return *ap - *bp;
 }
 
-static int earliest_ignore_arch_cmp(const Id * ap, const Id * bp, libdnf5::solv::RpmPool * pool) {
-    Solvable * sa = pool->id2solvable(*ap);
-    Solvable * sb = pool->id2solvable(*bp);
+static int earliest_ignore_arch_cmp(const Id * ap, const Id * bp, EvrRankCmpData * data) {
+    Solvable * sa = data->pool.id2solvable(*ap);
+    Solvable * sb = data->pool.id2solvable(*bp);
     int r;
     r = sa->name - sb->name;
     if (r)
         return r;
-    r = pool->evrcmp(sb->evr, sa->evr, EVRCMP_COMPARE);
-    if (r > 0)
-        return -1;
-    if (r < 0)
-        return 1;
+    r = evr_rank_cmp(data->evr_ranks[static_cast<std::size_t>(*ap)], data->evr_ranks[static_cast<std::size_t>(*bp)]);
+    if (r)
+        return r;
     return *ap - *bp;
 }
 
 static void filter_first_sorted_by(
     libdnf5::solv::RpmPool & pool,
+    const std::vector<unsigned int> & evr_ranks,
     int limit,
-    int (*cmp)(const Id * a, const Id * b, libdnf5::solv::RpmPool * pool),
+    int (*cmp)(const Id * a, const Id * b, EvrRankCmpData * data),
     libdnf5::solv::SolvMap & data,
     bool group_by_arch = true) {
+    EvrRankCmpData cmp_data{pool, evr_ranks};
     libdnf5::solv::IdQueue samename;
     for (Id candidate_id : data) {
         samename.push_back(candidate_id);
     }
-    samename.sort(cmp, &pool);
+    samename.sort(cmp, &cmp_data);
 
     data.clear();
     // Create blocks per name, arch
@@ -2662,19 +2668,23 @@ static void filter_first_sorted_by(
 }
 
 void PackageQuery::filter_latest_evr(int limit) {
-    filter_first_sorted_by(get_rpm_pool(p_impl->base), limit, latest_cmp, *p_impl);
+    auto & evr_ranks = p_impl->base->get_rpm_package_sack()->p_impl->get_evr_ranks();
+    filter_first_sorted_by(get_rpm_pool(p_impl->base), evr_ranks, limit, latest_cmp, *p_impl);
 }
 
 void PackageQuery::filter_latest_evr_any_arch(int limit) {
-    filter_first_sorted_by(get_rpm_pool(p_impl->base), limit, latest_ignore_arch_cmp, *p_impl, false);
+    auto & evr_ranks = p_impl->base->get_rpm_package_sack()->p_impl->get_evr_ranks();
+    filter_first_sorted_by(get_rpm_pool(p_impl->base), evr_ranks, limit, latest_ignore_arch_cmp, *p_impl, false);
 }
 
 void PackageQuery::filter_earliest_evr(int limit) {
-    filter_first_sorted_by(get_rpm_pool(p_impl->base), limit, earliest_cmp, *p_impl);
+    auto & evr_ranks = p_impl->base->get_rpm_package_sack()->p_impl->get_evr_ranks();
+    filter_first_sorted_by(get_rpm_pool(p_impl->base), evr_ranks, limit, earliest_cmp, *p_impl);
 }
 
 void PackageQuery::filter_earliest_evr_any_arch(int limit) {
-    filter_first_sorted_by(get_rpm_pool(p_impl->base), limit, earliest_ignore_arch_cmp, *p_impl, false);
+    auto & evr_ranks = p_impl->base->get_rpm_package_sack()->p_impl->get_evr_ranks();
+    filter_first_sorted_by(get_rpm_pool(p_impl->base), evr_ranks, limit, earliest_ignore_arch_cmp, *p_impl, false);
 }
 
 static inline bool priority_solvable_cmp_key(const Solvable * first, const Solvable * second) {
@@ -2849,11 +2859,12 @@ void PackageQuery::filter_duplicates() {
 
     filter_installed();
 
+    EvrRankCmpData cmp_data{pool, p_impl->base->get_rpm_package_sack()->p_impl->get_evr_ranks()};
     libdnf5::solv::IdQueue samename;
     for (Id candidate_id : *p_impl) {
         samename.push_back(candidate_id);
     }
-    samename.sort(latest_cmp, &pool);
+    samename.sort(latest_cmp, &cmp_data);
 
     p_impl->clear();
     // Create blocks per name, arch
@@ -2885,16 +2896,21 @@ std::vector<std::vector<Package>> PackageQuery::filter_leaves(bool return_groupe
     std::vector<std::vector<Package>> grouped_leaves;
     auto & pool = get_rpm_pool(p_impl->base);
 
-    // get array of all packages
+    // get array of all packages, sorted by their ids
     std::vector<Package> pkgs(begin(), end());
+    std::vector<Id> pkg_ids;
+    pkg_ids.reserve(pkgs.size());
+    for (const auto & package : pkgs) {
+        pkg_ids.push_back(package.get_id().id);
+    }
 
-    // build the directed graph of dependencies
+    // get the directed graph of dependencies, it is reused while the packages and their provides don't change
     bool use_recommends = p_impl->base->get_config().get_install_weak_deps_option().get_value();
-    auto graph = build_graph(*p_impl->base, *this, pkgs, use_recommends);
+    auto & package_sack = *p_impl->base->get_rpm_package_sack()->p_impl;
+    auto & graph = package_sack.get_dependency_graph(std::move(pkg_ids), use_recommends);
 
-    // run Kosaraju's algorithm to find strongly connected components
-    // without any incoming edges
-    auto leaves = kosaraju(graph);
+    // strongly connected components without any incoming edges
+    const auto & leaves = graph.get_leaves();
 
     libdnf5::solv::SolvMap filter_result(pool.get_nsolvables());
     if (return_grouped_leaves) {
@@ -2902,17 +2918,16 @@ std::vector<std::vector<Package>> PackageQuery::filter_leaves(bool return_groupe
         for (const auto & scc : leaves) {
             auto & group = grouped_leaves.emplace_back();
             group.reserve(scc.size());
-            for (unsigned int j = 0; j < scc.size(); ++j) {
-                const auto & package = pkgs[scc[j]];
+            for (auto node : scc) {
+                const auto & package = pkgs[node];
                 group.emplace_back(package);
                 filter_result.add_unsafe(package.get_id().id);
             }
         }
     } else {
         for (const auto & scc : leaves) {
-            for (unsigned int j = 0; j < scc.size(); ++j) {
-                const auto & package = pkgs[scc[j]];
-                filter_result.add_unsafe(package.get_id().id);
+            for (auto node : scc) {
+                filter_result.add_unsafe(pkgs[node].get_id().id);
             }
         }
     }
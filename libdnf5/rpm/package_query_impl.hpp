@@ -29,6 +29,7 @@ extern "C" {
 }
 
 #include <optional>
+#include <string_view>
 
 namespace libdnf5::rpm {
 
@@ -60,7 +61,7 @@ public:
         bool with_src);
     static void filter_nevra(
         PackageSet & pkg_set,
-        const std::vector<Solvable *> & sorted_solvables,
+        const std::vector<Id> & sorted_solvables,
         const std::string & pattern,
         bool cmp_glob,
         libdnf5::sack::QueryCmp cmp_type,
@@ -80,6 +81,19 @@ public:
 
     static void filter_unneeded(PackageSet & pkg_set, bool mark_protected_userinstalled);
 
+    /// Filters `candidates` by matching `keyname` strings of the packages using the libsolv dataiterator.
+    static void filter_dataiterator_internal(
+        Pool * pool,
+        Id keyname,
+        libdnf5::solv::SolvMap & candidates,
+        libdnf5::sack::QueryCmp cmp_type,
+        const std::vector<std::string> & patterns);
+
+    /// Removes candidates whose summary, description and url cannot contain `substring` (ignoring case)
+    /// according to the search indexes of the repositories.
+    static void filter_search_index_candidates(
+        Pool * pool, std::string_view substring, libdnf5::solv::SolvMap & candidates);
+
 private:
     friend PackageQuery;
     ExcludeFlags flags;
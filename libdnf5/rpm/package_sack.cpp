@@ -21,6 +21,7 @@
 #include "package_sack_impl.hpp"
 #include "package_set_impl.hpp"
 #include "repo/solv_repo.hpp"
+#include "rpm_log_guard.hpp"
 #include "solv/id_queue.hpp"
 #include "solv/solv_map.hpp"
 
@@ -29,6 +30,9 @@
 #include "libdnf5/rpm/package_query.hpp"
 #include "libdnf5/rpm/versionlock_config.hpp"
 
+#include <rpm/rpmdb.h>
+#include <rpm/rpmtd.h>
+#include <rpm/rpmts.h>
 #include <sys/utsname.h>
 
 extern "C" {
@@ -38,6 +42,7 @@ extern "C" {
 #include <solv/repo_rpmmd.h>
 #include <solv/repo_solv.h>
 #include <solv/repo_write.h>
+#include <solv/selection.h>
 #include <solv/solver.h>
 #include <solv/testcase.h>
 }
@@ -88,6 +93,178 @@ void PackageSack::Impl::make_provides_ready() {
     get_rpm_pool(base).swap_considered_map(original_considered_map);
 }
 
+/// Appends the dependencies of `dep` matched against the providers to `components`. The operands of boolean (rich)
+/// dependencies are matched separately, e.g. a package with "Supplements: (glibc and langpacks-en)" is a reverse
+/// dependency of the providers of "glibc" as well as of the providers of "langpacks-en".
+static void add_dep_components(::Pool * pool, Id dep, libdnf5::solv::IdQueue & components) {
+    if (ISRELDEP(dep)) {
+        Reldep * reldep = GETRELDEP(pool, dep);
+        switch (reldep->flags) {
+            case REL_AND:
+            case REL_OR:
+            case REL_WITH:
+            case REL_WITHOUT:
+            case REL_COND:
+            case REL_UNLESS:
+            case REL_ELSE:
+                add_dep_components(pool, reldep->name, components);
+                add_dep_components(pool, reldep->evr, components);
+                return;
+            default:
+                break;
+        }
+    }
+    components.push_back(dep);
+}
+
+std::span<const Id> PackageSack::Impl::get_reverse_dependencies(Id libsolv_key, Id provider_id) {
+    auto & spool = get_rpm_pool(base);
+    ::Pool * pool = *spool;
+    auto [it, inserted] = cached_reverse_dependencies.try_emplace(libsolv_key);
+    auto & index = it->second;
+    if (inserted) {
+        const auto nsolvables = static_cast<std::size_t>(pool->nsolvables);
+
+        // Collect <provider, dependent> edges. The dependents are visited in ascending order, so remembering
+        // the last dependent of each provider is enough to skip packages with several deps on the same provider.
+        std::vector<std::pair<Id, Id>> edges;
+        std::vector<Id> last_dependent(nsolvables, 0);
+        libdnf5::solv::IdQueue deps;
+        libdnf5::solv::IdQueue components;
+        Id provider;
+        Id pp;
+        for (Id dependent_id : get_solvables()) {
+            deps.clear();
+            solvable_lookup_idarray(spool.id2solvable(dependent_id), libsolv_key, &deps.get_queue());
+            for (Id dep : deps) {
+                if (dep == SOLVABLE_PREREQMARKER || dep == SOLVABLE_FILEMARKER) {
+                    continue;
+                }
+                components.clear();
+                add_dep_components(pool, dep, components);
+                for (Id component : components) {
+                    FOR_PROVIDES(provider, pp, component) {
+                        if (last_dependent[static_cast<std::size_t>(provider)] != dependent_id) {
+                            last_dependent[static_cast<std::size_t>(provider)] = dependent_id;
+                            edges.emplace_back(provider, dependent_id);
+                        }
+                    }
+                }
+            }
+        }
+
+        // Counting sort of the edges by the provider, it keeps the dependents of each provider sorted
+        index.offsets.assign(nsolvables + 1, 0);
+        for (const auto & edge : edges) {
+            ++index.offsets[static_cast<std::size_t>(edge.first) + 1];
+        }
+        for (std::size_t id = 1; id <= nsolvables; ++id) {
+            index.offsets[id] += index.offsets[id - 1];
+        }
+        index.dependents.resize(edges.size());
+        std::vector<std::size_t> next_dependent(index.offsets.begin(), index.offsets.end() - 1);
+        for (const auto & [edge_provider, edge_dependent] : edges) {
+            index.dependents[next_dependent[static_cast<std::size_t>(edge_provider)]++] = edge_dependent;
+        }
+    }
+
+    const auto id = static_cast<std::size_t>(provider_id);
+    if (provider_id <= 0 || id + 1 >= index.offsets.size()) {
+        return {};
+    }
+
+    // The index is built from whatprovides, which leaves out e.g. the source packages. The dependents of such
+    // providers are matched by libsolv and kept with the index.
+    if (!pool_installable_whatprovides(pool, spool.id2solvable(provider_id))) {
+        auto [dependents_it, dependents_inserted] = index.unindexed_dependents.try_emplace(provider_id);
+        if (dependents_inserted) {
+            libdnf5::solv::IdQueue selection;
+            // a selection of pairs <flags, Id>, SOLVER_SOLVABLE_ALL includes all packages from the pool
+            queue_push2(&selection.get_queue(), SOLVER_SOLVABLE_ALL, 0);
+            selection_make_matchsolvable(
+                pool, &selection.get_queue(), provider_id, SELECTION_FILTER | SELECTION_WITH_ALL, libsolv_key, 0);
+            for (int idx = 1; idx < selection.size(); idx += 2) {
+                dependents_it->second.push_back(selection[idx]);
+            }
+        }
+        return dependents_it->second;
+    }
+
+    return std::span<const Id>(index.dependents).subspan(index.offsets[id], index.offsets[id + 1] - index.offsets[id]);
+}
+
+const std::vector<unsigned int> & PackageSack::Impl::get_evr_ranks() {
+    auto state = get_solvables_state();
+    if (state == cached_evr_ranks_state) {
+        return cached_evr_ranks;
+    }
+    auto & pool = get_rpm_pool(base);
+    Id first_new_id = get_first_new_solvable_id(cached_evr_ranks_state);
+    if (first_new_id == 0) {
+        cached_evr_ranks.clear();
+    }
+    cached_evr_ranks.resize(static_cast<std::size_t>(state.nsolvables), 0);
+
+    // Only the names of the package solvables added within the same generation of the pool solvables are ranked,
+    // the ranks of other names do not change
+    std::vector<Id> names;
+    auto & solvables_map = get_solvables();
+    auto it = solvables_map.begin();
+    it.jump(first_new_id);
+    for (; it != solvables_map.end(); ++it) {
+        names.push_back(pool.id2solvable(*it)->name);
+    }
+    std::sort(names.begin(), names.end());
+    names.erase(std::unique(names.begin(), names.end()), names.end());
+
+    auto evr_less = [&pool](Id evr1, Id evr2) { return pool.evrcmp(evr1, evr2, EVRCMP_COMPARE) < 0; };
+    auto evr_id_less = [](const std::pair<Id, unsigned int> & item, Id evr) { return item.first < evr; };
+
+    std::vector<Id> evrs;
+    // pair<evr Id, rank> sorted by the evr Id
+    std::vector<std::pair<Id, unsigned int>> evr_ranks;
+    for (Id name : names) {
+        auto same_name = get_sorted_solvables_by_name(name);
+
+        evrs.clear();
+        for (Id solvable_id : same_name) {
+            evrs.push_back(pool.id2solvable(solvable_id)->evr);
+        }
+        std::sort(evrs.begin(), evrs.end());
+        evrs.erase(std::unique(evrs.begin(), evrs.end()), evrs.end());
+        std::sort(evrs.begin(), evrs.end(), evr_less);
+
+        evr_ranks.clear();
+        unsigned int rank = 0;
+        for (std::size_t idx = 0; idx < evrs.size(); ++idx) {
+            if (idx > 0 && pool.evrcmp(evrs[idx - 1], evrs[idx], EVRCMP_COMPARE) != 0) {
+                ++rank;
+            }
+            evr_ranks.emplace_back(evrs[idx], rank);
+        }
+        std::sort(evr_ranks.begin(), evr_ranks.end());
+
+        for (Id solvable_id : same_name) {
+            auto evr = pool.id2solvable(solvable_id)->evr;
+            auto evr_rank = std::lower_bound(evr_ranks.begin(), evr_ranks.end(), evr, evr_id_less);
+            cached_evr_ranks[static_cast<std::size_t>(solvable_id)] = evr_rank->second;
+        }
+    }
+
+    cached_evr_ranks_state = state;
+    return cached_evr_ranks;
+}
+
+DependencyGraph & PackageSack::Impl::get_dependency_graph(std::vector<Id> packages, bool use_recommends) {
+    make_provides_ready();
+    if (!cached_dependency_graph || cached_dependency_graph->get_use_recommends() != use_recommends ||
+        cached_dependency_graph->get_packages() != packages) {
+        cached_dependency_graph =
+            std::make_unique<DependencyGraph>(get_rpm_pool(base), std::move(packages), use_recommends);
+    }
+    return *cached_dependency_graph;
+}
+
 void PackageSack::Impl::load_versionlock_excludes() {
     PackageSet locked_set(base);
     PackageQuery base_query(base, PackageQuery::ExcludeFlags::IGNORE_EXCLUDES);
@@ -637,4 +814,48 @@ rpm::Package PackageSack::get_running_kernel() {
     return rpm::Package(p_impl->base, p_impl->get_running_kernel_id());
 }
 
+void PackageSack::Impl::RpmTransactionDeleter::operator()(rpmts_s * ts) const noexcept {
+    rpmtsFree(ts);
+}
+
+std::vector<Changelog> PackageSack::Impl::read_installed_changelogs(unsigned int rpmdb_id) {
+    std::vector<Changelog> changelogs;
+
+    std::lock_guard<std::mutex> lock(installed_changelogs_mutex);
+    libdnf5::rpm::RpmLogGuard rpm_log_guard(base);
+
+    if (!installed_changelogs_ts) {
+        installed_changelogs_ts.reset(rpmtsCreate());
+        // The installroot option is locked when the system repo is loaded, the root of the transaction stays valid
+        rpmtsSetRootDir(
+            installed_changelogs_ts.get(), base->get_config().get_installroot_option().get_value().c_str());
+        // Installed headers were verified when they were written to the rpm database
+        rpmtsSetVSFlags(
+            installed_changelogs_ts.get(),
+            rpmtsVSFlags(installed_changelogs_ts.get()) | _RPMVSF_NODIGESTS | _RPMVSF_NOSIGNATURES);
+    }
+
+    auto * mi = rpmtsInitIterator(installed_changelogs_ts.get(), RPMDBI_PACKAGES, &rpmdb_id, sizeof(rpmdb_id));
+    if (auto hdr = rpmdbNextIterator(mi)) {
+        rpmtd times = rpmtdNew();
+        rpmtd names = rpmtdNew();
+        rpmtd texts = rpmtdNew();
+        if (headerGet(hdr, RPMTAG_CHANGELOGTIME, times, HEADERGET_MINMEM) != 0 &&
+            headerGet(hdr, RPMTAG_CHANGELOGNAME, names, HEADERGET_MINMEM) != 0 &&
+            headerGet(hdr, RPMTAG_CHANGELOGTEXT, texts, HEADERGET_MINMEM) != 0) {
+            while (rpmtdNext(times) >= 0 && rpmtdNext(names) >= 0 && rpmtdNext(texts) >= 0) {
+                changelogs.emplace_back(
+                    static_cast<time_t>(*rpmtdGetUint32(times)), rpmtdGetString(names), rpmtdGetString(texts));
+            }
+        }
+        for (auto td : {times, names, texts}) {
+            rpmtdFreeData(td);
+            rpmtdFree(td);
+        }
+    }
+    rpmdbFreeIterator(mi);
+
+    return changelogs;
+}
+
 }  // namespace libdnf5::rpm
@@ -20,6 +20,8 @@
 #ifndef LIBDNF5_RPM_PACKAGE_SACK_IMPL_HPP
 #define LIBDNF5_RPM_PACKAGE_SACK_IMPL_HPP
 
+#include "dependency_graph.hpp"
+#include "evr_cmp_cache.hpp"
 #include "solv/id_queue.hpp"
 #include "solv/pool.hpp"
 #include "solv/solv_map.hpp"
@@ -32,7 +34,14 @@ extern "C" {
 #include <solv/pool.h>
 }
 
+struct rpmts_s;
+
+#include <algorithm>
+#include <memory>
+#include <mutex>
 #include <optional>
+#include <span>
+#include <unordered_map>
 #include <vector>
 
 
@@ -46,19 +55,49 @@ static inline bool nevra_solvable_cmp_key(const Solvable * first, const Solvable
     return first->evr < second->evr;
 }
 
-static inline bool nevra_solvable_cmp_icase_key(
-    const std::pair<Id, Solvable *> & first, const std::pair<Id, Solvable *> & second) {
-    if (first.first != second.first) {
-        return first.first < second.first;
+namespace libdnf5::rpm {
+
+/// Orders package solvable Ids by `nevra_solvable_cmp_key()` of their solvables.
+/// The solvables are looked up on each comparison, libsolv reallocates them when the pool grows.
+struct NevraSolvableIdCmp {
+    const ::Pool * pool;
+
+    bool operator()(Id first, Id second) const {
+        return nevra_solvable_cmp_key(pool->solvables + first, pool->solvables + second);
     }
+};
+
+/// Orders pair<id_of_lowercase_name, solvable Id> by the lowercase name, arch and evr.
+struct NevraSolvableIdIcaseCmp {
+    const ::Pool * pool;
 
-    if (first.second->arch != second.second->arch) {
-        return first.second->arch < second.second->arch;
+    bool operator()(const std::pair<Id, Id> & first, const std::pair<Id, Id> & second) const {
+        if (first.first != second.first) {
+            return first.first < second.first;
+        }
+        const Solvable * first_solvable = pool->solvables + first.second;
+        const Solvable * second_solvable = pool->solvables + second.second;
+        if (first_solvable->arch != second_solvable->arch) {
+            return first_solvable->arch < second_solvable->arch;
+        }
+        return first_solvable->evr < second_solvable->evr;
     }
-    return first.second->evr < second.second->evr;
+};
+
+/// Adapts the comparator `cmp` of a solvable and a value to the solvable Ids of the sorted package solvable lists,
+/// e.g. for `std::lower_bound()`.
+template <typename Cmp>
+inline auto solvable_id_cmp(const libdnf5::solv::RpmPool & pool, Cmp cmp) {
+    return [&pool, cmp](Id solvable_id, const auto & value) { return cmp(pool.id2solvable(solvable_id), value); };
 }
 
-namespace libdnf5::rpm {
+/// State of the pool solvables the cached data of package solvables were computed for
+struct SolvablesState {
+    int nsolvables{0};
+    unsigned int generation{0};
+
+    bool operator==(const SolvablesState & other) const noexcept = default;
+};
 
 class PackageSack::Impl {
 public:
@@ -67,21 +106,69 @@ public:
     /// Return number of solvables in pool
     int get_nsolvables() const noexcept { return get_rpm_pool(base)->nsolvables; };
 
+    /// Return the current state of the pool solvables
+    SolvablesState get_solvables_state() const noexcept {
+        auto & pool = get_rpm_pool(base);
+        return {pool.get_nsolvables(), pool.get_solvables_generation()};
+    }
+
+    /// Return the Id of the first solvable missing in data computed for the `cached` state of the pool solvables.
+    /// Return 0 when the data must be computed from scratch, the solvables were freed since.
+    Id get_first_new_solvable_id(const SolvablesState & cached) const noexcept {
+        auto current = get_solvables_state();
+        if (cached.generation != current.generation || cached.nsolvables > current.nsolvables) {
+            return 0;
+        }
+        return cached.nsolvables;
+    }
+
     /// Return SolvMap with all package solvables
     libdnf5::solv::SolvMap & get_solvables();
 
-    /// Return sorted list of all package solvables
-    std::vector<Solvable *> & get_sorted_solvables();
+    /// Return Ids of all package solvables sorted by `NevraSolvableIdCmp`
+    std::vector<Id> & get_sorted_solvables();
+
+    /// Return the range of `get_sorted_solvables()` with the package solvables named `name_id`.
+    /// The range is found in a hash index from the name Id, which is built once per pool state.
+    std::span<const Id> get_sorted_solvables_by_name(Id name_id);
+
+    /// Return the EVR ranks of package solvables indexed by the solvable Id.
+    /// The rank orders the EVRs of the packages with the same name, a higher rank is a newer EVR and the packages
+    /// with equal EVRs have the same rank. Ranks of packages with different names are not comparable.
+    /// The ranks of a name are computed with `evrcmp` once per state of the pool solvables, see `SolvablesState`.
+    const std::vector<unsigned int> & get_evr_ranks();
+
+    /// Return the memoized comparisons of package EVRs with the patterns of the EVR, version and release filters.
+    EvrCmpCache & get_evr_cmp_cache() noexcept { return evr_cmp_cache; }
 
-    /// Return sorted list of all package solvables in format pair<id_of_lowercase_name, Solvable *>
-    std::vector<std::pair<Id, Solvable *>> & get_sorted_icase_solvables();
+    /// Return sorted list of all package solvables in format pair<id_of_lowercase_name, solvable Id>
+    std::vector<std::pair<Id, Id>> & get_sorted_icase_solvables();
 
     void make_provides_ready();
 
-    void invalidate_provides() { provides_ready = false; }
+    void invalidate_provides() {
+        provides_ready = false;
+        cached_reverse_dependencies.clear();
+        cached_dependency_graph.reset();
+    }
+
+    /// Return the dependency graph of `packages` (sorted package solvable ids) used for computing leaves.
+    /// The graph of the last requested packages is cached until the provides are invalidated.
+    DependencyGraph & get_dependency_graph(std::vector<Id> packages, bool use_recommends);
+
+    /// Return the package solvables with a `libsolv_key` dependency (e.g. SOLVABLE_REQUIRES) provided by `provider_id`.
+    /// The operands of boolean dependencies are matched separately, a dependent of any of them is returned.
+    /// The reverse dependency index of `libsolv_key` is built for all package solvables on the first call and kept
+    /// until the provides are invalidated. The provides must be ready.
+    std::span<const Id> get_reverse_dependencies(Id libsolv_key, Id provider_id);
 
     PackageId get_running_kernel_id();
 
+    /// Reads changelogs of the installed package with `rpmdb_id` from the rpm database in the installroot.
+    /// The installed packages are loaded into the pool without changelogs, they are read only on demand.
+    /// All reads share one rpm transaction, the rpm database is opened only by the first one.
+    std::vector<Changelog> read_installed_changelogs(unsigned int rpmdb_id);
+
     /// Sets excluded and included packages according to the configuration.
     ///
     /// Uses the `disable_excludes`, `excludepkgs`, and `includepkgs` configuration options to calculate the `config_includes` and `config_excludes` sets.
@@ -152,15 +239,41 @@ private:
 
     bool considered_uptodate = true;
 
-    std::vector<Solvable *> cached_sorted_solvables;
-    int cached_sorted_solvables_size{0};
-    /// pair<id_of_lowercase_name, Solvable *>
-    std::vector<std::pair<Id, Solvable *>> cached_sorted_icase_solvables;
-    int cached_sorted_icase_solvables_size{0};
+    std::vector<Id> cached_sorted_solvables;
+    SolvablesState cached_sorted_solvables_state;
+    /// pair<id_of_lowercase_name, solvable Id>
+    std::vector<std::pair<Id, Id>> cached_sorted_icase_solvables;
+    SolvablesState cached_sorted_icase_solvables_state;
+    /// name Id -> <first index, end index> of the solvables with the name in cached_sorted_solvables
+    std::unordered_map<Id, std::pair<std::size_t, std::size_t>> cached_name_index;
+    SolvablesState cached_name_index_state;
     libdnf5::solv::SolvMap cached_solvables{0};
-    int cached_solvables_size{0};
+    SolvablesState cached_solvables_state;
+    /// solvable Id -> rank of its EVR among the EVRs of the packages with the same name
+    std::vector<unsigned int> cached_evr_ranks;
+    SolvablesState cached_evr_ranks_state;
+    EvrCmpCache evr_cmp_cache;
+    /// Reverse dependency index of one dependency key, the dependents of the provider `id` are
+    /// `dependents[offsets[id]]` to `dependents[offsets[id + 1]]` in ascending order.
+    /// The dependents of the providers left out of whatprovides are matched on demand, see `unindexed_dependents`.
+    struct ReverseDependencies {
+        std::vector<std::size_t> offsets;
+        std::vector<Id> dependents;
+        /// provider Id -> dependents of a provider left out of whatprovides (e.g. a source package)
+        std::unordered_map<Id, std::vector<Id>> unindexed_dependents;
+    };
+    /// libsolv dependency key -> reverse dependency index, valid until the provides are invalidated
+    std::unordered_map<Id, ReverseDependencies> cached_reverse_dependencies;
+    std::unique_ptr<DependencyGraph> cached_dependency_graph;
     PackageId running_kernel;
 
+    struct RpmTransactionDeleter {
+        void operator()(rpmts_s * ts) const noexcept;
+    };
+    /// rpm transaction with the opened installroot rpm database used by `read_installed_changelogs()`
+    std::unique_ptr<rpmts_s, RpmTransactionDeleter> installed_changelogs_ts;
+    std::mutex installed_changelogs_mutex;
+
     friend PackageSack;
     friend Package;
     friend PackageSet;
@@ -170,39 +283,99 @@ private:
     friend class Transaction;
 };
 
-inline std::vector<Solvable *> & PackageSack::Impl::get_sorted_solvables() {
-    auto nsolvables = get_nsolvables();
-    if (nsolvables == cached_sorted_solvables_size) {
+// Solvables are appended to the pool, the freed ones start a new generation of the pool solvables
+// (e.g. a repository reloaded from a freshly written solv cache). Therefore, when the number of solvables
+// has grown within the generation the cached data were computed for, only the new solvables are processed
+// and merged into the cached data. Otherwise, the cached data are recomputed from scratch.
+// The cached data hold solvable Ids, libsolv reallocates the solvables when the pool grows.
+
+inline std::vector<Id> & PackageSack::Impl::get_sorted_solvables() {
+    auto state = get_solvables_state();
+    if (state == cached_sorted_solvables_state) {
         return cached_sorted_solvables;
     }
     auto & solvables_map = get_solvables();
-    cached_sorted_solvables.clear();
-    cached_sorted_solvables.reserve(static_cast<size_t>(nsolvables));
-    auto & pool = get_rpm_pool(base);
-    for (Id id : solvables_map) {
-        cached_sorted_solvables.push_back(pool.id2solvable(id));
+    Id first_new_id = get_first_new_solvable_id(cached_sorted_solvables_state);
+    if (first_new_id == 0) {
+        cached_sorted_solvables.clear();
+    }
+    const auto sorted_count = static_cast<std::ptrdiff_t>(cached_sorted_solvables.size());
+    cached_sorted_solvables.reserve(static_cast<size_t>(state.nsolvables));
+    auto it = solvables_map.begin();
+    it.jump(first_new_id);
+    for (; it != solvables_map.end(); ++it) {
+        cached_sorted_solvables.push_back(*it);
     }
-    std::sort(cached_sorted_solvables.begin(), cached_sorted_solvables.end(), nevra_solvable_cmp_key);
-    cached_sorted_solvables_size = nsolvables;
+    NevraSolvableIdCmp cmp{*get_rpm_pool(base)};
+    auto first_new = cached_sorted_solvables.begin() + sorted_count;
+    std::sort(first_new, cached_sorted_solvables.end(), cmp);
+    std::inplace_merge(cached_sorted_solvables.begin(), first_new, cached_sorted_solvables.end(), cmp);
+    cached_sorted_solvables_state = state;
     return cached_sorted_solvables;
 }
 
-inline std::vector<std::pair<Id, Solvable *>> & PackageSack::Impl::get_sorted_icase_solvables() {
+inline std::span<const Id> PackageSack::Impl::get_sorted_solvables_by_name(Id name_id) {
+    auto & sorted_solvables = get_sorted_solvables();
+    auto & pool = get_rpm_pool(base);
+    auto state = get_solvables_state();
+    if (state != cached_name_index_state) {
+        cached_name_index.clear();
+        std::size_t first = 0;
+        for (std::size_t idx = 1; idx <= sorted_solvables.size(); ++idx) {
+            Id first_name = pool.id2solvable(sorted_solvables[first])->name;
+            if (idx == sorted_solvables.size() || pool.id2solvable(sorted_solvables[idx])->name != first_name) {
+                cached_name_index.emplace(first_name, std::make_pair(first, idx));
+                first = idx;
+            }
+        }
+        cached_name_index_state = state;
+    }
+
+    auto it = cached_name_index.find(name_id);
+    if (it == cached_name_index.end()) {
+        return {};
+    }
+    auto [first, end] = it->second;
+    return std::span<const Id>(sorted_solvables).subspan(first, end - first);
+}
+
+inline std::vector<std::pair<Id, Id>> & PackageSack::Impl::get_sorted_icase_solvables() {
     auto & pool = get_rpm_pool(base);
-    auto nsolvables = get_nsolvables();
-    if (nsolvables == cached_sorted_icase_solvables_size) {
+    auto state = get_solvables_state();
+    if (state == cached_sorted_icase_solvables_state) {
         return cached_sorted_icase_solvables;
     }
+    auto & solvables_map = get_solvables();
+    Id first_new_id = get_first_new_solvable_id(cached_sorted_icase_solvables_state);
+    if (first_new_id == 0) {
+        cached_sorted_icase_solvables.clear();
+    }
+    // Group the new solvables by name so that the lowercase name is computed only once per name
+    std::vector<Id> new_solvables;
+    auto it = solvables_map.begin();
+    it.jump(first_new_id);
+    for (; it != solvables_map.end(); ++it) {
+        new_solvables.push_back(*it);
+    }
+    std::sort(new_solvables.begin(), new_solvables.end(), NevraSolvableIdCmp{*pool});
+
+    const auto sorted_count = static_cast<std::ptrdiff_t>(cached_sorted_icase_solvables.size());
+    cached_sorted_icase_solvables.reserve(cached_sorted_icase_solvables.size() + new_solvables.size());
     Id name = 0;
     Id icase_name = 0;
-    for (auto * solvable : get_sorted_solvables()) {
-        if (solvable->name != name) {
-            icase_name = pool.id_to_lowercase_id(solvable->name, 1);
+    for (Id solvable_id : new_solvables) {
+        Id solvable_name = pool.id2solvable(solvable_id)->name;
+        if (solvable_name != name) {
+            name = solvable_name;
+            icase_name = pool.id_to_lowercase_id(solvable_name, 1);
         }
-        cached_sorted_icase_solvables.emplace_back(std::make_pair(icase_name, solvable));
+        cached_sorted_icase_solvables.emplace_back(icase_name, solvable_id);
     }
-    std::sort(cached_sorted_icase_solvables.begin(), cached_sorted_icase_solvables.end(), nevra_solvable_cmp_icase_key);
-    cached_sorted_icase_solvables_size = nsolvables;
+    NevraSolvableIdIcaseCmp cmp{*pool};
+    auto first_new = cached_sorted_icase_solvables.begin() + sorted_count;
+    std::sort(first_new, cached_sorted_icase_solvables.end(), cmp);
+    std::inplace_merge(cached_sorted_icase_solvables.begin(), first_new, cached_sorted_icase_solvables.end(), cmp);
+    cached_sorted_icase_solvables_state = state;
     return cached_sorted_icase_solvables;
 }
 
@@ -210,24 +383,30 @@ inline libdnf5::solv::SolvMap & PackageSack::Impl::get_solvables() {
     auto & spool = get_rpm_pool(base);
     ::Pool * pool = *spool;
 
-    auto nsolvables = get_nsolvables();
-    if (nsolvables == cached_solvables_size) {
+    auto state = get_solvables_state();
+    if (state == cached_solvables_state) {
         return cached_solvables;
     }
-    if (nsolvables > cached_solvables.allocated_size()) {
+    auto nsolvables = state.nsolvables;
+    Id first_new_id = get_first_new_solvable_id(cached_solvables_state);
+    if (first_new_id > 2) {
+        if (nsolvables > cached_solvables.allocated_size()) {
+            cached_solvables.grow(nsolvables);
+        }
+    } else if (nsolvables > cached_solvables.allocated_size()) {
         cached_solvables = libdnf5::solv::SolvMap(nsolvables);
     } else {
         cached_solvables.clear();
     }
-    Id solvable_id;
+    first_new_id = std::max(first_new_id, 2);  // the first two solvables are reserved by libsolv
 
-    // loop over all package solvables
-    FOR_POOL_SOLVABLES(solvable_id) {
-        if (spool.is_package(solvable_id)) {
+    // loop over new package solvables, skip the freed ones the same way FOR_POOL_SOLVABLES does
+    for (Id solvable_id = first_new_id; solvable_id < pool->nsolvables; ++solvable_id) {
+        if (pool->solvables[solvable_id].repo && spool.is_package(solvable_id)) {
             cached_solvables.add_unsafe(solvable_id);
         }
     }
-    cached_solvables_size = nsolvables;
+    cached_solvables_state = state;
     return cached_solvables;
 }
 
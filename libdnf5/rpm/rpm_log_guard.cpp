@@ -24,7 +24,40 @@
 
 namespace libdnf5::rpm {
 
-std::mutex RpmLogGuardBase::rpm_log_mutex;
+void RpmLogMutex::lock() {
+    std::unique_lock<std::mutex> lock(mutex);
+    ++exclusive_waiting;
+    cv.wait(lock, [this] { return !exclusive && shared_count == 0; });
+    --exclusive_waiting;
+    exclusive = true;
+}
+
+void RpmLogMutex::unlock() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        exclusive = false;
+    }
+    cv.notify_all();
+}
+
+void RpmLogMutex::lock_shared() {
+    std::unique_lock<std::mutex> lock(mutex);
+    cv.wait(lock, [this] { return !exclusive && exclusive_waiting == 0; });
+    ++shared_count;
+}
+
+void RpmLogMutex::unlock_shared() {
+    bool last;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        last = --shared_count == 0;
+    }
+    if (last) {
+        cv.notify_all();
+    }
+}
+
+RpmLogMutex RpmLogGuardBase::rpm_log_mutex;
 
 static int rpmlog_callback(rpmlogRec rec, rpmlogCallbackData data) {
     Logger::Level level = Logger::Level::DEBUG;  // default for the case of an unknown value below
@@ -118,4 +151,47 @@ RpmLogGuardStrings::RpmLogGuardStrings() : RpmLogGuardBase() {
     rpmlogSetCallback(&rpmlog_callback_strings, this);
 }
 
+static thread_local std::vector<std::string> * thread_rpm_logs{nullptr};
+
+static int rpmlog_callback_thread_strings(rpmlogRec rec, [[maybe_unused]] rpmlogCallbackData data) {
+    if (!thread_rpm_logs) {
+        return 0;
+    }
+
+    std::string msg(rpmlogRecMessage(rec));
+    if (!msg.empty() && msg[msg.length() - 1] == '\n') {
+        msg.pop_back();
+    }
+
+    thread_rpm_logs->push_back(std::move(msg));
+    return 0;
+}
+
+// The callback and the log mask are shared by all RpmLogGuardThreadStrings guards,
+// the first guard installs them and the last one resets them.
+static std::mutex thread_guards_mutex;
+static std::size_t thread_guards_count{0};
+static int thread_guards_old_log_mask{0};
+
+RpmLogGuardThreadStrings::RpmLogGuardThreadStrings(std::vector<std::string> & rpm_logs)
+    : rpm_log_mutex_lock(RpmLogGuardBase::rpm_log_mutex) {
+    {
+        std::lock_guard<std::mutex> lock(thread_guards_mutex);
+        if (thread_guards_count++ == 0) {
+            rpmlogSetCallback(&rpmlog_callback_thread_strings, nullptr);
+            thread_guards_old_log_mask = rpmlogSetMask(RPMLOG_UPTO(RPMLOG_PRI(RPMLOG_INFO)));
+        }
+    }
+    thread_rpm_logs = &rpm_logs;
+}
+
+RpmLogGuardThreadStrings::~RpmLogGuardThreadStrings() {
+    thread_rpm_logs = nullptr;
+    std::lock_guard<std::mutex> lock(thread_guards_mutex);
+    if (--thread_guards_count == 0) {
+        rpmlogSetCallback(nullptr, nullptr);
+        rpmlogSetMask(thread_guards_old_log_mask);
+    }
+}
+
 }  // namespace libdnf5::rpm
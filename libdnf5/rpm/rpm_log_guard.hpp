@@ -23,19 +23,46 @@
 #include "libdnf5/base/base.hpp"
 #include "libdnf5/logger/logger.hpp"
 
+#include <condition_variable>
+#include <cstddef>
 #include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <vector>
 
 
 namespace libdnf5::rpm {
 
+/// Guards the process-wide rpm log callback and log mask.
+/// The exclusive lock is taken by guards that install their own callback. The shared lock is taken by
+/// RpmLogGuardThreadStrings guards that all use the same callback and can run in parallel.
+/// Waiting exclusive lockers take precedence over new shared lockers, so a thread that needs to set its own
+/// callback is not starved by threads that keep verifying signatures.
+class RpmLogMutex {
+public:
+    void lock();
+    void unlock();
+    void lock_shared();
+    void unlock_shared();
+
+private:
+    std::mutex mutex;
+    std::condition_variable cv;
+    std::size_t shared_count{0};
+    std::size_t exclusive_waiting{0};
+    bool exclusive{false};
+};
+
 class RpmLogGuardBase {
 public:
     RpmLogGuardBase() : rpm_log_mutex_guard(rpm_log_mutex) {}
     virtual ~RpmLogGuardBase();
 
 private:
-    static std::mutex rpm_log_mutex;
-    std::lock_guard<std::mutex> rpm_log_mutex_guard;
+    friend class RpmLogGuardThreadStrings;
+
+    static RpmLogMutex rpm_log_mutex;
+    std::lock_guard<RpmLogMutex> rpm_log_mutex_guard;
 };
 
 class RpmLogGuard : public RpmLogGuardBase {
@@ -68,6 +95,23 @@ private:
     std::vector<std::string> rpm_logs{};
 };
 
+/// Collects RPM messages emitted by the calling thread into `rpm_logs` for the lifetime of the guard.
+/// RPM calls the log callback in the thread that emitted the message, so guards of different threads
+/// share the rpm log mutex and can be held in parallel, each receiving only its own messages.
+/// The rpm log mask is raised to RPMLOG_INFO while any of the guards is held.
+/// Keep the guard only around the rpm calls whose messages are needed, it blocks the other rpm log guards.
+class RpmLogGuardThreadStrings {
+public:
+    explicit RpmLogGuardThreadStrings(std::vector<std::string> & rpm_logs);
+    ~RpmLogGuardThreadStrings();
+
+    RpmLogGuardThreadStrings(const RpmLogGuardThreadStrings &) = delete;
+    RpmLogGuardThreadStrings & operator=(const RpmLogGuardThreadStrings &) = delete;
+
+private:
+    std::shared_lock<RpmLogMutex> rpm_log_mutex_lock;
+};
+
 }  // namespace libdnf5::rpm
 
 #endif
@@ -21,6 +21,7 @@
 
 #include "repo/repo_pgp.hpp"
 #include "rpm/rpm_log_guard.hpp"
+#include "rpm/signature_check_pool.hpp"
 #include "utils/string.hpp"
 #include "utils/url.hpp"
 
@@ -37,6 +38,8 @@
 #include <rpm/rpmpgp.h>
 #include <rpm/rpmts.h>
 
+#include <algorithm>
+
 namespace libdnf5::rpm {
 
 namespace {
@@ -186,31 +189,15 @@ RpmSignature & RpmSignature::operator=(const RpmSignature & src) {
 RpmSignature & RpmSignature::operator=(RpmSignature && src) noexcept = default;
 
 
-RpmSignature::CheckResult RpmSignature::check_package_signature(const std::string & path) const {
-    // rpmcliVerifySignatures is the only API rpm provides for signature verification.
-    // Unfortunately to distinguish key_missing/not_signed/verification_failed cases
-    // we need to temporarily increase log level to RPMLOG_INFO, collect the log
-    // messages and parse them.
-    // This code is only slightly better than running `rpmkeys --checksig` tool
-    // and parsing it's output :(
-
-    // This guard acquires the rpm log mutex and collects all rpm log messages into
-    // the vector of strings.
-    libdnf5::rpm::RpmLogGuardStrings rpm_log_guard;
-
-    auto ts_ptr = create_transaction(p_impl->base);
-    auto oldmask = rpmlogSetMask(RPMLOG_UPTO(RPMLOG_PRI(RPMLOG_INFO)));
-
-    rpmtsSetVfyLevel(ts_ptr.get(), RPMSIG_SIGNATURE_TYPE);
+static int verify_signatures(rpmts ts, const std::string & path) {
     std::string path_non_const{path};
     char * const path_array[2] = {&path_non_const[0], NULL};
-    auto rc = rpmcliVerifySignatures(ts_ptr.get(), path_array);
-
-    rpmlogSetMask(oldmask);
+    return rpmcliVerifySignatures(ts, path_array);
+}
 
-    if (rc == RPMRC_OK) {
-        return CheckResult::OK;
-    }
+static RpmSignature::CheckResult check_result_from_rpm_logs(
+    const std::string & path, const std::vector<std::string> & rpm_logs) {
+    using CheckResult = RpmSignature::CheckResult;
 
     // This is brittle and heavily depends on rpm not changing log messages.
     // Here is an example of log messages after verifying a signed package
@@ -227,7 +214,7 @@ RpmSignature::CheckResult RpmSignature::check_package_signature(const std::strin
     bool missing_key{false};
     bool not_trusted{false};
     bool not_signed{false};
-    for (const auto & line : rpm_log_guard.get_rpm_logs()) {
+    for (const auto & line : rpm_logs) {
         std::string_view line_v{line};
         if (line_v.starts_with(path)) {
             continue;
@@ -255,21 +242,166 @@ RpmSignature::CheckResult RpmSignature::check_package_signature(const std::strin
     return CheckResult::FAILED;
 }
 
-RpmSignature::CheckResult RpmSignature::check_package_signature(const rpm::Package & pkg) const {
-    // is package OpenPGP check even required?
+RpmSignature::CheckResult RpmSignature::check_package_signature(const std::string & path) const {
+    // rpmcliVerifySignatures is the only API rpm provides for signature verification.
+    // Unfortunately to distinguish key_missing/not_signed/verification_failed cases
+    // we need to temporarily increase log level to RPMLOG_INFO, collect the log
+    // messages and parse them.
+    // This code is only slightly better than running `rpmkeys --checksig` tool
+    // and parsing it's output :(
+
+    // This guard acquires the rpm log mutex and collects all rpm log messages into
+    // the vector of strings.
+    libdnf5::rpm::RpmLogGuardStrings rpm_log_guard;
+
+    auto ts_ptr = create_transaction(p_impl->base);
+    auto oldmask = rpmlogSetMask(RPMLOG_UPTO(RPMLOG_PRI(RPMLOG_INFO)));
+
+    rpmtsSetVfyLevel(ts_ptr.get(), RPMSIG_SIGNATURE_TYPE);
+    auto rc = verify_signatures(ts_ptr.get(), path);
+
+    rpmlogSetMask(oldmask);
+
+    if (rc == RPMRC_OK) {
+        return CheckResult::OK;
+    }
+
+    return check_result_from_rpm_logs(path, rpm_log_guard.get_rpm_logs());
+}
+
+// Is package OpenPGP check even required?
+static bool is_signature_check_required(const BaseWeakPtr & base, const rpm::Package & pkg) {
     auto repo = pkg.get_repo();
     if (repo->get_type() == libdnf5::repo::Repo::Type::COMMANDLINE) {
-        if (!p_impl->base->get_config().get_localpkg_gpgcheck_option().get_value()) {
-            return CheckResult::SKIPPED;
+        return base->get_config().get_localpkg_gpgcheck_option().get_value();
+    }
+    return repo->get_config().get_pkg_gpgcheck_option().get_value();
+}
+
+RpmSignature::CheckResult RpmSignature::check_package_signature(const rpm::Package & pkg) const {
+    if (!is_signature_check_required(p_impl->base, pkg)) {
+        return CheckResult::SKIPPED;
+    }
+
+    return check_package_signature(pkg.get_package_path());
+}
+
+std::vector<RpmSignature::CheckResult> RpmSignature::check_package_signatures(
+    const std::vector<rpm::Package> & packages) const {
+    std::vector<CheckResult> results(packages.size(), CheckResult::SKIPPED);
+    std::vector<std::string> paths(packages.size());
+
+    std::map<std::string, CheckResult> path_results;
+    {
+        SignatureCheckPool check_pool(p_impl->base);
+        for (std::size_t idx = 0; idx < packages.size(); ++idx) {
+            auto path = packages[idx].get_package_path();
+            if (check_pool.add(packages[idx], path)) {
+                paths[idx] = std::move(path);
+            }
         }
-    } else {
-        auto & repo_config = repo->get_config();
-        if (!repo_config.get_pkg_gpgcheck_option().get_value()) {
-            return CheckResult::SKIPPED;
+        path_results = check_pool.finish();
+    }
+
+    for (std::size_t idx = 0; idx < packages.size(); ++idx) {
+        if (!paths[idx].empty()) {
+            results[idx] = path_results.at(paths[idx]);
         }
     }
+    return results;
+}
 
-    return check_package_signature(pkg.get_package_path());
+
+SignatureCheckPool::SignatureCheckPool(const BaseWeakPtr & base, std::size_t num_workers) : base(base) {
+    if (num_workers == 0) {
+        num_workers = std::max(std::thread::hardware_concurrency(), 1U);
+    }
+
+    // The keyring is loaded from the rpm database only once and is shared by all transactions.
+    transactions.reserve(num_workers);
+    for (std::size_t i = 0; i < num_workers; ++i) {
+        RpmTransactionPtr ts_ptr;
+        try {
+            ts_ptr = create_transaction(base);
+        } catch (...) {
+            for (auto * ts : transactions) {
+                rpmtsFree(ts);
+            }
+            throw;
+        }
+        rpmtsSetVfyLevel(ts_ptr.get(), RPMSIG_SIGNATURE_TYPE);
+        transactions.push_back(ts_ptr.release());
+    }
+    auto keyring = rpmtsGetKeyring(transactions[0], 1);
+    for (std::size_t i = 1; i < num_workers; ++i) {
+        rpmtsSetKeyring(transactions[i], keyring);
+    }
+    rpmKeyringFree(keyring);
+
+    for (std::size_t i = 0; i < num_workers; ++i) {
+        workers.emplace_back(&SignatureCheckPool::worker, this, i);
+    }
+}
+
+SignatureCheckPool::~SignatureCheckPool() {
+    finish();
+    for (auto * ts : transactions) {
+        rpmtsFree(ts);
+    }
+}
+
+bool SignatureCheckPool::add(const Package & package, const std::string & path) {
+    if (!is_signature_check_required(base, package)) {
+        return false;
+    }
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        queue.push_back(path);
+    }
+    cv.notify_one();
+    return true;
+}
+
+std::map<std::string, RpmSignature::CheckResult> SignatureCheckPool::finish() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        finishing = true;
+    }
+    cv.notify_all();
+    for (auto & thread : workers) {
+        thread.join();
+    }
+    workers.clear();
+    return std::move(results);
+}
+
+void SignatureCheckPool::worker(std::size_t worker_idx) {
+    std::vector<std::string> rpm_logs;
+    while (true) {
+        std::string path;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            cv.wait(lock, [this] { return finishing || !queue.empty(); });
+            if (queue.empty()) {
+                break;
+            }
+            path = std::move(queue.front());
+            queue.pop_front();
+        }
+
+        rpm_logs.clear();
+        int rc;
+        {
+            // The signature check result is parsed from the rpm log messages, see check_package_signature().
+            RpmLogGuardThreadStrings rpm_log_guard(rpm_logs);
+            rc = verify_signatures(transactions[worker_idx], path);
+        }
+        auto result =
+            rc == RPMRC_OK ? RpmSignature::CheckResult::OK : check_result_from_rpm_logs(path, rpm_logs);
+
+        std::lock_guard<std::mutex> lock(mutex);
+        results.insert_or_assign(std::move(path), result);
+    }
 }
 
 bool RpmSignature::key_present(const KeyInfo & key) const {
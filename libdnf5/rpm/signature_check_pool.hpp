@@ -0,0 +1,85 @@
+// Copyright Contributors to the DNF5 project.
+// Copyright Contributors to the libdnf project.
+// SPDX-License-Identifier: LGPL-2.1-or-later
+//
+// This file is part of libdnf: https://github.com/rpm-software-management/libdnf/
+//
+// Libdnf is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 2.1 of the License, or
+// (at your option) any later version.
+//
+// Libdnf is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
+
+#ifndef LIBDNF5_RPM_SIGNATURE_CHECK_POOL_HPP
+#define LIBDNF5_RPM_SIGNATURE_CHECK_POOL_HPP
+
+#include "rpm_log_guard.hpp"
+
+#include "libdnf5/base/base_weak.hpp"
+#include "libdnf5/rpm/package.hpp"
+#include "libdnf5/rpm/rpm_signature.hpp"
+
+#include <rpm/rpmts.h>
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+
+namespace libdnf5::rpm {
+
+/// Verifies signatures of rpm files on a pool of background threads.
+/// Files can be queued as soon as they are available (e.g. while other packages are still being
+/// downloaded), so the signature checks overlap with the work of the calling thread.
+/// The workers hold the rpm log mutex only while a file is being verified, so other rpm log guards
+/// can be used by the calling thread in the meantime.
+class SignatureCheckPool {
+public:
+    /// Start the pool. Each of the `num_workers` worker threads gets its own rpm transaction,
+    /// all transactions share one keyring loaded from the rpm database.
+    /// @param num_workers: number of worker threads, 0 means the number of hardware threads.
+    explicit SignatureCheckPool(const BaseWeakPtr & base, std::size_t num_workers = 0);
+    ~SignatureCheckPool();
+
+    SignatureCheckPool(const SignatureCheckPool &) = delete;
+    SignatureCheckPool & operator=(const SignatureCheckPool &) = delete;
+
+    /// Queue the rpm file of the `package` stored in `path` for the signature check.
+    /// The check is not queued if it is not required by the repository configuration of the package.
+    /// Must be called from the thread that owns the libsolv pool.
+    /// @return `true` if the check was queued, `false` if it is not required.
+    bool add(const Package & package, const std::string & path);
+
+    /// Wait for all queued checks to finish and stop the worker threads.
+    /// @return Check results of the queued files keyed by their paths.
+    std::map<std::string, RpmSignature::CheckResult> finish();
+
+private:
+    void worker(std::size_t worker_idx);
+
+    BaseWeakPtr base;
+    std::vector<rpmts> transactions;
+
+    std::mutex mutex;
+    std::condition_variable cv;
+    std::deque<std::string> queue;
+    std::map<std::string, RpmSignature::CheckResult> results;
+    bool finishing{false};
+    std::vector<std::thread> workers;
+};
+
+}  // namespace libdnf5::rpm
+
+#endif  // LIBDNF5_RPM_SIGNATURE_CHECK_POOL_HPP
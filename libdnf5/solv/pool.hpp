@@ -95,6 +95,17 @@ public:
 
     int get_nsolvables() const { return pool->nsolvables; }
 
+    /// Returns the generation of the pool solvables, it changes whenever solvables are freed.
+    /// Data computed from the solvables can be extended with the solvables added later only within one generation,
+    /// the Ids of the freed solvables may be reused by the new ones.
+    unsigned int get_solvables_generation() const noexcept { return solvables_generation; }
+
+    /// Frees the solvables of `repo`, see `repo_empty()`, and starts a new generation of the pool solvables.
+    void empty_repo(::Repo * repo, bool reuse_ids) {
+        repo_empty(repo, reuse_ids ? 1 : 0);
+        ++solvables_generation;
+    }
+
     Solvable * id2solvable(Id id) const { return pool_id2solvable(pool, id); }
 
     const char * id2str(Id id) const { return pool_id2str(pool, id); }
@@ -262,6 +273,7 @@ public:
 protected:
     SolvMap considered;  // owner of the considered map, `pool->considered` is only a raw pointer
     ::Pool * pool;
+    unsigned int solvables_generation{0};
 };
 
 
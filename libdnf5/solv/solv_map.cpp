@@ -0,0 +1,152 @@
+// Copyright Contributors to the DNF5 project.
+// Copyright Contributors to the libdnf project.
+// SPDX-License-Identifier: LGPL-2.1-or-later
+//
+// This file is part of libdnf: https://github.com/rpm-software-management/libdnf/
+//
+// Libdnf is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 2.1 of the License, or
+// (at your option) any later version.
+//
+// Libdnf is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
+
+#include "solv_map.hpp"
+
+#include <bit>
+#include <cstdint>
+#include <cstring>
+
+
+// On x86-64, the compiler generates a variant of each kernel for CPUs with AVX2 (32-byte vectors)
+// and with POPCNT. The best variant is selected at runtime by the dynamic loader.
+#if defined(__x86_64__) && defined(__has_attribute)
+#if __has_attribute(target_clones)
+#define LIBDNF5_BITMAP_KERNEL __attribute__((target_clones("avx2", "popcnt", "default")))
+#endif
+#endif
+#ifndef LIBDNF5_BITMAP_KERNEL
+#define LIBDNF5_BITMAP_KERNEL
+#endif
+
+
+namespace libdnf5::solv::bitmap {
+
+namespace {
+
+using Word = std::uint64_t;
+
+// Number of bytes processed in one step of the unrolled loops. The whole block is loaded before
+// it is stored, which allows the compiler to use a single vector operation for it.
+constexpr std::size_t BLOCK_WORDS = 4;
+constexpr std::size_t BLOCK_SIZE = BLOCK_WORDS * sizeof(Word);
+
+inline Word load(const unsigned char * ptr) noexcept {
+    Word word;
+    std::memcpy(&word, ptr, sizeof(word));
+    return word;
+}
+
+inline void store(unsigned char * ptr, Word word) noexcept {
+    std::memcpy(ptr, &word, sizeof(word));
+}
+
+template <typename Op>
+inline void combine(unsigned char * target, const unsigned char * source, std::size_t size, Op op) noexcept {
+    std::size_t idx = 0;
+    for (; idx + BLOCK_SIZE <= size; idx += BLOCK_SIZE) {
+        Word result[BLOCK_WORDS];
+        for (std::size_t i = 0; i < BLOCK_WORDS; ++i) {
+            result[i] = op(load(target + idx + i * sizeof(Word)), load(source + idx + i * sizeof(Word)));
+        }
+        for (std::size_t i = 0; i < BLOCK_WORDS; ++i) {
+            store(target + idx + i * sizeof(Word), result[i]);
+        }
+    }
+    for (; idx < size; ++idx) {
+        target[idx] = static_cast<unsigned char>(op(target[idx], source[idx]));
+    }
+}
+
+}  // namespace
+
+
+LIBDNF5_BITMAP_KERNEL void and_assign(
+    unsigned char * target, const unsigned char * source, std::size_t size) noexcept {
+    combine(target, source, size, [](Word a, Word b) { return a & b; });
+}
+
+
+LIBDNF5_BITMAP_KERNEL void or_assign(unsigned char * target, const unsigned char * source, std::size_t size) noexcept {
+    combine(target, source, size, [](Word a, Word b) { return a | b; });
+}
+
+
+LIBDNF5_BITMAP_KERNEL void subtract_assign(
+    unsigned char * target, const unsigned char * source, std::size_t size) noexcept {
+    combine(target, source, size, [](Word a, Word b) { return a & ~b; });
+}
+
+
+LIBDNF5_BITMAP_KERNEL std::size_t count(const unsigned char * map, std::size_t size) noexcept {
+    std::size_t result = 0;
+    std::size_t idx = 0;
+    for (; idx + sizeof(Word) <= size; idx += sizeof(Word)) {
+        result += static_cast<std::size_t>(std::popcount(load(map + idx)));
+    }
+    for (; idx < size; ++idx) {
+        result += static_cast<std::size_t>(std::popcount(map[idx]));
+    }
+    return result;
+}
+
+
+LIBDNF5_BITMAP_KERNEL const unsigned char * find_nonzero(
+    const unsigned char * begin, const unsigned char * end) noexcept {
+    const auto size = static_cast<std::size_t>(end - begin);
+    std::size_t idx = 0;
+    for (; idx + BLOCK_SIZE <= size; idx += BLOCK_SIZE) {
+        Word any = 0;
+        for (std::size_t i = 0; i < BLOCK_WORDS; ++i) {
+            any |= load(begin + idx + i * sizeof(Word));
+        }
+        if (any) {
+            break;
+        }
+    }
+    for (; idx < size; ++idx) {
+        if (begin[idx]) {
+            return begin + idx;
+        }
+    }
+    return end;
+}
+
+
+LIBDNF5_BITMAP_KERNEL bool is_intersection_empty(
+    const unsigned char * map1, const unsigned char * map2, std::size_t size) noexcept {
+    std::size_t idx = 0;
+    for (; idx + BLOCK_SIZE <= size; idx += BLOCK_SIZE) {
+        Word any = 0;
+        for (std::size_t i = 0; i < BLOCK_WORDS; ++i) {
+            any |= load(map1 + idx + i * sizeof(Word)) & load(map2 + idx + i * sizeof(Word));
+        }
+        if (any) {
+            return false;
+        }
+    }
+    for (; idx < size; ++idx) {
+        if (map1[idx] & map2[idx]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+}  // namespace libdnf5::solv::bitmap
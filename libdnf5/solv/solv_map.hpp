@@ -25,21 +25,38 @@
 #include <solv/bitmap.h>
 #include <solv/pooltypes.h>
 
+#include <cstddef>
+#include <cstring>
 #include <iterator>
+#include <span>
 #include <stdexcept>
 
 
 namespace libdnf5::solv {
 
-// clang-format off
-// see http://graphics.stanford.edu/~seander/bithacks.html#CountBitsSetTable
-static const unsigned char BIT_COUNT_LOOKUP[256] = {
-    #define B2(n) n, n + 1, n + 1, n + 2
-    #define B4(n) B2(n), B2(n + 1), B2(n + 1), B2(n + 2)
-    #define B6(n) B4(n), B4(n + 1), B4(n + 1), B4(n + 2)
-    B6(0), B6(1), B6(1), B6(2)
-};
-// clang-format on
+/// Kernels of the bitmap operations used by SolvMap. They process the bitmaps by machine words,
+/// on x86-64 the variants using AVX2 and POPCNT instructions are selected at runtime if supported.
+namespace bitmap {
+
+/// Performs `target[i] &= source[i]` for each of the `size` bytes.
+void and_assign(unsigned char * target, const unsigned char * source, std::size_t size) noexcept;
+
+/// Performs `target[i] |= source[i]` for each of the `size` bytes.
+void or_assign(unsigned char * target, const unsigned char * source, std::size_t size) noexcept;
+
+/// Performs `target[i] &= ~source[i]` for each of the `size` bytes.
+void subtract_assign(unsigned char * target, const unsigned char * source, std::size_t size) noexcept;
+
+/// @return the number of bits set in the `size` bytes of the `map`.
+std::size_t count(const unsigned char * map, std::size_t size) noexcept;
+
+/// @return the address of the first non-zero byte in the range <begin, end) or `end` if there is none.
+const unsigned char * find_nonzero(const unsigned char * begin, const unsigned char * end) noexcept;
+
+/// @return whether `map1[i] & map2[i]` is zero for each of the `size` bytes.
+bool is_intersection_empty(const unsigned char * map1, const unsigned char * map2, std::size_t size) noexcept;
+
+}  // namespace bitmap
 
 
 class ConstMapIterator {
@@ -204,23 +221,40 @@ public:
 
     void remove_unsafe(Id id) noexcept { map_clr(&map, id); }
 
+    /// Removes all ids except the ones in `sorted_ids` from the map.
+    /// The bytes between the ids are cleared in a single pass, the bytes holding the ids are masked.
+    ///
+    /// @param sorted_ids Ids in ascending order, all of them in the range of the map. Duplicates are allowed.
+    void retain_sorted_unsafe(std::span<const Id> sorted_ids) noexcept;
+
     // SET OPERATIONS - Map
 
+    // The operators have the same semantics as libsolv map_or(), map_subtract() and map_and().
+
     /// Union operator
     SolvMap & operator|=(const Map & other) noexcept {
-        map_or(&map, &other);
+        if (map.size < other.size) {
+            map_grow(&map, other.size << 3);
+        }
+        bitmap::or_assign(map.map, other.map, static_cast<std::size_t>(other.size));
         return *this;
     }
 
     /// Difference operator
     SolvMap & operator-=(const Map & other) noexcept {
-        map_subtract(&map, &other);
+        bitmap::subtract_assign(
+            map.map, other.map, static_cast<std::size_t>(map.size < other.size ? map.size : other.size));
         return *this;
     }
 
     /// Intersection operator
     SolvMap & operator&=(const Map & other) noexcept {
-        map_and(&map, &other);
+        if (map.size > other.size) {
+            bitmap::and_assign(map.map, other.map, static_cast<std::size_t>(other.size));
+            memset(map.map + other.size, 0, static_cast<std::size_t>(map.size - other.size));
+        } else {
+            bitmap::and_assign(map.map, other.map, static_cast<std::size_t>(map.size));
+        }
         return *this;
     }
 
@@ -264,6 +298,23 @@ private:
 };
 
 
+inline void SolvMap::retain_sorted_unsafe(std::span<const Id> sorted_ids) noexcept {
+    // bytes before `processed_end` already hold their final value
+    std::size_t processed_end = 0;
+    for (auto it = sorted_ids.begin(); it != sorted_ids.end();) {
+        const auto byte_idx = static_cast<std::size_t>(*it >> 3);
+        unsigned char mask = 0;
+        for (; it != sorted_ids.end() && static_cast<std::size_t>(*it >> 3) == byte_idx; ++it) {
+            mask = static_cast<unsigned char>(mask | (1 << (*it & 7)));
+        }
+        memset(map.map + processed_end, 0, byte_idx - processed_end);
+        map.map[byte_idx] &= mask;
+        processed_end = byte_idx + 1;
+    }
+    memset(map.map + processed_end, 0, static_cast<std::size_t>(map.size) - processed_end);
+}
+
+
 inline ConstMapIterator & ConstMapIterator::operator++() noexcept {
     if (current_value >= 0) {
         // make a copy of byte with the previous match to avoid changing the map
@@ -284,14 +335,9 @@ inline ConstMapIterator & ConstMapIterator::operator++() noexcept {
         map_current++;
     }
 
-    while (map_current < map_end) {
-        // skip all empty bytes
-        if (!*map_current) {
-            // move to the next byte
-            map_current++;
-            continue;
-        }
-
+    // skip all empty bytes
+    map_current = bitmap::find_nonzero(map_current, map_end);
+    if (map_current < map_end) {
         // now we have a byte that has at least one bit set
         // return (current byte * 8) + bit position - 1
         current_value = (static_cast<int>(map_current - map->map) << 3) + ffs(*map_current) - 1;
@@ -368,45 +414,19 @@ inline bool SolvMap::contains(Id id) const noexcept {
 
 
 inline bool SolvMap::empty() const noexcept {
-    const unsigned char * byte = map.map;
-    const unsigned char * end = byte + map.size;
-
-    // iterate through the whole bitmap by moving the address
-    while (byte < end) {
-        if (*byte++) {
-            // return false if a non-zero bit was found
-            return false;
-        }
-    }
-    // all bits were zero, return true
-    return true;
+    const unsigned char * end = map.map + map.size;
+    return bitmap::find_nonzero(map.map, end) == end;
 }
 
 
 inline std::size_t SolvMap::size() const noexcept {
-    unsigned char * byte = map.map;
-    unsigned char * end = byte + map.size;
-    std::size_t result = 0;
-
-    // iterate through the whole bitmap by moving the address
-    while (byte < end) {
-        // add number of bits in each byte
-        result += BIT_COUNT_LOOKUP[*byte++];
-    }
-    return result;
+    return bitmap::count(map.map, static_cast<std::size_t>(map.size));
 }
 
 
 inline bool SolvMap::is_intersection_empty(const Map & other_map) const noexcept {
-    const unsigned char * it = map.map;
-    const unsigned char * other_it = other_map.map;
-    const unsigned char * const end = it + (map.size < other_map.size ? map.size : other_map.size);
-    while (it < end) {
-        if ((*it++ & *other_it++) != 0) {
-            return false;
-        }
-    }
-    return true;
+    return bitmap::is_intersection_empty(
+        map.map, other_map.map, static_cast<std::size_t>(map.size < other_map.size ? map.size : other_map.size));
 }
 
 
@@ -0,0 +1,143 @@
+// Copyright Contributors to the DNF5 project.
+// Copyright Contributors to the libdnf project.
+// SPDX-License-Identifier: LGPL-2.1-or-later
+//
+// This file is part of libdnf: https://github.com/rpm-software-management/libdnf/
+//
+// Libdnf is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 2.1 of the License, or
+// (at your option) any later version.
+//
+// Libdnf is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
+#ifndef LIBDNF5_SOLV_SPARSE_SOLV_MAP_HPP
+#define LIBDNF5_SOLV_SPARSE_SOLV_MAP_HPP
+
+#include "solv_map.hpp"
+
+#include <solv/pooltypes.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <span>
+#include <vector>
+
+
+namespace libdnf5::solv {
+
+/// Collects a set of ids intended to be combined with a SolvMap, e.g. the result of a query filter.
+///
+/// Small sets are kept as a list of ids, so combining them with a SolvMap costs work proportional
+/// to the number of ids instead of the size of the map. Once the list exceeds a threshold derived
+/// from the map size and more than half of it are distinct ids, they are moved to a dense SolvMap
+/// and all following operations work with the bitmap.
+class SparseSolvMap {
+public:
+    /// @param size The size of the equivalent dense map (the number of solvables in the pool).
+    explicit SparseSolvMap(int size) : size(size) {}
+
+    /// Adds an id. The id must be in the range of the map size. Adding an id again has no effect.
+    void add_unsafe(Id id) {
+        if (dense) {
+            dense->add_unsafe(id);
+            return;
+        }
+        if (!ids.empty()) {
+            if (id == ids.back()) {
+                return;
+            }
+            ids_sorted = ids_sorted && id > ids.back();
+        }
+        ids.push_back(id);
+        if (ids.size() > max_sparse_size()) {
+            // The filters often add the same ids several times, only distinct ids count. The list goes dense
+            // unless at least half of it were duplicates, so it is normalized at most once per
+            // max_sparse_size() / 2 added ids.
+            normalize_ids();
+            if (ids.size() > max_sparse_size() / 2) {
+                make_dense();
+            }
+        }
+    }
+
+    /// @return whether the ids are kept in a dense SolvMap.
+    [[nodiscard]] bool is_dense() const noexcept { return static_cast<bool>(dense); }
+
+    /// Intersection: removes all ids that are not in this set from the `map`.
+    void apply_intersection(SolvMap & map);
+
+    /// Difference: removes all ids that are in this set from the `map`.
+    void apply_difference(SolvMap & map);
+
+private:
+    /// A list of ids takes 4 bytes per id, the dense map 1 bit per id. Above this number of ids
+    /// the bitmap is smaller and its operations are not slower than processing the list.
+    [[nodiscard]] std::size_t max_sparse_size() const noexcept {
+        return std::max(static_cast<std::size_t>(size) / 32, MIN_MAX_SPARSE_SIZE);
+    }
+
+    /// Sorts the ids and removes the duplicates.
+    void normalize_ids() {
+        if (!ids_sorted) {
+            std::sort(ids.begin(), ids.end());
+            ids_sorted = true;
+        }
+        ids.erase(std::unique(ids.begin(), ids.end()), ids.end());
+    }
+
+    void make_dense() {
+        dense = std::make_unique<SolvMap>(size);
+        for (Id id : ids) {
+            dense->add_unsafe(id);
+        }
+        ids.clear();
+        ids.shrink_to_fit();
+    }
+
+    constexpr static std::size_t MIN_MAX_SPARSE_SIZE = 64;
+
+    int size;
+    std::vector<Id> ids;
+    bool ids_sorted{true};
+    std::unique_ptr<SolvMap> dense;
+};
+
+
+inline void SparseSolvMap::apply_intersection(SolvMap & map) {
+    if (dense) {
+        map &= *dense;
+        return;
+    }
+
+    // Only the ids from the list can stay in the map. The bytes between the ids are cleared in one pass and
+    // the bytes holding the ids are only masked, the kept ids need not be looked up and set again.
+    normalize_ids();
+    auto ids_end = std::lower_bound(ids.begin(), ids.end(), map.allocated_size());
+    map.retain_sorted_unsafe(std::span<const Id>(ids.begin(), ids_end));
+}
+
+
+inline void SparseSolvMap::apply_difference(SolvMap & map) {
+    if (dense) {
+        map -= *dense;
+        return;
+    }
+
+    normalize_ids();
+    for (Id id : ids) {
+        if (map.contains(id)) {
+            map.remove_unsafe(id);
+        }
+    }
+}
+
+}  // namespace libdnf5::solv
+
+#endif  // LIBDNF5_SOLV_SPARSE_SOLV_MAP_HPP
@@ -0,0 +1,96 @@
+// Copyright Contributors to the DNF5 project.
+// Copyright Contributors to the libdnf project.
+// SPDX-License-Identifier: LGPL-2.1-or-later
+//
+// This file is part of libdnf: https://github.com/rpm-software-management/libdnf/
+//
+// Libdnf is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 2.1 of the License, or
+// (at your option) any later version.
+//
+// Libdnf is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
+
+#include "mapped_file.hpp"
+
+#include "libdnf5/common/exception.hpp"
+#include "libdnf5/utils/bgettext/bgettext-mark-domain.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+
+namespace libdnf5::utils::fs {
+
+MappedFile::MappedFile(const std::filesystem::path & path) : path(path) {
+    fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd == -1) {
+        throw FileSystemError(errno, path, M_("cannot open file"));
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) == -1) {
+        auto err = errno;
+        ::close(fd);
+        throw FileSystemError(err, path, M_("cannot stat file"));
+    }
+
+    length = static_cast<std::size_t>(st.st_size);
+    if (length == 0) {
+        return;
+    }
+
+    auto * mapping = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (mapping == MAP_FAILED) {
+        auto err = errno;
+        ::close(fd);
+        throw FileSystemError(err, path, M_("cannot map file into memory"));
+    }
+    addr = static_cast<unsigned char *>(mapping);
+}
+
+
+MappedFile::~MappedFile() {
+    if (addr) {
+        munmap(addr, length);
+    }
+    if (fd != -1) {
+        ::close(fd);
+    }
+}
+
+
+void MappedFile::will_need() const noexcept {
+    if (addr) {
+        madvise(addr, length, MADV_WILLNEED);
+    }
+}
+
+
+File MappedFile::open_file() const {
+    int new_fd = fcntl(fd, F_DUPFD_CLOEXEC, 0);
+    if (new_fd == -1) {
+        throw FileSystemError(errno, path, M_("cannot duplicate file descriptor"));
+    }
+
+    File file;
+    try {
+        file.open(new_fd, path, "r");
+    } catch (...) {
+        ::close(new_fd);
+        throw;
+    }
+    // The duplicate shares the file offset with the original descriptor
+    file.rewind();
+    return file;
+}
+
+}  // namespace libdnf5::utils::fs
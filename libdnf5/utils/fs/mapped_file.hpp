@@ -0,0 +1,72 @@
+// Copyright Contributors to the DNF5 project.
+// Copyright Contributors to the libdnf project.
+// SPDX-License-Identifier: LGPL-2.1-or-later
+//
+// This file is part of libdnf: https://github.com/rpm-software-management/libdnf/
+//
+// Libdnf is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 2.1 of the License, or
+// (at your option) any later version.
+//
+// Libdnf is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
+
+#ifndef LIBDNF5_UTILS_FS_MAPPED_FILE_HPP
+#define LIBDNF5_UTILS_FS_MAPPED_FILE_HPP
+
+#include "libdnf5/utils/fs/file.hpp"
+
+#include <cstddef>
+#include <filesystem>
+
+
+namespace libdnf5::utils::fs {
+
+/// A read-only memory mapping of a whole file handled in RAII fashion.
+/// The file descriptor is kept open for the lifetime of the object, so
+/// the mapped content and streams returned by `open_file()` always
+/// refer to the same file even if the path is replaced in the meantime.
+/// Errors are handled by raising instances of `libdnf5::FileSystemError`.
+class MappedFile {
+public:
+    /// Opens and maps the file at `path`. An empty file is not mapped,
+    /// `data()` then returns nullptr.
+    explicit MappedFile(const std::filesystem::path & path);
+
+    MappedFile(const MappedFile &) = delete;
+    MappedFile & operator=(const MappedFile &) = delete;
+    ~MappedFile();
+
+    /// @return The start of the mapped file content.
+    const unsigned char * data() const noexcept { return addr; }
+
+    /// @return The size of the mapped file content.
+    std::size_t size() const noexcept { return length; }
+
+    /// @return The path of the mapped file.
+    const std::filesystem::path & get_path() const noexcept { return path; }
+
+    /// Advises the kernel that the whole content is going to be read soon.
+    /// Starts an asynchronous read-ahead of the file pages not yet in the page cache.
+    void will_need() const noexcept;
+
+    /// Opens a new read-only stream on a duplicate of the mapped file descriptor.
+    /// The stream position is set to the beginning of the file.
+    File open_file() const;
+
+private:
+    std::filesystem::path path;
+    int fd{-1};
+    unsigned char * addr{nullptr};
+    std::size_t length{0};
+};
+
+}  // namespace libdnf5::utils::fs
+
+#endif  // LIBDNF5_UTILS_FS_MAPPED_FILE_HPP
@@ -0,0 +1,174 @@
+// Copyright Contributors to the DNF5 project.
+// Copyright Contributors to the libdnf project.
+// SPDX-License-Identifier: GPL-2.0-or-later
+//
+// This file is part of libdnf: https://github.com/rpm-software-management/libdnf/
+//
+// Libdnf is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 2 of the License, or
+// (at your option) any later version.
+//
+// Libdnf is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
+
+
+#include "test_package.hpp"
+
+#include "package.hpp"
+
+#include <fcntl.h>
+#include <fmt/format.h>
+#include <unistd.h>
+
+#include <array>
+#include <csignal>
+#include <string>
+#include <thread>
+#include <vector>
+
+
+CPPUNIT_TEST_SUITE_REGISTRATION(PackageJsonTest);
+
+namespace {
+
+const std::vector<std::string> ATTRIBUTES{"name", "install_size", "is_installed", "provides", "changelogs"};
+
+PackageValues create_package(int id) {
+    return PackageValues{
+        id,
+        {fmt::format("pkg{}", id),
+         int64_t{1024},
+         true,
+         std::vector<std::string>{"cap1", "cap2 = 1.0"},
+         std::vector<PackageChangelog>{{1700000000, "Author", "- Fix"}}}};
+}
+
+// Reads the pipe until the write end is closed.
+std::string read_all(int fd) {
+    std::string data;
+    std::array<char, 4096> buffer;
+    ssize_t bytes_read;
+    while ((bytes_read = read(fd, buffer.data(), buffer.size())) > 0) {
+        data.append(buffer.data(), static_cast<std::size_t>(bytes_read));
+    }
+    return data;
+}
+
+}  // namespace
+
+
+void PackageJsonTest::setUp() {
+    std::array<int, 2> fds;
+    CPPUNIT_ASSERT_EQUAL(0, pipe(fds.data()));
+    read_fd = fds[0];
+    write_fd = fds[1];
+}
+
+void PackageJsonTest::tearDown() {
+    if (read_fd != -1) {
+        close(read_fd);
+    }
+    if (write_fd != -1) {
+        close(write_fd);
+    }
+}
+
+void PackageJsonTest::test_values_to_json_object() {
+    auto attributes = resolve_package_attributes(ATTRIBUTES);
+    CPPUNIT_ASSERT_EQUAL(
+        std::string(
+            "{\"id\":7,\"name\":\"pkg7\",\"install_size\":1024,\"is_installed\":true,"
+            "\"provides\":[\"cap1\",\"cap2 = 1.0\"],\"changelogs\":[[1700000000,\"Author\",\"- Fix\"]]}"),
+        package_values_to_json(create_package(7), attributes, PackageJsonFormat::OBJECT));
+}
+
+void PackageJsonTest::test_values_to_json_array() {
+    auto attributes = resolve_package_attributes(ATTRIBUTES);
+    CPPUNIT_ASSERT_EQUAL(
+        std::string("[\"id\",\"name\",\"install_size\",\"is_installed\",\"provides\",\"changelogs\"]"),
+        package_json_header(attributes));
+    CPPUNIT_ASSERT_EQUAL(
+        std::string("[7,\"pkg7\",1024,true,[\"cap1\",\"cap2 = 1.0\"],[[1700000000,\"Author\",\"- Fix\"]]]"),
+        package_values_to_json(create_package(7), attributes, PackageJsonFormat::ARRAY));
+}
+
+void PackageJsonTest::test_writer_object() {
+    auto attributes = resolve_package_attributes(ATTRIBUTES);
+    // more packages than fit in one chunk
+    const int count = static_cast<int>(PackageJsonWriter::CHUNK_SIZE) * 3 + 1;
+
+    std::string expected;
+    for (int id = 0; id < count; ++id) {
+        expected += package_values_to_json(create_package(id), attributes, PackageJsonFormat::OBJECT) + "\n";
+    }
+
+    // the pipe is read while the packages are written
+    std::string data;
+    std::thread reader([this, &data]() { data = read_all(read_fd); });
+    {
+        PackageJsonWriter writer(write_fd, attributes, PackageJsonFormat::OBJECT);
+        for (int id = 0; id < count; ++id) {
+            CPPUNIT_ASSERT(writer.write(create_package(id)));
+        }
+        std::string error_msg;
+        CPPUNIT_ASSERT(writer.finish(error_msg));
+        CPPUNIT_ASSERT(error_msg.empty());
+    }
+    close(write_fd);
+    write_fd = -1;
+    reader.join();
+
+    // the packages are written in the order of their extraction
+    CPPUNIT_ASSERT_EQUAL(expected, data);
+}
+
+void PackageJsonTest::test_writer_array() {
+    auto attributes = resolve_package_attributes(ATTRIBUTES);
+
+    std::string data;
+    std::thread reader([this, &data]() { data = read_all(read_fd); });
+    {
+        PackageJsonWriter writer(write_fd, attributes, PackageJsonFormat::ARRAY);
+        CPPUNIT_ASSERT(writer.write(create_package(1)));
+        CPPUNIT_ASSERT(writer.write(create_package(2)));
+        std::string error_msg;
+        CPPUNIT_ASSERT(writer.finish(error_msg));
+    }
+    close(write_fd);
+    write_fd = -1;
+    reader.join();
+
+    // the header line is followed by the packages
+    CPPUNIT_ASSERT_EQUAL(
+        package_json_header(attributes) + "\n" +
+            package_values_to_json(create_package(1), attributes, PackageJsonFormat::ARRAY) + "\n" +
+            package_values_to_json(create_package(2), attributes, PackageJsonFormat::ARRAY) + "\n",
+        data);
+}
+
+void PackageJsonTest::test_writer_error() {
+    // the client closed the read end of the pipe
+    close(read_fd);
+    read_fd = -1;
+    auto orig_handler = std::signal(SIGPIPE, SIG_IGN);
+
+    PackageJsonWriter writer(write_fd, resolve_package_attributes(ATTRIBUTES), PackageJsonFormat::OBJECT);
+    writer.write(create_package(1));
+    std::string error_msg;
+    CPPUNIT_ASSERT(!writer.finish(error_msg));
+    CPPUNIT_ASSERT(!error_msg.empty());
+
+    // the following packages are refused
+    for (std::size_t idx = 0; idx < PackageJsonWriter::CHUNK_SIZE; ++idx) {
+        writer.write(create_package(1));
+    }
+    CPPUNIT_ASSERT(!writer.finish(error_msg));
+
+    std::signal(SIGPIPE, orig_handler);
+}
@@ -18,6 +18,7 @@
 # along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
 
 import dbus
+import json
 import os
 
 import support
@@ -97,3 +98,44 @@ class RepoTest(support.InstallrootCase):
             ],
                 signature=dbus.Signature('a{sv}'))
         )
+
+    def list_fd(self, options):
+        '''Read the lines the list_fd() method writes to the pipe'''
+        read_fd, write_fd = os.pipe()
+        self.iface_rpm.list_fd(options, dbus.types.UnixFd(write_fd))
+        # the daemon holds its own copy of the write end, the pipe is closed once the transfer is finished
+        os.close(write_fd)
+        with os.fdopen(read_fd) as f:
+            return [json.loads(line) for line in f]
+
+    def test_repoquery_fd_object(self):
+        pkglist = self.list_fd({
+            "package_attrs": ["full_nevra", "repo_id"],
+            "patterns": ["one"]})
+        for pkg in pkglist:
+            self.assertIsInstance(pkg.pop('id'), int)
+        self.assertCountEqual(pkglist, [
+            {'full_nevra': 'one-0:1-1.noarch', 'repo_id': 'rpm-repo1'},
+            {'full_nevra': 'one-0:1-1.src', 'repo_id': 'rpm-repo1'},
+            {'full_nevra': 'one-0:2-1.noarch', 'repo_id': 'rpm-repo1'},
+            {'full_nevra': 'one-0:2-1.src', 'repo_id': 'rpm-repo1'},
+        ])
+
+    def test_repoquery_fd_array(self):
+        options = {
+            "package_attrs": ["full_nevra", "repo_id", "provides"],
+            "patterns": ["one"]}
+        header, *rows = self.list_fd(
+            dict(options, package_format="array"))
+        # the names of the values are written once in the header
+        self.assertEqual(header, ['id', 'full_nevra', 'repo_id', 'provides'])
+        # each package is an array of the same values as in the object format
+        self.assertCountEqual(
+            [dict(zip(header, row)) for row in rows], self.list_fd(options))
+        self.assertCountEqual([row[1] for row in rows], [
+            'one-0:1-1.noarch', 'one-0:1-1.src', 'one-0:2-1.noarch', 'one-0:2-1.src'])
+
+    def test_repoquery_fd_unsupported_format(self):
+        # nothing is written for an unknown format
+        self.assertEqual(
+            self.list_fd({"package_format": "binary", "patterns": ["one"]}), [])
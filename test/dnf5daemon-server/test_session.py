@@ -18,8 +18,14 @@
 # along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
 
 import dbus
+import dbus.mainloop.glib
+import os
+import shutil
+import tempfile
 import unittest
 
+from gi.repository import GLib
+
 import support
 
 
@@ -45,3 +51,167 @@ class SessionTest(unittest.TestCase):
         # closing non-existent session returns False
         self.assertEqual(dbus.Boolean(False),
                          self.iface.close_session(session))
+
+
+class SessionSignalsCase(unittest.TestCase):
+    '''Sessions in an installroot opened on a private connection that receives the repositories_ready signals'''
+
+    def setUp(self):
+        self.installroot = tempfile.mkdtemp(prefix="dnf5daemon-test-")
+        self.config_file_path = os.path.join(
+            self.installroot, 'etc/dnf/dnf.conf')
+        os.makedirs(os.path.dirname(self.config_file_path), exist_ok=True)
+        with open(self.config_file_path, 'w') as f:
+            f.write('')
+
+        # private connection, the repositories_ready signal is sent only to the client that opened the session
+        self.bus = dbus.SystemBus(
+            mainloop=dbus.mainloop.glib.DBusGMainLoop(), private=True)
+        self.iface_session = dbus.Interface(
+            self.bus.get_object(support.DNFDAEMON_BUS_NAME,
+                                support.DNFDAEMON_OBJECT_PATH),
+            dbus_interface=support.IFACE_SESSION_MANAGER)
+        self.loaded_sessions = []
+        self.signal_match = self.bus.add_signal_receiver(
+            self.on_repositories_ready,
+            signal_name='repositories_ready',
+            dbus_interface=support.IFACE_BASE)
+
+    def tearDown(self):
+        self.signal_match.remove()
+        self.bus.close()
+        shutil.rmtree(self.installroot)
+
+    def on_repositories_ready(self, session_object_path, success):
+        self.loaded_sessions.append((session_object_path, bool(success)))
+
+    def session_config(self, **overrides):
+        # Prevent loading plugins from host by setting "plugins" to False
+        config = {
+            "config_file_path": self.config_file_path,
+            "installroot": self.installroot,
+            "plugins": "False",
+            "cachedir": os.path.join(self.installroot, "var/cache/dnf"),
+            "reposdir": os.path.join(support.PROJECT_BINARY_DIR, "test/data/repos-rpm-conf.d"),
+        }
+        config.update(overrides)
+        return {"config": config}
+
+    def list_packages(self, session, scope="all"):
+        iface_rpm = dbus.Interface(
+            self.bus.get_object(support.DNFDAEMON_BUS_NAME, session),
+            dbus_interface=support.IFACE_RPM)
+        pkglist = iface_rpm.list(
+            {"package_attrs": ["full_nevra"], "scope": scope})
+        return sorted(str(pkg['full_nevra']) for pkg in pkglist)
+
+    def repositories_loaded(self, session):
+        # dispatch the signals received so far, the signal is emitted before the reply of the method that loaded
+        # the repositories
+        while GLib.MainContext.default().iteration(False):
+            pass
+        return (session, True) in self.loaded_sessions
+
+
+class RepositoriesReadyTest(SessionSignalsCase):
+
+    def test_repositories_ready(self):
+        session = self.iface_session.open_session(self.session_config())
+        iface_base = dbus.Interface(
+            self.bus.get_object(support.DNFDAEMON_BUS_NAME, session),
+            dbus_interface=support.IFACE_BASE)
+        self.assertTrue(iface_base.read_all_repos())
+        # the signal is received once the repositories are loaded
+        self.assertTrue(self.repositories_loaded(session))
+        self.assertEqual([(session, True)], self.loaded_sessions)
+
+        # the loaded repositories are not loaded again, no other signal is emitted
+        self.assertTrue(iface_base.read_all_repos())
+        self.list_packages(session)
+        self.assertTrue(self.repositories_loaded(session))
+        self.assertEqual([(session, True)], self.loaded_sessions)
+        self.iface_session.close_session(session)
+
+    def test_repositories_ready_failure(self):
+        # a repository that cannot be loaded
+        reposdir = os.path.join(self.installroot, 'etc/yum.repos.d')
+        os.makedirs(reposdir)
+        with open(os.path.join(reposdir, 'broken.repo'), 'w') as f:
+            f.write('[broken]\n')
+            f.write('baseurl=file://{}\n'.format(os.path.join(self.installroot, 'nonexistent')))
+            f.write('skip_if_unavailable=0\n')
+
+        session = self.iface_session.open_session(
+            self.session_config(reposdir=reposdir))
+        iface_base = dbus.Interface(
+            self.bus.get_object(support.DNFDAEMON_BUS_NAME, session),
+            dbus_interface=support.IFACE_BASE)
+        self.assertFalse(iface_base.read_all_repos())
+        self.repositories_loaded(session)
+        self.assertEqual([(session, False)], self.loaded_sessions)
+        self.iface_session.close_session(session)
+
+
+class SessionReuseTest(SessionSignalsCase):
+    '''The loaded base of a closed session is reused by the next session with the same configuration'''
+
+    def test_reuse_base(self):
+        session = self.iface_session.open_session(self.session_config())
+        packages = self.list_packages(session)
+        self.assertTrue(self.repositories_loaded(session))
+        self.iface_session.close_session(session)
+
+        # the next session with the same configuration does not load the repositories again
+        session = self.iface_session.open_session(self.session_config())
+        self.assertEqual(packages, self.list_packages(session))
+        self.assertFalse(self.repositories_loaded(session))
+        self.iface_session.close_session(session)
+
+        # a session with a different configuration sets up its own base
+        session = self.iface_session.open_session(
+            self.session_config(best="True"))
+        self.assertEqual(packages, self.list_packages(session))
+        self.assertTrue(self.repositories_loaded(session))
+        self.iface_session.close_session(session)
+
+    def test_config_change_invalidates_base(self):
+        session = self.iface_session.open_session(self.session_config())
+        self.list_packages(session)
+        self.assertTrue(self.repositories_loaded(session))
+        self.iface_session.close_session(session)
+
+        # newer modification time of the configuration file
+        mtime = os.stat(self.config_file_path).st_mtime + 10
+        os.utime(self.config_file_path, (mtime, mtime))
+
+        session = self.iface_session.open_session(self.session_config())
+        self.list_packages(session)
+        self.assertTrue(self.repositories_loaded(session))
+        self.iface_session.close_session(session)
+
+    def test_rpmdb_change_invalidates_base(self):
+        session = self.iface_session.open_session(self.session_config())
+        self.assertEqual([], self.list_packages(session, "installed"))
+        self.assertTrue(self.repositories_loaded(session))
+        self.iface_session.close_session(session)
+
+        # install a package in a session with a different configuration, the idle base is kept
+        session = self.iface_session.open_session(
+            self.session_config(best="True"))
+        session_object = self.bus.get_object(support.DNFDAEMON_BUS_NAME, session)
+        iface_rpm = dbus.Interface(
+            session_object, dbus_interface=support.IFACE_RPM)
+        iface_goal = dbus.Interface(
+            session_object, dbus_interface=support.IFACE_GOAL)
+        iface_rpm.install(['one'], dbus.Dictionary({}, signature='sv'))
+        resolved, result = iface_goal.resolve(
+            dbus.Dictionary({}, signature='sv'))
+        self.assertEqual(result, 0)
+        iface_goal.do_transaction(dbus.Dictionary({}, signature='sv'))
+        self.iface_session.close_session(session)
+
+        # the rpmdb changed since the idle base was loaded, it is not reused
+        session = self.iface_session.open_session(self.session_config())
+        self.assertEqual(['one-0:2-1.noarch'], self.list_packages(session, "installed"))
+        self.assertTrue(self.repositories_loaded(session))
+        self.iface_session.close_session(session)
@@ -0,0 +1,218 @@
+// Copyright Contributors to the DNF5 project.
+// Copyright Contributors to the libdnf project.
+// SPDX-License-Identifier: GPL-2.0-or-later
+//
+// This file is part of libdnf: https://github.com/rpm-software-management/libdnf/
+//
+// Libdnf is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 2 of the License, or
+// (at your option) any later version.
+//
+// Libdnf is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
+
+
+#include "test_threads_manager.hpp"
+
+#include "../shared/private_accessor.hpp"
+#include "threads_manager.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <future>
+#include <mutex>
+#include <numeric>
+#include <thread>
+#include <vector>
+
+
+CPPUNIT_TEST_SUITE_REGISTRATION(ThreadsManagerTest);
+
+create_private_getter_template;
+create_getter(submit, &ThreadsManager::submit);
+
+namespace {
+
+// Submits a task that may be refused when the queue is full, as a method call is
+bool submit_task(ThreadsManager & manager, std::function<void()> && task, bool serial) {
+    return (manager.*get(submit{}))(std::move(task), serial, true);
+}
+
+// Submits a task that blocks its worker until `release` is set, returns once the task is running.
+void submit_blocking_task(ThreadsManager & manager, std::shared_future<void> release, bool serial) {
+    std::promise<void> started;
+    auto started_future = started.get_future();
+    CPPUNIT_ASSERT(submit_task(
+        manager,
+        [started = std::make_shared<std::promise<void>>(std::move(started)), release]() {
+            started->set_value();
+            release.wait();
+        },
+        serial));
+    started_future.wait();
+}
+
+}  // namespace
+
+
+void ThreadsManagerTest::test_serial_lane_order() {
+    ThreadsManager manager(4);
+    std::mutex order_mutex;
+    std::vector<int> order;
+    std::atomic<int> running{0};
+    std::atomic<bool> overlapped{false};
+
+    for (int idx = 0; idx < 20; ++idx) {
+        CPPUNIT_ASSERT(submit_task(
+            manager,
+            [&, idx]() {
+                if (running.fetch_add(1) != 0) {
+                    overlapped = true;
+                }
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+                {
+                    std::lock_guard<std::mutex> lock(order_mutex);
+                    order.push_back(idx);
+                }
+                running.fetch_sub(1);
+            },
+            true));
+    }
+    manager.finish();
+
+    // the serial tasks run one at a time in the order of their submission
+    std::vector<int> expected(20);
+    std::iota(expected.begin(), expected.end(), 0);
+    CPPUNIT_ASSERT(order == expected);
+    CPPUNIT_ASSERT(!overlapped);
+}
+
+void ThreadsManagerTest::test_task_runs_while_serial_task_waits() {
+    ThreadsManager manager(2);
+    std::promise<void> confirmed;
+    auto confirmed_future = confirmed.get_future();
+    std::atomic<bool> serial_task_done{false};
+    std::atomic<bool> serial_tasks_ordered{false};
+
+    // the serial task waits for a task submitted later, e.g. a method waiting for a key import confirmation
+    CPPUNIT_ASSERT(submit_task(
+        manager,
+        [&]() {
+            confirmed_future.wait();
+            serial_task_done = true;
+        },
+        true));
+    // another serial task must not take the second worker
+    CPPUNIT_ASSERT(submit_task(manager, [&]() { serial_tasks_ordered = serial_task_done.load(); }, true));
+    CPPUNIT_ASSERT(submit_task(manager, [&]() { confirmed.set_value(); }, false));
+    manager.finish();
+
+    CPPUNIT_ASSERT(serial_task_done);
+    CPPUNIT_ASSERT(serial_tasks_ordered);
+}
+
+void ThreadsManagerTest::test_queue_limit() {
+    ThreadsManager manager(1, 2);
+    std::promise<void> release;
+    std::shared_future<void> release_future = release.get_future().share();
+    std::atomic<int> done{0};
+
+    // the only worker is busy, the following tasks are queued
+    submit_blocking_task(manager, release_future, false);
+    CPPUNIT_ASSERT(submit_task(manager, [&]() { ++done; }, false));
+    CPPUNIT_ASSERT(submit_task(manager, [&]() { ++done; }, true));
+
+    // the queue is full
+    CPPUNIT_ASSERT(!submit_task(manager, [&]() { ++done; }, false));
+    CPPUNIT_ASSERT(!submit_task(manager, [&]() { ++done; }, true));
+    // signal handlers are not limited
+    CPPUNIT_ASSERT((manager.*get(submit{}))([&]() { ++done; }, false, false));
+
+    release.set_value();
+    manager.finish();
+
+    CPPUNIT_ASSERT_EQUAL(3, done.load());
+}
+
+void ThreadsManagerTest::test_finish() {
+    ThreadsManager manager(2);
+    std::atomic<int> done{0};
+
+    for (int idx = 0; idx < 10; ++idx) {
+        CPPUNIT_ASSERT(submit_task(
+            manager,
+            [&]() {
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+                ++done;
+            },
+            idx % 2 == 0));
+    }
+
+    // finish() waits for all queued tasks
+    manager.finish();
+    CPPUNIT_ASSERT_EQUAL(10, done.load());
+
+    // tasks submitted after finish() are refused, even those not limited by the queue size
+    CPPUNIT_ASSERT(!submit_task(manager, [&]() { ++done; }, false));
+    CPPUNIT_ASSERT(!submit_task(manager, [&]() { ++done; }, true));
+    CPPUNIT_ASSERT(!(manager.*get(submit{}))([&]() { ++done; }, false, false));
+    CPPUNIT_ASSERT_EQUAL(10, done.load());
+
+    // finishing again is a no-op
+    manager.finish();
+}
+
+void ThreadsManagerTest::test_unlimited_workers() {
+    ThreadsManager manager(ThreadsManager::UNLIMITED_WORKERS);
+    std::promise<void> release;
+    std::shared_future<void> release_future = release.get_future().share();
+
+    // more blocked tasks than the default number of workers do not hold up the next task
+    for (std::size_t idx = 0; idx < ThreadsManager::DEFAULT_MAX_WORKERS + 1; ++idx) {
+        submit_blocking_task(manager, release_future, false);
+    }
+    std::promise<void> done;
+    auto done_future = done.get_future();
+    CPPUNIT_ASSERT(submit_task(manager, [&]() { done.set_value(); }, false));
+    CPPUNIT_ASSERT(done_future.wait_for(std::chrono::seconds(10)) == std::future_status::ready);
+
+    release.set_value();
+    manager.finish();
+}
+
+void ThreadsManagerTest::test_metrics() {
+    ThreadsManager manager(1, 2);
+    std::promise<void> release;
+    std::shared_future<void> release_future = release.get_future().share();
+
+    // the only worker is busy, two tasks are queued and the next one is refused
+    submit_blocking_task(manager, release_future, true);
+    CPPUNIT_ASSERT(submit_task(manager, []() {}, true));
+    CPPUNIT_ASSERT(submit_task(manager, []() {}, false));
+    CPPUNIT_ASSERT(!submit_task(manager, []() {}, false));
+
+    auto metrics = manager.get_metrics();
+    CPPUNIT_ASSERT_EQUAL(std::size_t{1}, metrics.workers);
+    CPPUNIT_ASSERT_EQUAL(std::size_t{2}, metrics.queued_tasks);
+    CPPUNIT_ASSERT_EQUAL(std::size_t{2}, metrics.peak_queued_tasks);
+    CPPUNIT_ASSERT_EQUAL(std::uint64_t{0}, metrics.completed_tasks);
+    CPPUNIT_ASSERT_EQUAL(std::uint64_t{1}, metrics.rejected_tasks);
+
+    release.set_value();
+    manager.finish();
+    CPPUNIT_ASSERT(!submit_task(manager, []() {}, false));
+
+    metrics = manager.get_metrics();
+    CPPUNIT_ASSERT_EQUAL(std::size_t{0}, metrics.workers);
+    CPPUNIT_ASSERT_EQUAL(std::size_t{0}, metrics.queued_tasks);
+    CPPUNIT_ASSERT_EQUAL(std::size_t{2}, metrics.peak_queued_tasks);
+    CPPUNIT_ASSERT_EQUAL(std::uint64_t{3}, metrics.completed_tasks);
+    CPPUNIT_ASSERT_EQUAL(std::uint64_t{2}, metrics.rejected_tasks);
+}
@@ -0,0 +1,49 @@
+// Copyright Contributors to the DNF5 project.
+// Copyright Contributors to the libdnf project.
+// SPDX-License-Identifier: GPL-2.0-or-later
+//
+// This file is part of libdnf: https://github.com/rpm-software-management/libdnf/
+//
+// Libdnf is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 2 of the License, or
+// (at your option) any later version.
+//
+// Libdnf is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
+
+
+#ifndef TEST_DNF5DAEMON_SERVER_THREADS_MANAGER_HPP
+#define TEST_DNF5DAEMON_SERVER_THREADS_MANAGER_HPP
+
+#include <cppunit/TestCase.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+class ThreadsManagerTest : public CppUnit::TestCase {
+    CPPUNIT_TEST_SUITE(ThreadsManagerTest);
+
+    CPPUNIT_TEST(test_serial_lane_order);
+    CPPUNIT_TEST(test_task_runs_while_serial_task_waits);
+    CPPUNIT_TEST(test_queue_limit);
+    CPPUNIT_TEST(test_finish);
+    CPPUNIT_TEST(test_unlimited_workers);
+    CPPUNIT_TEST(test_metrics);
+
+    CPPUNIT_TEST_SUITE_END();
+
+public:
+    void test_serial_lane_order();
+    void test_task_runs_while_serial_task_waits();
+    void test_queue_limit();
+    void test_finish();
+    void test_unlimited_workers();
+    void test_metrics();
+};
+
+
+#endif  // TEST_DNF5DAEMON_SERVER_THREADS_MANAGER_HPP
@@ -0,0 +1,127 @@
+// Copyright Contributors to the DNF5 project.
+// Copyright Contributors to the libdnf project.
+// SPDX-License-Identifier: GPL-2.0-or-later
+//
+// This file is part of libdnf: https://github.com/rpm-software-management/libdnf/
+//
+// Libdnf is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 2 of the License, or
+// (at your option) any later version.
+//
+// Libdnf is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
+
+
+#include "test_utils.hpp"
+
+#include "utils.hpp"
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <array>
+#include <csignal>
+#include <string>
+
+
+CPPUNIT_TEST_SUITE_REGISTRATION(BufferedFdWriterTest);
+
+namespace {
+
+// Reads the data available in the pipe without waiting for more.
+std::string read_available(int fd) {
+    std::string data;
+    std::array<char, 4096> buffer;
+    ssize_t bytes_read;
+    while ((bytes_read = read(fd, buffer.data(), buffer.size())) > 0) {
+        data.append(buffer.data(), static_cast<std::size_t>(bytes_read));
+    }
+    return data;
+}
+
+}  // namespace
+
+
+void BufferedFdWriterTest::setUp() {
+    std::array<int, 2> fds;
+    CPPUNIT_ASSERT_EQUAL(0, pipe2(fds.data(), O_NONBLOCK));
+    read_fd = fds[0];
+    write_fd = fds[1];
+}
+
+void BufferedFdWriterTest::tearDown() {
+    if (read_fd != -1) {
+        close(read_fd);
+    }
+    close(write_fd);
+}
+
+void BufferedFdWriterTest::test_write_batches() {
+    dnfdaemon::BufferedFdWriter writer(write_fd, 16);
+    std::string error_msg;
+
+    // the messages are collected until there is at least a batch of them
+    CPPUNIT_ASSERT(writer.write("0123456789", error_msg));
+    CPPUNIT_ASSERT_EQUAL(std::string(), read_available(read_fd));
+
+    CPPUNIT_ASSERT(writer.write("abcdefghij", error_msg));
+    CPPUNIT_ASSERT_EQUAL(std::string("0123456789abcdefghij"), read_available(read_fd));
+
+    // the collected data were written, a new batch starts
+    CPPUNIT_ASSERT(writer.write("klm", error_msg));
+    CPPUNIT_ASSERT_EQUAL(std::string(), read_available(read_fd));
+    CPPUNIT_ASSERT(error_msg.empty());
+}
+
+void BufferedFdWriterTest::test_flush() {
+    dnfdaemon::BufferedFdWriter writer(write_fd, 16);
+    std::string error_msg;
+
+    // flushing without collected data does not write anything
+    CPPUNIT_ASSERT(writer.flush(error_msg));
+    CPPUNIT_ASSERT_EQUAL(std::string(), read_available(read_fd));
+
+    CPPUNIT_ASSERT(writer.write("first\n", error_msg));
+    CPPUNIT_ASSERT(writer.write("second\n", error_msg));
+    CPPUNIT_ASSERT(writer.flush(error_msg));
+    CPPUNIT_ASSERT_EQUAL(std::string("first\nsecond\n"), read_available(read_fd));
+
+    // the flushed data are not written again
+    CPPUNIT_ASSERT(writer.flush(error_msg));
+    CPPUNIT_ASSERT_EQUAL(std::string(), read_available(read_fd));
+    CPPUNIT_ASSERT(error_msg.empty());
+}
+
+void BufferedFdWriterTest::test_pipe_size() {
+    // the pipe is enlarged to take a whole batch, 128 KiB does not exceed the default limit of pipe sizes
+    const std::size_t batch_size = 128 * 1024;
+    dnfdaemon::BufferedFdWriter writer(write_fd, batch_size);
+    CPPUNIT_ASSERT(static_cast<std::size_t>(fcntl(write_fd, F_GETPIPE_SZ)) >= batch_size);
+
+    // a batch larger than the default pipe capacity is written while nothing reads the pipe
+    std::string error_msg;
+    const std::string message(batch_size, 'x');
+    CPPUNIT_ASSERT(writer.write(message, error_msg));
+    CPPUNIT_ASSERT_EQUAL(message, read_available(read_fd));
+}
+
+void BufferedFdWriterTest::test_write_error() {
+    // the client closed the read end of the pipe
+    close(read_fd);
+    read_fd = -1;
+    auto orig_handler = std::signal(SIGPIPE, SIG_IGN);
+
+    dnfdaemon::BufferedFdWriter writer(write_fd, 16);
+    std::string error_msg;
+    CPPUNIT_ASSERT(writer.write("0123456789", error_msg));
+    CPPUNIT_ASSERT(!writer.flush(error_msg));
+    CPPUNIT_ASSERT(!error_msg.empty());
+
+    std::signal(SIGPIPE, orig_handler);
+}
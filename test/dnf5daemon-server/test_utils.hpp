@@ -0,0 +1,52 @@
+// Copyright Contributors to the DNF5 project.
+// Copyright Contributors to the libdnf project.
+// SPDX-License-Identifier: GPL-2.0-or-later
+//
+// This file is part of libdnf: https://github.com/rpm-software-management/libdnf/
+//
+// Libdnf is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 2 of the License, or
+// (at your option) any later version.
+//
+// Libdnf is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
+
+
+#ifndef TEST_DNF5DAEMON_SERVER_UTILS_HPP
+#define TEST_DNF5DAEMON_SERVER_UTILS_HPP
+
+#include <cppunit/TestCase.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+class BufferedFdWriterTest : public CppUnit::TestCase {
+    CPPUNIT_TEST_SUITE(BufferedFdWriterTest);
+
+    CPPUNIT_TEST(test_write_batches);
+    CPPUNIT_TEST(test_flush);
+    CPPUNIT_TEST(test_pipe_size);
+    CPPUNIT_TEST(test_write_error);
+
+    CPPUNIT_TEST_SUITE_END();
+
+public:
+    void setUp() override;
+    void tearDown() override;
+
+    void test_write_batches();
+    void test_flush();
+    void test_pipe_size();
+    void test_write_error();
+
+private:
+    int read_fd{-1};
+    int write_fd{-1};
+};
+
+
+#endif  // TEST_DNF5DAEMON_SERVER_UTILS_HPP
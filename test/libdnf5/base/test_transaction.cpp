@@ -20,13 +20,23 @@
 
 #include "test_transaction.hpp"
 
+#include "../shared/private_accessor.hpp"
 #include "../shared/utils.hpp"
+#include "base/transaction_impl.hpp"
 
 #include <libdnf5/base/goal.hpp>
 
 
 CPPUNIT_TEST_SUITE_REGISTRATION(BaseTransactionTest);
 
+namespace {
+
+// Accessor of private Transaction::p_impl, see private_accessor.hpp
+create_private_getter_template;
+create_getter(transaction_impl, &libdnf5::base::Transaction::p_impl);
+
+}  // namespace
+
 void BaseTransactionTest::test_check_gpg_signatures_no_gpgcheck() {
     add_repo_repomd("repomd-repo1");
 
@@ -55,3 +65,99 @@ void BaseTransactionTest::test_check_gpg_signatures_fail() {
     CPPUNIT_ASSERT(!transaction.check_gpg_signatures());
     CPPUNIT_ASSERT(!transaction.get_gpg_signature_problems().empty());
 }
+
+void BaseTransactionTest::test_check_gpg_signatures_prechecked_ok() {
+    add_repo_repomd("repomd-repo1");
+
+    base.get_config().get_pkg_gpgcheck_option().set(true);
+
+    libdnf5::Goal goal(base);
+    goal.add_rpm_install("pkg");
+    auto transaction = goal.resolve();
+    CPPUNIT_ASSERT_EQUAL((size_t)1, transaction.get_transaction_packages_count());
+
+    // the signature was verified during the download, the result is reused
+    auto path = transaction.get_transaction_packages()[0].get_package().get_package_path();
+    (transaction.*get(transaction_impl{}))->prechecked_signatures[path] = libdnf5::rpm::RpmSignature::CheckResult::OK;
+
+    CPPUNIT_ASSERT(transaction.check_gpg_signatures());
+    CPPUNIT_ASSERT(transaction.get_gpg_signature_problems().empty());
+}
+
+void BaseTransactionTest::test_check_gpg_signatures_prechecked_failed() {
+    add_repo_repomd("repomd-repo1");
+
+    base.get_config().get_pkg_gpgcheck_option().set(true);
+
+    libdnf5::Goal goal(base);
+    goal.add_rpm_install("pkg");
+    auto transaction = goal.resolve();
+    CPPUNIT_ASSERT_EQUAL((size_t)1, transaction.get_transaction_packages_count());
+
+    // a failed check from the download is not trusted, the package is verified again (and fails, it is not signed)
+    auto path = transaction.get_transaction_packages()[0].get_package().get_package_path();
+    (transaction.*get(transaction_impl{}))->prechecked_signatures[path] =
+        libdnf5::rpm::RpmSignature::CheckResult::FAILED_KEY_MISSING;
+
+    CPPUNIT_ASSERT(!transaction.check_gpg_signatures());
+    auto problems = transaction.get_gpg_signature_problems();
+    CPPUNIT_ASSERT_EQUAL((size_t)1, problems.size());
+    CPPUNIT_ASSERT(problems[0].find(path) != std::string::npos);
+}
+
+void BaseTransactionTest::test_resolve_signature_check_results_shared_key() {
+    using CheckResult = libdnf5::rpm::RpmSignature::CheckResult;
+    using libdnf5::base::ImportRepoKeysResult;
+
+    // repo-a and repo-b are signed with the same key, it is imported only with the keys of repo-a
+    std::vector<std::string> repo_ids{"repo-a", "repo-b", "repo-b"};
+    std::vector<CheckResult> check_results{
+        CheckResult::FAILED_KEY_MISSING, CheckResult::FAILED_KEY_MISSING, CheckResult::FAILED_NOT_TRUSTED};
+    bool key_imported{false};
+    std::vector<std::size_t> checked;
+    std::vector<std::string> imported_repos;
+
+    auto problem = libdnf5::base::resolve_signature_check_results(
+        check_results,
+        repo_ids,
+        [&](std::size_t idx) {
+            checked.push_back(idx);
+            return key_imported ? CheckResult::OK : CheckResult::FAILED_KEY_MISSING;
+        },
+        [&](std::size_t idx) {
+            imported_repos.push_back(repo_ids[idx]);
+            key_imported = true;
+            return ImportRepoKeysResult::OK;
+        });
+
+    CPPUNIT_ASSERT(!problem);
+    CPPUNIT_ASSERT_EQUAL(std::vector<std::string>{"repo-a"}, imported_repos);
+    CPPUNIT_ASSERT_EQUAL((std::vector<std::size_t>{0, 1, 2}), checked);
+    CPPUNIT_ASSERT((std::vector<CheckResult>{CheckResult::OK, CheckResult::OK, CheckResult::OK}) == check_results);
+}
+
+void BaseTransactionTest::test_resolve_signature_check_results_wrong_key() {
+    using CheckResult = libdnf5::rpm::RpmSignature::CheckResult;
+    using libdnf5::base::ImportRepoKeysResult;
+
+    // importing the keys does not help, the keys of repo-a must not be imported twice
+    std::vector<std::string> repo_ids{"repo-a", "repo-a"};
+    std::vector<CheckResult> check_results{CheckResult::SKIPPED, CheckResult::FAILED_NOT_TRUSTED};
+    std::size_t import_count{0};
+
+    auto problem = libdnf5::base::resolve_signature_check_results(
+        check_results,
+        repo_ids,
+        [](std::size_t) { return CheckResult::FAILED_NOT_TRUSTED; },
+        [&](std::size_t) {
+            ++import_count;
+            return ImportRepoKeysResult::OK;
+        });
+
+    CPPUNIT_ASSERT(problem);
+    CPPUNIT_ASSERT_EQUAL((std::size_t)1, problem->package_idx);
+    CPPUNIT_ASSERT(problem->check_result == CheckResult::FAILED_NOT_TRUSTED);
+    CPPUNIT_ASSERT(problem->import_result == ImportRepoKeysResult::OK);
+    CPPUNIT_ASSERT_EQUAL((std::size_t)1, import_count);
+    CPPUNIT_ASSERT(check_results[0] == CheckResult::SKIPPED);
+}
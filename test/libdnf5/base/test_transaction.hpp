@@ -33,6 +33,10 @@ class BaseTransactionTest : public BaseTestCase {
 #ifndef WITH_PERFORMANCE_TESTS
     CPPUNIT_TEST(test_check_gpg_signatures_no_gpgcheck);
     CPPUNIT_TEST(test_check_gpg_signatures_fail);
+    CPPUNIT_TEST(test_check_gpg_signatures_prechecked_ok);
+    CPPUNIT_TEST(test_check_gpg_signatures_prechecked_failed);
+    CPPUNIT_TEST(test_resolve_signature_check_results_shared_key);
+    CPPUNIT_TEST(test_resolve_signature_check_results_wrong_key);
 #endif
 
 #ifdef WITH_PERFORMANCE_TESTS
@@ -43,6 +47,10 @@ class BaseTransactionTest : public BaseTestCase {
 public:
     void test_check_gpg_signatures_no_gpgcheck();
     void test_check_gpg_signatures_fail();
+    void test_check_gpg_signatures_prechecked_ok();
+    void test_check_gpg_signatures_prechecked_failed();
+    void test_resolve_signature_check_results_shared_key();
+    void test_resolve_signature_check_results_wrong_key();
 };
 
 
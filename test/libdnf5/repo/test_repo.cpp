@@ -19,11 +19,31 @@
 
 #include "test_repo.hpp"
 
+#include "../shared/logger_redirector.hpp"
 #include "../shared/private_accessor.hpp"
+#include "../shared/test_logger.hpp"
+#include "../shared/utils.hpp"
+#include "repo/solv_repo.hpp"
 #include "utils/string.hpp"
 
 #include <libdnf5/base/base.hpp>
+#include <libdnf5/conf/const.hpp>
 #include <libdnf5/repo/repo_errors.hpp>
+#include <libdnf5/rpm/package_query.hpp>
+#include <rpm/rpmts.h>
+#include <solv/chksum.h>
+#include <solv/knownid.h>
+#include <solv/util.h>
+
+#include <fmt/format.h>
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <vector>
 
 
 CPPUNIT_TEST_SUITE_REGISTRATION(RepoTest);
@@ -33,6 +53,166 @@ namespace {
 // Accessor of private Base::p_impl, see private_accessor.hpp
 create_private_getter_template;
 create_getter(load, &libdnf5::repo::Repo::load);
+create_getter(solv_file_path, &libdnf5::repo::SolvRepo::solv_file_path);
+create_getter(write_main, &libdnf5::repo::SolvRepo::write_main);
+create_getter(write_cache_file_async, &libdnf5::repo::SolvRepo::write_cache_file_async);
+create_getter(wait_for_cache_writes, &libdnf5::repo::SolvRepo::wait_for_cache_writes);
+
+// Creates another Base sharing the installroot and the cachedir with `base`, it simulates the next run.
+std::unique_ptr<libdnf5::Base> create_next_run_base(libdnf5::Base & base) {
+    auto next_base = std::make_unique<libdnf5::Base>();
+    next_base->get_logger()->add_logger(std::make_unique<LoggerRedirector>(test_logger));
+    auto & config = next_base->get_config();
+    config.get_installroot_option().set(base.get_config().get_installroot_option().get_value());
+    config.get_cachedir_option().set(base.get_config().get_cachedir_option().get_value());
+    config.get_optional_metadata_types_option().set(libdnf5::OPTIONAL_METADATA_TYPES);
+    config.get_plugins_option().set(false);
+    next_base->get_vars()->set("arch", "x86_64");
+    next_base->setup();
+    return next_base;
+}
+
+// Creates an empty rpmdb in the installroot, the rpmdb cookie is then available.
+void create_rpmdb(libdnf5::Base & base) {
+    auto * ts = rpmtsCreate();
+    rpmtsSetRootDir(ts, base.get_config().get_installroot_option().get_value().c_str());
+    auto rc = rpmtsInitDB(ts, 0644);
+    rpmtsFree(ts);
+    CPPUNIT_ASSERT_EQUAL(0, rc);
+}
+
+// @return whether a message containing `text` was logged since the `first_item` log item.
+bool is_logged(std::size_t first_item, const std::string & text) {
+    for (std::size_t idx = first_item; idx < test_logger.get_items_count(); ++idx) {
+        if (test_logger.get_item(idx).message.find(text) != std::string::npos) {
+            return true;
+        }
+    }
+    return false;
+}
+
+std::string read_file(const std::filesystem::path & path) {
+    std::ifstream file(path, std::ios::binary);
+    return std::string(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+}
+
+libdnf5::repo::SerializedSolvCache create_serialized_cache(const std::string & data) {
+    libdnf5::repo::SerializedSolvCache cache;
+    cache.buffer.reset(static_cast<char *>(malloc(data.size())));
+    memcpy(cache.buffer.get(), data.data(), data.size());
+    cache.size = data.size();
+    return cache;
+}
+
+// @return the hex encoded sha256 digest of `data`.
+std::string sha256_hex(const std::string & data) {
+    auto * chksum = solv_chksum_create(REPOKEY_TYPE_SHA256);
+    solv_chksum_add(chksum, data.data(), static_cast<int>(data.size()));
+    int digest_len = 0;
+    auto * digest = solv_chksum_get(chksum, &digest_len);
+    std::string hex(static_cast<std::size_t>(digest_len) * 2 + 1, '\0');
+    solv_bin2hex(digest, digest_len, hex.data());
+    solv_chksum_free(chksum, nullptr);
+    hex.pop_back();
+    return hex;
+}
+
+// Returns the primary.xml element of package "pkg<idx>" containing the file "/usr/bin/pkg<idx>".
+// "pkg0" requires "/usr/bin/pkg<required_idx>", which makes the file a file provide of the required package.
+std::string create_primary_package(unsigned idx, unsigned required_idx) {
+    std::string requires_element;
+    if (idx == 0) {
+        requires_element = fmt::format(
+            "    <rpm:requires>\n"
+            "      <rpm:entry name=\"/usr/bin/pkg{}\"/>\n"
+            "    </rpm:requires>\n",
+            required_idx);
+    }
+    return fmt::format(
+        "<package type=\"rpm\">\n"
+        "  <name>pkg{0}</name>\n"
+        "  <arch>x86_64</arch>\n"
+        "  <version epoch=\"0\" ver=\"1.0\" rel=\"1\"/>\n"
+        "  <checksum type=\"sha256\" pkgid=\"YES\">{1:064x}</checksum>\n"
+        "  <summary>Package {0}</summary>\n"
+        "  <description>Package {0}</description>\n"
+        "  <packager></packager>\n"
+        "  <url></url>\n"
+        "  <time file=\"1\" build=\"1\"/>\n"
+        "  <size package=\"1\" installed=\"1\" archive=\"1\"/>\n"
+        "  <location href=\"pkg{0}-1.0-1.x86_64.rpm\"/>\n"
+        "  <format>\n"
+        "    <rpm:license>MIT</rpm:license>\n"
+        "    <rpm:provides>\n"
+        "      <rpm:entry name=\"pkg{0}\" flags=\"EQ\" epoch=\"0\" ver=\"1.0\" rel=\"1\"/>\n"
+        "    </rpm:provides>\n"
+        "{2}"
+        "    <file>/usr/bin/pkg{0}</file>\n"
+        "  </format>\n"
+        "</package>\n",
+        idx,
+        idx + 1,
+        requires_element);
+}
+
+// Writes a repository with the packages created by create_primary_package() to `repo_path`.
+// Each call needs a different `revision` for the repository to be considered changed.
+void write_repomd_repo(
+    const std::filesystem::path & repo_path,
+    const std::vector<unsigned> & package_indices,
+    unsigned required_idx,
+    unsigned revision) {
+    std::string primary = fmt::format(
+        "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+        "<metadata xmlns=\"http://linux.duke.edu/metadata/common\" "
+        "xmlns:rpm=\"http://linux.duke.edu/metadata/rpm\" packages=\"{}\">\n",
+        package_indices.size());
+    for (auto idx : package_indices) {
+        primary += create_primary_package(idx, required_idx);
+    }
+    primary += "</metadata>\n";
+
+    auto primary_checksum = sha256_hex(primary);
+    std::string repomd = fmt::format(
+        "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+        "<repomd xmlns=\"http://linux.duke.edu/metadata/repo\" xmlns:rpm=\"http://linux.duke.edu/metadata/rpm\">\n"
+        "  <revision>{0}</revision>\n"
+        "  <data type=\"primary\">\n"
+        "    <checksum type=\"sha256\">{1}</checksum>\n"
+        "    <open-checksum type=\"sha256\">{1}</open-checksum>\n"
+        "    <location href=\"repodata/primary.xml\"/>\n"
+        "    <timestamp>{0}</timestamp>\n"
+        "    <size>{2}</size>\n"
+        "    <open-size>{2}</open-size>\n"
+        "  </data>\n"
+        "</repomd>\n",
+        revision,
+        primary_checksum,
+        primary.size());
+
+    std::filesystem::create_directories(repo_path / "repodata");
+    std::ofstream(repo_path / "repodata" / "primary.xml", std::ios::binary) << primary;
+    std::ofstream(repo_path / "repodata" / "repomd.xml", std::ios::binary) << repomd;
+}
+
+// Loads `repo` in the next run, the expired metadata are downloaded again from its baseurl.
+libdnf5::repo::RepoWeakPtr load_repo_in_next_run(libdnf5::Base & next_base, libdnf5::repo::Repo & repo) {
+    auto next_repo_sack = next_base.get_repo_sack();
+    auto next_repo = next_repo_sack->create_repo(repo.get_id());
+    next_repo->get_config().get_baseurl_option().set(repo.get_config().get_baseurl_option().get_value());
+    next_repo->expire();
+    next_repo_sack->load_repos(libdnf5::repo::Repo::Type::AVAILABLE);
+    return next_repo;
+}
+
+std::vector<std::string> get_package_names(libdnf5::Base & base) {
+    std::vector<std::string> names;
+    for (const auto & pkg : libdnf5::rpm::PackageQuery(base)) {
+        names.push_back(pkg.get_name());
+    }
+    std::sort(names.begin(), names.end());
+    return names;
+}
 
 class DownloadCallbacks : public libdnf5::repo::DownloadCallbacks {
 public:
@@ -107,6 +287,239 @@ void RepoTest::test_load_system_repo() {
     (*(repo_sack->get_system_repo()).*get(load{}))();
 }
 
+void RepoTest::test_system_repo_solv_cache() {
+    create_rpmdb(base);
+
+    // the first run reads the rpmdb and writes the cache
+    auto system_repo = repo_sack->get_system_repo();
+    (*system_repo.*get(load{}))();
+    auto cache_path = (system_repo->get_solv_repo().*get(solv_file_path{}))(nullptr);
+    CPPUNIT_ASSERT(std::filesystem::exists(cache_path));
+    CPPUNIT_ASSERT(system_repo->is_loaded_data_current());
+    auto cache_time = std::filesystem::last_write_time(cache_path) - std::chrono::hours(1);
+    std::filesystem::last_write_time(cache_path, cache_time);
+
+    // the next run with the same rpmdb cookie loads the cache and does not rewrite it
+    auto first_log_item = test_logger.get_items_count();
+    auto next_base = create_next_run_base(base);
+    auto next_system_repo = next_base->get_repo_sack()->get_system_repo();
+    (*next_system_repo.*get(load{}))();
+    CPPUNIT_ASSERT(is_logged(first_log_item, "Loading solv cache file: \"" + cache_path.native() + "\""));
+    CPPUNIT_ASSERT(cache_time == std::filesystem::last_write_time(cache_path));
+    CPPUNIT_ASSERT(next_system_repo->is_loaded_data_current());
+}
+
+void RepoTest::test_system_repo_solv_cache_cookie_changed() {
+    create_rpmdb(base);
+
+    auto system_repo = repo_sack->get_system_repo();
+    (*system_repo.*get(load{}))();
+    auto & solv_repo = system_repo->get_solv_repo();
+    auto cache_path = (solv_repo.*get(solv_file_path{}))(nullptr);
+    auto current_cache = read_file(cache_path);
+
+    // rewrite the cache as if it was written for a different rpmdb cookie
+    solv_repo.checksum[0] ^= 0xFF;
+    (solv_repo.*get(write_main{}))(false);
+    auto outdated_cache = read_file(cache_path);
+    CPPUNIT_ASSERT(outdated_cache != current_cache);
+
+    // the next run does not use the outdated cache, it reads the rpmdb and refreshes the cache
+    auto first_log_item = test_logger.get_items_count();
+    auto next_base = create_next_run_base(base);
+    auto next_system_repo = next_base->get_repo_sack()->get_system_repo();
+    (*next_system_repo.*get(load{}))();
+    CPPUNIT_ASSERT(!is_logged(first_log_item, "Loading solv cache file: \"" + cache_path.native() + "\""));
+    CPPUNIT_ASSERT(read_file(cache_path) != outdated_cache);
+    CPPUNIT_ASSERT(next_system_repo->is_loaded_data_current());
+}
+
+void RepoTest::test_filelists_cache_loaded_on_demand() {
+    // the first run parses the file lists and writes their cache
+    auto repo = add_repo_repomd("repomd-repo1");
+    auto filelists_cache = (repo->get_solv_repo().*get(solv_file_path{}))("filelists");
+    CPPUNIT_ASSERT(std::filesystem::exists(filelists_cache));
+    const std::string loading_message = "Loading solv cache file: \"" + filelists_cache.native() + "\"";
+
+    // the next run only attaches the cache
+    auto first_log_item = test_logger.get_items_count();
+    auto next_base = create_next_run_base(base);
+    auto next_repo_sack = next_base->get_repo_sack();
+    auto next_repo = next_repo_sack->create_repo("repomd-repo1");
+    next_repo->get_config().get_baseurl_option().set(repo->get_config().get_baseurl_option().get_value());
+    next_repo_sack->load_repos(libdnf5::repo::Repo::Type::AVAILABLE);
+    CPPUNIT_ASSERT(is_logged(first_log_item, "cache file \"" + filelists_cache.native() + "\" to be loaded on demand"));
+    CPPUNIT_ASSERT(!is_logged(first_log_item, loading_message));
+
+    // queries that do not need the file lists do not load them
+    libdnf5::rpm::PackageQuery name_query(*next_base);
+    name_query.filter_name("pkg");
+    CPPUNIT_ASSERT_EQUAL((size_t)1, name_query.size());
+    CPPUNIT_ASSERT(!is_logged(first_log_item, loading_message));
+
+    // the first file query loads the file lists, the file is not in the primary file list
+    libdnf5::rpm::PackageQuery file_query(*next_base);
+    file_query.filter_file("/etc/pkg.conf");
+    CPPUNIT_ASSERT(is_logged(first_log_item, loading_message));
+    CPPUNIT_ASSERT_EQUAL((size_t)1, file_query.size());
+    CPPUNIT_ASSERT_EQUAL(std::string("pkg"), (*file_query.begin()).get_name());
+}
+
+void RepoTest::test_main_cache_update_added_packages() {
+    // the first run writes the cache of a repo with 10 packages, "pkg0" requires a file of the missing "pkg10"
+    auto repo_path = temp_dir->get_path() / "repo";
+    std::vector<unsigned> packages{0, 1, 2, 3, 4, 5, 6, 7, 8, 9};
+    write_repomd_repo(repo_path, packages, 10, 1);
+    auto repo = add_repo("repo", repo_path);
+    auto cache_path = (repo->get_solv_repo().*get(solv_file_path{}))(nullptr);
+    const std::string loading_message = "Loading solv cache file: \"" + cache_path.native() + "\"";
+
+    // the next run adds "pkg10" to the stale cache and loads the updated cache
+    packages.push_back(10);
+    write_repomd_repo(repo_path, packages, 10, 2);
+    auto first_log_item = test_logger.get_items_count();
+    auto next_base = create_next_run_base(base);
+    load_repo_in_next_run(*next_base, *repo);
+    CPPUNIT_ASSERT(is_logged(first_log_item, "Updating primary cache for repo \"repo\": 1 packages added, 0 removed"));
+    CPPUNIT_ASSERT(is_logged(first_log_item, loading_message));
+    std::vector<std::string> expected{
+        "pkg0", "pkg1", "pkg10", "pkg2", "pkg3", "pkg4", "pkg5", "pkg6", "pkg7", "pkg8", "pkg9"};
+    CPPUNIT_ASSERT_EQUAL(expected, get_package_names(*next_base));
+
+    // computing the provides adds the file provide of the added package and rewrites the cache
+    next_base->get_repo_sack()->build_solv_caches();
+
+    // the file provide is stored in the rewritten cache
+    first_log_item = test_logger.get_items_count();
+    auto third_base = create_next_run_base(base);
+    auto third_repo_sack = third_base->get_repo_sack();
+    auto third_repo = third_repo_sack->create_repo("repo");
+    third_repo->get_config().get_baseurl_option().set(repo->get_config().get_baseurl_option().get_value());
+    third_repo_sack->load_repos(libdnf5::repo::Repo::Type::AVAILABLE);
+    CPPUNIT_ASSERT(is_logged(first_log_item, loading_message));
+    CPPUNIT_ASSERT(!is_logged(first_log_item, "Updating primary cache"));
+    libdnf5::rpm::PackageQuery query(*third_base);
+    query.filter_name("pkg10");
+    CPPUNIT_ASSERT_EQUAL((size_t)1, query.size());
+    std::vector<std::string> provides;
+    for (const auto & reldep : (*query.begin()).get_provides()) {
+        provides.push_back(reldep.to_string());
+    }
+    CPPUNIT_ASSERT(std::find(provides.begin(), provides.end(), "/usr/bin/pkg10") != provides.end());
+}
+
+void RepoTest::test_main_cache_update_removed_packages() {
+    auto repo_path = temp_dir->get_path() / "repo";
+    write_repomd_repo(repo_path, {0, 1, 2, 3, 4, 5, 6, 7, 8, 9}, 9, 1);
+    auto repo = add_repo("repo", repo_path);
+    // the file provide of the removed package is stored in the cache
+    repo_sack->build_solv_caches();
+
+    // the next run removes "pkg8" and "pkg9" from the stale cache
+    write_repomd_repo(repo_path, {0, 1, 2, 3, 4, 5, 6, 7}, 9, 2);
+    auto first_log_item = test_logger.get_items_count();
+    auto next_base = create_next_run_base(base);
+    load_repo_in_next_run(*next_base, *repo);
+    CPPUNIT_ASSERT(is_logged(first_log_item, "Updating primary cache for repo \"repo\": 0 packages added, 2 removed"));
+    std::vector<std::string> expected{"pkg0", "pkg1", "pkg2", "pkg3", "pkg4", "pkg5", "pkg6", "pkg7"};
+    CPPUNIT_ASSERT_EQUAL(expected, get_package_names(*next_base));
+
+    // nothing provides the file of the removed package
+    libdnf5::rpm::PackageQuery query(*next_base);
+    query.filter_provides(std::vector<std::string>{"/usr/bin/pkg9"});
+    CPPUNIT_ASSERT(query.empty());
+}
+
+void RepoTest::test_main_cache_update_too_many_changes() {
+    auto repo_path = temp_dir->get_path() / "repo";
+    write_repomd_repo(repo_path, {0, 1, 2, 3, 4, 5, 6, 7, 8, 9}, 10, 1);
+    auto repo = add_repo("repo", repo_path);
+
+    // replacing 3 of 10 packages changes more than a quarter of the repo, the cache is rebuilt from scratch
+    write_repomd_repo(repo_path, {0, 1, 2, 3, 4, 5, 6, 10, 11, 12}, 10, 2);
+    auto first_log_item = test_logger.get_items_count();
+    auto next_base = create_next_run_base(base);
+    load_repo_in_next_run(*next_base, *repo);
+    CPPUNIT_ASSERT(is_logged(first_log_item, "Too many changed packages in repo \"repo\" (3 added, 3 removed)"));
+    CPPUNIT_ASSERT(!is_logged(first_log_item, "Updating primary cache"));
+    std::vector<std::string> expected{
+        "pkg0", "pkg1", "pkg10", "pkg11", "pkg12", "pkg2", "pkg3", "pkg4", "pkg5", "pkg6"};
+    CPPUNIT_ASSERT_EQUAL(expected, get_package_names(*next_base));
+}
+
+void RepoTest::test_build_solv_caches() {
+    // "pkg0" requires the file of "pkg9", the file provide is not in the cache written by loading the repo
+    auto repo_path = temp_dir->get_path() / "repo";
+    write_repomd_repo(repo_path, {0, 1, 2, 3, 4, 5, 6, 7, 8, 9}, 9, 1);
+    auto repo = add_repo("repo", repo_path);
+    auto cache_path = (repo->get_solv_repo().*get(solv_file_path{}))(nullptr);
+    auto loaded_cache = read_file(cache_path);
+
+    repo_sack->build_solv_caches();
+    auto built_cache = read_file(cache_path);
+    CPPUNIT_ASSERT(built_cache != loaded_cache);
+
+    // the next run loads the completed cache, the file provide is there before anything computes the provides
+    auto first_log_item = test_logger.get_items_count();
+    auto next_base = create_next_run_base(base);
+    auto next_repo_sack = next_base->get_repo_sack();
+    auto next_repo = next_repo_sack->create_repo("repo");
+    next_repo->get_config().get_baseurl_option().set(repo->get_config().get_baseurl_option().get_value());
+    next_repo_sack->load_repos(libdnf5::repo::Repo::Type::AVAILABLE);
+    CPPUNIT_ASSERT(is_logged(first_log_item, "Loading solv cache file: \"" + cache_path.native() + "\""));
+    libdnf5::rpm::PackageQuery query(*next_base);
+    query.filter_name("pkg9");
+    CPPUNIT_ASSERT_EQUAL((size_t)1, query.size());
+    std::vector<std::string> provides;
+    for (const auto & reldep : (*query.begin()).get_provides()) {
+        provides.push_back(reldep.to_string());
+    }
+    CPPUNIT_ASSERT(std::find(provides.begin(), provides.end(), "/usr/bin/pkg9") != provides.end());
+
+    // the cache is complete, building it again does not rewrite it
+    next_repo_sack->build_solv_caches();
+    CPPUNIT_ASSERT(read_file(cache_path) == built_cache);
+}
+
+void RepoTest::test_build_solv_caches_provides_ready() {
+    auto repo_path = temp_dir->get_path() / "repo";
+    write_repomd_repo(repo_path, {0, 1, 2, 3, 4, 5, 6, 7, 8, 9}, 9, 1);
+    auto repo = add_repo("repo", repo_path);
+    auto cache_path = (repo->get_solv_repo().*get(solv_file_path{}))(nullptr);
+    auto loaded_cache = read_file(cache_path);
+
+    // a query computing the provides completes the cache already
+    libdnf5::rpm::PackageQuery query(base);
+    query.filter_provides(std::vector<std::string>{"/usr/bin/pkg9"});
+    CPPUNIT_ASSERT_EQUAL((size_t)1, query.size());
+    auto completed_cache = read_file(cache_path);
+    CPPUNIT_ASSERT(completed_cache != loaded_cache);
+
+    // there is nothing left to write
+    repo_sack->build_solv_caches();
+    CPPUNIT_ASSERT(read_file(cache_path) == completed_cache);
+}
+
+void RepoTest::test_cache_write_errors() {
+    auto repo = add_repo_repomd("repomd-repo1");
+    auto & solv_repo = repo->get_solv_repo();
+    auto cache_dir = temp_dir->get_path() / "cache_writes";
+    std::filesystem::create_directory(cache_dir);
+
+    // the first write fails, its directory does not exist
+    (solv_repo.*get(write_cache_file_async{}))(
+        cache_dir / "missing" / "failed.solv", create_serialized_cache("failed"));
+    (solv_repo.*get(write_cache_file_async{}))(cache_dir / "written.solv", create_serialized_cache("written"));
+
+    // all the writes are finished and the first error is reported
+    CPPUNIT_ASSERT_THROW((solv_repo.*get(wait_for_cache_writes{}))(), libdnf5::FileSystemError);
+    CPPUNIT_ASSERT_EQUAL(std::string("written"), read_file(cache_dir / "written.solv"));
+    CPPUNIT_ASSERT(!std::filesystem::exists(cache_dir / "missing"));
+
+    // the error is reported only once
+    (solv_repo.*get(wait_for_cache_writes{}))();
+}
+
 void RepoTest::test_load_repo() {
     std::string repoid("repomd-repo1");
     auto repo = add_repo_repomd(repoid, false);
@@ -28,6 +28,15 @@
 class RepoTest : public BaseTestCase {
     CPPUNIT_TEST_SUITE(RepoTest);
     CPPUNIT_TEST(test_load_system_repo);
+    CPPUNIT_TEST(test_system_repo_solv_cache);
+    CPPUNIT_TEST(test_system_repo_solv_cache_cookie_changed);
+    CPPUNIT_TEST(test_filelists_cache_loaded_on_demand);
+    CPPUNIT_TEST(test_main_cache_update_added_packages);
+    CPPUNIT_TEST(test_main_cache_update_removed_packages);
+    CPPUNIT_TEST(test_main_cache_update_too_many_changes);
+    CPPUNIT_TEST(test_build_solv_caches);
+    CPPUNIT_TEST(test_build_solv_caches_provides_ready);
+    CPPUNIT_TEST(test_cache_write_errors);
     CPPUNIT_TEST(test_load_repo);
     CPPUNIT_TEST(test_load_repo_nonexistent);
     CPPUNIT_TEST(test_load_repos_twice_fails);
@@ -38,6 +47,15 @@ class RepoTest : public BaseTestCase {
 
 public:
     void test_load_system_repo();
+    void test_system_repo_solv_cache();
+    void test_system_repo_solv_cache_cookie_changed();
+    void test_filelists_cache_loaded_on_demand();
+    void test_main_cache_update_added_packages();
+    void test_main_cache_update_removed_packages();
+    void test_main_cache_update_too_many_changes();
+    void test_build_solv_caches();
+    void test_build_solv_caches_provides_ready();
+    void test_cache_write_errors();
     void test_load_repo();
     void test_load_repo_nonexistent();
     void test_load_repos_twice_fails();
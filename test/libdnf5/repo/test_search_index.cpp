@@ -0,0 +1,140 @@
+// Copyright Contributors to the DNF5 project.
+// Copyright Contributors to the libdnf project.
+// SPDX-License-Identifier: LGPL-2.1-or-later
+//
+// This file is part of libdnf: https://github.com/rpm-software-management/libdnf/
+//
+// Libdnf is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 2.1 of the License, or
+// (at your option) any later version.
+//
+// Libdnf is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
+
+#include "test_search_index.hpp"
+
+#include "repo/search_index.hpp"
+
+#include "libdnf5/utils/fs/temp.hpp"
+
+#include <array>
+#include <fstream>
+
+
+CPPUNIT_TEST_SUITE_REGISTRATION(SearchIndexTest);
+
+using namespace libdnf5::repo;
+
+namespace {
+
+constexpr std::array<unsigned char, SEARCH_INDEX_CHECKSUM_BYTES> CHECKSUM{1, 2, 3};
+
+std::filesystem::path write_index(const libdnf5::utils::fs::TempDir & temp_dir) {
+    SearchIndexBuilder builder;
+    builder.add(0, "Package manager");
+    builder.add(0, "https://github.com/rpm-software-management/dnf5");
+    builder.add(1, "Library providing simplified C and Python API to libsolv");
+    builder.add(3, "A managed PACKAGE");
+    // rank 2 has no indexed strings
+    auto path = temp_dir.get_path() / "repo-search.idx";
+    builder.write(path, CHECKSUM.data(), 4);
+    return path;
+}
+
+// Replaces the last `count` bytes of the file, the postings are stored at the end of the index.
+void corrupt_tail(const std::filesystem::path & path, std::size_t count) {
+    auto size = std::filesystem::file_size(path);
+    std::fstream file(path, std::ios::in | std::ios::out | std::ios::binary);
+    file.seekp(static_cast<std::streamoff>(size - count));
+    // a varint continuation byte without the final byte
+    for (std::size_t i = 0; i < count; ++i) {
+        file.put(static_cast<char>(0x80));
+    }
+}
+
+}  // namespace
+
+
+void SearchIndexTest::test_find_candidates() {
+    libdnf5::utils::fs::TempDir temp_dir("libdnf_unittest_search_index");
+    SearchIndex index(write_index(temp_dir));
+    CPPUNIT_ASSERT(index.is_valid(CHECKSUM.data(), 4));
+
+    // case insensitive
+    CPPUNIT_ASSERT((std::vector<std::uint32_t>{0, 3}) == index.find_candidates("package").value());
+    CPPUNIT_ASSERT((std::vector<std::uint32_t>{0, 3}) == index.find_candidates("MANAGE").value());
+    CPPUNIT_ASSERT((std::vector<std::uint32_t>{0}) == index.find_candidates("github").value());
+    CPPUNIT_ASSERT((std::vector<std::uint32_t>{1}) == index.find_candidates("python api").value());
+
+    // a trigram which is not in the index
+    CPPUNIT_ASSERT(index.find_candidates("xyz").value().empty());
+
+    // all trigrams are present, but not in the same package
+    CPPUNIT_ASSERT(index.find_candidates("libpackage").value().empty());
+
+    // the index only rules out packages, "packaged" is not a substring, but all its trigrams are present
+    CPPUNIT_ASSERT((std::vector<std::uint32_t>{3}) == index.find_candidates("packaged").value());
+}
+
+
+void SearchIndexTest::test_short_substring() {
+    libdnf5::utils::fs::TempDir temp_dir("libdnf_unittest_search_index");
+    SearchIndex index(write_index(temp_dir));
+
+    CPPUNIT_ASSERT(!index.find_candidates("").has_value());
+    CPPUNIT_ASSERT(!index.find_candidates("pa").has_value());
+}
+
+
+void SearchIndexTest::test_is_valid() {
+    libdnf5::utils::fs::TempDir temp_dir("libdnf_unittest_search_index");
+    SearchIndex index(write_index(temp_dir));
+
+    auto other_checksum = CHECKSUM;
+    other_checksum[0] = 0;
+    CPPUNIT_ASSERT(!index.is_valid(other_checksum.data(), 4));
+    CPPUNIT_ASSERT(!index.is_valid(CHECKSUM.data(), 5));
+
+    libdnf5::utils::fs::File(temp_dir.get_path() / "truncated.idx", "w").write(std::string_view("\0dnfsidx", 8));
+    SearchIndex truncated_index(temp_dir.get_path() / "truncated.idx");
+    CPPUNIT_ASSERT(!truncated_index.is_valid(CHECKSUM.data(), 4));
+}
+
+
+void SearchIndexTest::test_corrupted_postings() {
+    libdnf5::utils::fs::TempDir temp_dir("libdnf_unittest_search_index");
+
+    // the only trigram of the substring has truncated postings
+    {
+        SearchIndexBuilder builder;
+        builder.add(0, "abc");
+        auto path = temp_dir.get_path() / "single.idx";
+        builder.write(path, CHECKSUM.data(), 1);
+        corrupt_tail(path, 1);
+
+        SearchIndex index(path);
+        CPPUNIT_ASSERT(index.is_valid(CHECKSUM.data(), 1));
+        CPPUNIT_ASSERT(!index.find_candidates("abc").has_value());
+    }
+
+    // the postings of the trigram "bcd" are truncated, they are intersected with the postings of "abc"
+    {
+        SearchIndexBuilder builder;
+        builder.add(0, "abcd");
+        builder.add(1, "abcd");
+        auto path = temp_dir.get_path() / "intersection.idx";
+        builder.write(path, CHECKSUM.data(), 2);
+        corrupt_tail(path, 1);
+
+        SearchIndex index(path);
+        CPPUNIT_ASSERT(index.is_valid(CHECKSUM.data(), 2));
+        CPPUNIT_ASSERT((std::vector<std::uint32_t>{0, 1}) == index.find_candidates("abc").value());
+        CPPUNIT_ASSERT(!index.find_candidates("abcd").has_value());
+    }
+}
@@ -0,0 +1,42 @@
+// Copyright Contributors to the DNF5 project.
+// Copyright Contributors to the libdnf project.
+// SPDX-License-Identifier: LGPL-2.1-or-later
+//
+// This file is part of libdnf: https://github.com/rpm-software-management/libdnf/
+//
+// Libdnf is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 2.1 of the License, or
+// (at your option) any later version.
+//
+// Libdnf is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
+
+#ifndef LIBDNF5_TEST_REPO_SEARCH_INDEX_HPP
+#define LIBDNF5_TEST_REPO_SEARCH_INDEX_HPP
+
+#include <cppunit/TestCase.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+
+class SearchIndexTest : public CppUnit::TestCase {
+    CPPUNIT_TEST_SUITE(SearchIndexTest);
+    CPPUNIT_TEST(test_find_candidates);
+    CPPUNIT_TEST(test_short_substring);
+    CPPUNIT_TEST(test_is_valid);
+    CPPUNIT_TEST(test_corrupted_postings);
+    CPPUNIT_TEST_SUITE_END();
+
+public:
+    void test_find_candidates();
+    void test_short_substring();
+    void test_is_valid();
+    void test_corrupted_postings();
+};
+
+#endif  // LIBDNF5_TEST_REPO_SEARCH_INDEX_HPP
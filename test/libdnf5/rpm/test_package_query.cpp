@@ -22,6 +22,7 @@
 
 #include "../shared/private_accessor.hpp"
 #include "../shared/utils.hpp"
+#include "solv/pool.hpp"
 
 #include <libdnf5/rpm/package_query.hpp>
 #include <libdnf5/rpm/package_set.hpp>
@@ -227,6 +228,39 @@ void RpmPackageQueryTest::test_filter_earliest_evr_ignore_arch() {
     }
 }
 
+void RpmPackageQueryTest::test_filter_evr_ranks_repo_added() {
+    add_repo_solv("solv-repo1");
+
+    {
+        PackageQuery query(base);
+        query.filter_latest_evr_any_arch(1);
+        std::vector<Package> expected = {
+            get_pkg("pkg-0:1.2-3.src"), get_pkg("pkg-0:1.2-3.x86_64"), get_pkg("pkg-libs-1:1.3-4.x86_64")};
+        CPPUNIT_ASSERT_EQUAL(expected, to_vector(query));
+    }
+
+    // the EVRs of the packages named "pkg" are ranked again together with the packages of the new repository
+    add_repo_solv("solv-24pkgs");
+
+    {
+        PackageQuery query(base);
+        query.filter_earliest_evr_any_arch(1);
+        std::vector<Package> expected = {get_pkg("pkg-libs-0:1.2-3.x86_64"), get_pkg("pkg-0:1-1.noarch")};
+        CPPUNIT_ASSERT_EQUAL(expected, to_vector(query));
+    }
+    {
+        PackageQuery pkgs(base);
+        pkgs.filter_nevra("pkg-0:1-24.noarch");
+
+        PackageQuery query(base);
+        query.filter_name("pkg");
+        query.filter_arch("noarch");
+        query.filter_nevra(pkgs, libdnf5::sack::QueryCmp::GTE);
+        std::vector<Package> expected = {get_pkg("pkg-0:1-24.noarch")};
+        CPPUNIT_ASSERT_EQUAL(expected, to_vector(query));
+    }
+}
+
 void RpmPackageQueryTest::test_filter_name() {
     add_repo_solv("solv-repo1");
 
@@ -347,6 +381,78 @@ void RpmPackageQueryTest::test_filter_name_packgset() {
     CPPUNIT_ASSERT_EQUAL(expected2, to_vector(query2));
 }
 
+void RpmPackageQueryTest::test_filter_name_repo_added() {
+    add_repo_solv("solv-repo1");
+
+    // build the sorted package index for the first repo
+    PackageQuery query1(base);
+    query1.filter_name("pkg");
+    std::vector<Package> expected = {get_pkg("pkg-0:1.2-3.src"), get_pkg("pkg-0:1.2-3.x86_64")};
+    CPPUNIT_ASSERT_EQUAL(expected, to_vector(query1));
+
+    PackageQuery query1_icase(base);
+    query1_icase.filter_name("PKG", libdnf5::sack::QueryCmp::IEXACT);
+    CPPUNIT_ASSERT_EQUAL(expected, to_vector(query1_icase));
+
+    // packages of a repo loaded later are merged into the existing index
+    add_repo_solv("solv-24pkgs");
+
+    PackageQuery query2(base);
+    query2.filter_name("pkg");
+    CPPUNIT_ASSERT_EQUAL((size_t)26, query2.size());
+
+    PackageQuery query2_icase(base);
+    query2_icase.filter_name("PKG", libdnf5::sack::QueryCmp::IEXACT);
+    CPPUNIT_ASSERT_EQUAL((size_t)26, query2_icase.size());
+
+    PackageQuery query3(base);
+    query3.filter_nevra("pkg-0:1-24.noarch");
+    expected = {get_pkg("pkg-0:1-24.noarch")};
+    CPPUNIT_ASSERT_EQUAL(expected, to_vector(query3));
+
+    PackageQuery query4(base);
+    query4.filter_name("pkg-libs");
+    CPPUNIT_ASSERT_EQUAL((size_t)3, query4.size());
+}
+
+void RpmPackageQueryTest::test_filter_name_pool_reallocated() {
+    add_repo_solv("solv-repo1");
+
+    // build the sorted package indexes while the pool has room for only a few solvables
+    PackageQuery query1(base);
+    query1.filter_name("pkg");
+    std::vector<Package> expected = {get_pkg("pkg-0:1.2-3.src"), get_pkg("pkg-0:1.2-3.x86_64")};
+    CPPUNIT_ASSERT_EQUAL(expected, to_vector(query1));
+
+    PackageQuery query1_icase(base);
+    query1_icase.filter_name("PKG", libdnf5::sack::QueryCmp::IEXACT);
+    CPPUNIT_ASSERT_EQUAL(expected, to_vector(query1_icase));
+
+    // the 1000 packages make libsolv reallocate the solvables, the indexes must not refer to the old ones
+    add_repo_solv("solv-humongous");
+
+    PackageQuery query2(base);
+    query2.filter_name("pkg");
+    CPPUNIT_ASSERT_EQUAL(expected, to_vector(query2));
+
+    PackageQuery query2_icase(base);
+    query2_icase.filter_name("PKG-A", libdnf5::sack::QueryCmp::IEXACT);
+    CPPUNIT_ASSERT_EQUAL((size_t)100, query2_icase.size());
+
+    PackageQuery query3(base);
+    query3.filter_nevra("pkg-j-0:10-10.noarch");
+    expected = {get_pkg("pkg-j-0:10-10.noarch")};
+    CPPUNIT_ASSERT_EQUAL(expected, to_vector(query3));
+
+    PackageQuery query4(base);
+    query4.filter_nevra(query3, libdnf5::sack::QueryCmp::LT);
+    CPPUNIT_ASSERT_EQUAL((size_t)99, query4.size());
+
+    PackageQuery query5(base);
+    query5.filter_name("pkg-libs");
+    CPPUNIT_ASSERT_EQUAL((size_t)3, query5.size());
+}
+
 void RpmPackageQueryTest::test_filter_nevra_packgset() {
     add_repo_solv("solv-repo1");
 
@@ -621,6 +727,37 @@ void RpmPackageQueryTest::test_filter_release() {
     CPPUNIT_ASSERT_EQUAL(expected, to_vector(query4));
 }
 
+void RpmPackageQueryTest::test_filter_evr_patterns_not_interned() {
+    add_repo_solv("solv-repo1");
+    std::vector<Package> expected_evr = {
+        get_pkg("pkg-0:1.2-3.src"),
+        get_pkg("pkg-0:1.2-3.x86_64"),
+        get_pkg("pkg-libs-0:1.2-3.x86_64"),
+        get_pkg("pkg-libs-1:1.2-4.x86_64")};
+    std::vector<Package> expected_version = {get_pkg("pkg-libs-1:1.3-4.x86_64")};
+    std::vector<Package> expected_release = {
+        get_pkg("pkg-0:1.2-3.src"), get_pkg("pkg-0:1.2-3.x86_64"), get_pkg("pkg-libs-0:1.2-3.x86_64")};
+
+    // the comparisons with the patterns are memoized without adding the patterns to the string pool
+    auto & pool = libdnf5::get_rpm_pool(base.get_weak_ptr());
+    const auto nstrings = pool->ss.nstrings;
+    for (int round = 0; round < 2; ++round) {
+        PackageQuery query1(base);
+        query1.filter_evr("1:1.2.1-4", libdnf5::sack::QueryCmp::LT);
+        CPPUNIT_ASSERT_EQUAL(expected_evr, to_vector(query1));
+
+        PackageQuery query2(base);
+        query2.filter_version("1.2.1", libdnf5::sack::QueryCmp::GT);
+        CPPUNIT_ASSERT_EQUAL(expected_version, to_vector(query2));
+
+        PackageQuery query3(base);
+        query3.filter_release("3.1", libdnf5::sack::QueryCmp::LT);
+        CPPUNIT_ASSERT_EQUAL(expected_release, to_vector(query3));
+
+        CPPUNIT_ASSERT_EQUAL(nstrings, pool->ss.nstrings);
+    }
+}
+
 void RpmPackageQueryTest::test_filter_priority() {
     add_repo_solv("solv-repo1");
     add_repo_solv("solv-24pkgs");
@@ -679,6 +816,134 @@ void RpmPackageQueryTest::test_filter_requires() {
     CPPUNIT_ASSERT_EQUAL(expected, to_vector(query2));
 }
 
+void RpmPackageQueryTest::test_filter_requires_packageset() {
+    add_repo_solv("solv-repo1");
+
+    PackageQuery libs(base);
+    libs.filter_nevra("pkg-libs-0:1.2-3.x86_64");
+
+    // packages requiring something provided by "pkg-libs-0:1.2-3.x86_64"
+    PackageQuery query1(base);
+    query1.filter_requires(libs);
+
+    std::vector<Package> expected = {get_pkg("pkg-0:1.2-3.x86_64")};
+    CPPUNIT_ASSERT_EQUAL(expected, to_vector(query1));
+
+    // ---
+
+    // packages not requiring anything provided by "pkg-libs-0:1.2-3.x86_64"
+    PackageQuery query2(base);
+    query2.filter_requires(libs, libdnf5::sack::QueryCmp::NEQ);
+
+    expected = {
+        get_pkg("pkg-0:1.2-3.src"),
+        get_pkg("pkg-libs-0:1.2-3.x86_64"),
+        get_pkg("pkg-libs-1:1.2-4.x86_64"),
+        get_pkg("pkg-libs-1:1.3-4.x86_64")};
+    CPPUNIT_ASSERT_EQUAL(expected, to_vector(query2));
+
+    // ---
+
+    // the cached reverse dependencies are rebuilt after a repository is added
+    add_repo_solv("solv-24pkgs");
+
+    PackageQuery query3(base);
+    query3.filter_requires(libs);
+
+    expected = {get_pkg("pkg-0:1.2-3.x86_64")};
+    CPPUNIT_ASSERT_EQUAL(expected, to_vector(query3));
+}
+
+void RpmPackageQueryTest::test_filter_rich_deps_packageset() {
+    add_repo_solv("solv-rich-deps");
+
+    // "Supplements: (glibc and langpacks-en)" is matched by the providers of either operand
+    PackageQuery glibc(base);
+    glibc.filter_name("glibc");
+
+    PackageQuery query1(base);
+    query1.filter_supplements(glibc);
+    std::vector<Package> expected = {get_pkg("glibc-langpack-en-0:2.38-1.x86_64")};
+    CPPUNIT_ASSERT_EQUAL(expected, to_vector(query1));
+
+    PackageQuery langpacks(base);
+    langpacks.filter_name("langpacks-en");
+
+    PackageQuery query2(base);
+    query2.filter_supplements(langpacks);
+    CPPUNIT_ASSERT_EQUAL(expected, to_vector(query2));
+
+    // ---
+
+    // "Requires: (glibc if langpacks-en)", the condition is matched as well
+    PackageQuery query3(base);
+    query3.filter_requires(glibc);
+    expected = {get_pkg("pkg-tools-0:1.0-1.x86_64")};
+    CPPUNIT_ASSERT_EQUAL(expected, to_vector(query3));
+
+    PackageQuery query4(base);
+    query4.filter_requires(langpacks);
+    CPPUNIT_ASSERT_EQUAL(expected, to_vector(query4));
+
+    // ---
+
+    // "Requires: (pkg-tools or glibc-langpack-en)"
+    PackageQuery tools(base);
+    tools.filter_name("pkg-tools");
+
+    PackageQuery query5(base);
+    query5.filter_requires(tools);
+    expected = {get_pkg("pkg-plugin-0:1.0-1.noarch")};
+    CPPUNIT_ASSERT_EQUAL(expected, to_vector(query5));
+
+    PackageQuery query6(base);
+    query6.filter_requires(tools, libdnf5::sack::QueryCmp::NEQ);
+    expected = {
+        get_pkg("glibc-0:2.38-1.x86_64"),
+        get_pkg("langpacks-en-0:4.0-1.noarch"),
+        get_pkg("glibc-langpack-en-0:2.38-1.x86_64"),
+        get_pkg("pkg-tools-0:1.0-1.x86_64")};
+    CPPUNIT_ASSERT_EQUAL(expected, to_vector(query6));
+}
+
+void RpmPackageQueryTest::test_filter_leaves() {
+    add_repo_solv("solv-repo1");
+
+    // "pkg-libs-0:1.2-3.x86_64" is the only provider of a dependency of "pkg-0:1.2-3.x86_64"
+    std::vector<Package> expected = {
+        get_pkg("pkg-0:1.2-3.src"),
+        get_pkg("pkg-0:1.2-3.x86_64"),
+        get_pkg("pkg-libs-1:1.2-4.x86_64"),
+        get_pkg("pkg-libs-1:1.3-4.x86_64")};
+
+    PackageQuery query1(base);
+    auto grouped_leaves = query1.filter_leaves_groups();
+    CPPUNIT_ASSERT_EQUAL(expected, to_vector(query1));
+
+    std::vector<std::vector<Package>> expected_groups;
+    for (const auto & pkg : expected) {
+        expected_groups.push_back({pkg});
+    }
+    CPPUNIT_ASSERT(expected_groups == grouped_leaves);
+
+    // ---
+
+    // the same packages again, the cached dependency graph is reused
+    PackageQuery query2(base);
+    query2.filter_leaves();
+    CPPUNIT_ASSERT_EQUAL(expected, to_vector(query2));
+
+    // ---
+
+    // a subset of the packages, the graph is rebuilt for it
+    PackageQuery query3(base);
+    query3.filter_nevra(std::vector<std::string>{"pkg-0:1.2-3.x86_64", "pkg-libs-0:1.2-3.x86_64"});
+    query3.filter_leaves();
+
+    expected = {get_pkg("pkg-0:1.2-3.x86_64")};
+    CPPUNIT_ASSERT_EQUAL(expected, to_vector(query3));
+}
+
 void RpmPackageQueryTest::test_filter_advisories() {
     add_repo_repomd("repomd-repo1");
 
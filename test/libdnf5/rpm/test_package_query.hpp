@@ -36,8 +36,11 @@ class RpmPackageQueryTest : public BaseTestCase {
     CPPUNIT_TEST(test_filter_latest_evr_ignore_arch);
     CPPUNIT_TEST(test_filter_earliest_evr);
     CPPUNIT_TEST(test_filter_earliest_evr_ignore_arch);
+    CPPUNIT_TEST(test_filter_evr_ranks_repo_added);
     CPPUNIT_TEST(test_filter_name);
     CPPUNIT_TEST(test_filter_name_packgset);
+    CPPUNIT_TEST(test_filter_name_repo_added);
+    CPPUNIT_TEST(test_filter_name_pool_reallocated);
     CPPUNIT_TEST(test_filter_nevra_packgset);
     CPPUNIT_TEST(test_filter_nevra_packgset_cmp);
     CPPUNIT_TEST(test_filter_name_arch);
@@ -45,9 +48,13 @@ class RpmPackageQueryTest : public BaseTestCase {
     CPPUNIT_TEST(test_filter_nevra);
     CPPUNIT_TEST(test_filter_version);
     CPPUNIT_TEST(test_filter_release);
+    CPPUNIT_TEST(test_filter_evr_patterns_not_interned);
     CPPUNIT_TEST(test_filter_priority);
     CPPUNIT_TEST(test_filter_provides);
     CPPUNIT_TEST(test_filter_requires);
+    CPPUNIT_TEST(test_filter_requires_packageset);
+    CPPUNIT_TEST(test_filter_rich_deps_packageset);
+    CPPUNIT_TEST(test_filter_leaves);
     CPPUNIT_TEST(test_filter_advisories);
     CPPUNIT_TEST(test_filter_chain);
     CPPUNIT_TEST(test_resolve_pkg_spec);
@@ -71,8 +78,11 @@ public:
     void test_filter_latest_evr_ignore_arch();
     void test_filter_earliest_evr();
     void test_filter_earliest_evr_ignore_arch();
+    void test_filter_evr_ranks_repo_added();
     void test_filter_name();
     void test_filter_name_packgset();
+    void test_filter_name_repo_added();
+    void test_filter_name_pool_reallocated();
     void test_filter_nevra_packgset();
     void test_filter_nevra_packgset_cmp();
     void test_filter_name_arch();
@@ -80,9 +90,13 @@ public:
     void test_filter_nevra();
     void test_filter_version();
     void test_filter_release();
+    void test_filter_evr_patterns_not_interned();
     void test_filter_provides();
     void test_filter_priority();
     void test_filter_requires();
+    void test_filter_requires_packageset();
+    void test_filter_rich_deps_packageset();
+    void test_filter_leaves();
     void test_filter_advisories();
     void test_filter_chain();
     void test_resolve_pkg_spec();
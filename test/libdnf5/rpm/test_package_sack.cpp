@@ -20,13 +20,18 @@
 
 #include "test_package_sack.hpp"
 
+#include "../shared/private_accessor.hpp"
 #include "../shared/utils.hpp"
+#include "rpm/package_sack_impl.hpp"
 
 #include <libdnf5/rpm/package_sack.hpp>
 #include <libdnf5/rpm/package_set.hpp>
 
+#include <algorithm>
 #include <filesystem>
 #include <set>
+#include <span>
+#include <string>
 #include <vector>
 
 
@@ -42,6 +47,21 @@ public:
     TestPackage(libdnf5::Base & base, PackageId id) : libdnf5::rpm::Package(base.get_weak_ptr(), id) {}
 };
 
+// Accessors of private PackageSack::p_impl and PackageSack::Impl members, see private_accessor.hpp
+create_private_getter_template;
+create_getter(package_sack_impl, &PackageSack::p_impl);
+create_getter(installed_changelogs_ts, &PackageSack::Impl::installed_changelogs_ts);
+
+// Returns the sorted full NEVRAs of `solvable_ids`
+std::vector<std::string> to_nevras(libdnf5::solv::RpmPool & pool, std::span<const Id> solvable_ids) {
+    std::vector<std::string> nevras;
+    for (Id solvable_id : solvable_ids) {
+        nevras.push_back(pool.get_full_nevra(solvable_id));
+    }
+    std::sort(nevras.begin(), nevras.end());
+    return nevras;
+}
+
 }  // namespace
 
 
@@ -123,3 +143,89 @@ void RpmPackageSackTest::test_remove_user_includes() {
     sack->remove_user_includes(*pkgset);
     CPPUNIT_ASSERT(sack->get_user_includes().contains(*pkg0) == false);
 }
+
+
+void RpmPackageSackTest::test_read_installed_changelogs() {
+    auto & sack_impl = *(*sack.*get(package_sack_impl{}));
+
+    // there is no such installed package, the rpm transaction is created by the first read
+    CPPUNIT_ASSERT(sack_impl.read_installed_changelogs(1).empty());
+    auto * ts = (sack_impl.*get(installed_changelogs_ts{})).get();
+    CPPUNIT_ASSERT(ts != nullptr);
+
+    // the following reads reuse the transaction
+    CPPUNIT_ASSERT(sack_impl.read_installed_changelogs(2).empty());
+    CPPUNIT_ASSERT(ts == (sack_impl.*get(installed_changelogs_ts{})).get());
+}
+
+
+void RpmPackageSackTest::test_get_sorted_solvables_by_name() {
+    auto & sack_impl = *(*sack.*get(package_sack_impl{}));
+    auto & pool = libdnf5::get_rpm_pool(base.get_weak_ptr());
+    libdnf5::rpm::NevraSolvableIdCmp cmp{*pool};
+
+    Id pkg = pool.str2id("pkg", false);
+    Id pkg_libs = pool.str2id("pkg-libs", true);
+    Id cmdline = pool.str2id("cmdline", true);
+
+    // many packages of the setUp() repo, no packages of the names not loaded yet
+    auto same_name = sack_impl.get_sorted_solvables_by_name(pkg);
+    CPPUNIT_ASSERT_EQUAL((size_t)24, same_name.size());
+    CPPUNIT_ASSERT(std::is_sorted(same_name.begin(), same_name.end(), cmp));
+    CPPUNIT_ASSERT(sack_impl.get_sorted_solvables_by_name(pkg_libs).empty());
+    CPPUNIT_ASSERT(sack_impl.get_sorted_solvables_by_name(cmdline).empty());
+    CPPUNIT_ASSERT(sack_impl.get_sorted_solvables_by_name(0).empty());
+
+    // the index covers the packages of a repo added later
+    add_repo_solv("solv-repo1");
+
+    same_name = sack_impl.get_sorted_solvables_by_name(pkg);
+    CPPUNIT_ASSERT_EQUAL((size_t)26, same_name.size());
+    CPPUNIT_ASSERT(std::is_sorted(same_name.begin(), same_name.end(), cmp));
+    for (Id solvable_id : same_name) {
+        CPPUNIT_ASSERT_EQUAL(pkg, pool.id2solvable(solvable_id)->name);
+    }
+
+    std::vector<std::string> expected = {
+        "pkg-libs-0:1.2-3.x86_64", "pkg-libs-1:1.2-4.x86_64", "pkg-libs-1:1.3-4.x86_64"};
+    CPPUNIT_ASSERT_EQUAL(expected, to_nevras(pool, sack_impl.get_sorted_solvables_by_name(pkg_libs)));
+    CPPUNIT_ASSERT(sack_impl.get_sorted_solvables_by_name(cmdline).empty());
+
+    // one package
+    add_cmdline_pkg("cmdline-rpms/cmdline-1.2-3.noarch.rpm");
+
+    expected = {"cmdline-0:1.2-3.noarch"};
+    CPPUNIT_ASSERT_EQUAL(expected, to_nevras(pool, sack_impl.get_sorted_solvables_by_name(cmdline)));
+    CPPUNIT_ASSERT_EQUAL((size_t)26, sack_impl.get_sorted_solvables_by_name(pkg).size());
+}
+
+
+void RpmPackageSackTest::test_get_evr_ranks_solvables_freed() {
+    auto & sack_impl = *(*sack.*get(package_sack_impl{}));
+    auto & pool = libdnf5::get_rpm_pool(base.get_weak_ptr());
+
+    ::Repo * repo = repo_create(*pool, "freed");
+    auto add_package = [&pool, repo](const char * evr) {
+        Id id = repo_add_solvable(repo);
+        Solvable * solvable = pool.id2solvable(id);
+        solvable->name = pool.str2id("freed", true);
+        solvable->evr = pool.str2id(evr, true);
+        solvable->arch = pool.str2id("noarch", true);
+        return static_cast<std::size_t>(id);
+    };
+
+    auto older = add_package("1-1");
+    auto newer = add_package("2-1");
+    auto & ranks = sack_impl.get_evr_ranks();
+    CPPUNIT_ASSERT(ranks[older] < ranks[newer]);
+
+    // the freed solvable Ids are reused, the number of solvables is the same as before
+    auto nsolvables = pool.get_nsolvables();
+    pool.empty_repo(repo, true);
+    newer = add_package("2-1");
+    older = add_package("1-1");
+    CPPUNIT_ASSERT_EQUAL(nsolvables, pool.get_nsolvables());
+
+    auto & new_ranks = sack_impl.get_evr_ranks();
+    CPPUNIT_ASSERT(new_ranks[older] < new_ranks[newer]);
+}
@@ -39,6 +39,11 @@ class RpmPackageSackTest : public BaseTestCase {
     CPPUNIT_TEST(test_add_user_includes);
     CPPUNIT_TEST(test_remove_user_includes);
 
+    CPPUNIT_TEST(test_read_installed_changelogs);
+
+    CPPUNIT_TEST(test_get_sorted_solvables_by_name);
+    CPPUNIT_TEST(test_get_evr_ranks_solvables_freed);
+
     CPPUNIT_TEST_SUITE_END();
 
 public:
@@ -52,6 +57,11 @@ public:
     void test_add_user_includes();
     void test_remove_user_includes();
 
+    void test_read_installed_changelogs();
+
+    void test_get_sorted_solvables_by_name();
+    void test_get_evr_ranks_solvables_freed();
+
 private:
     std::unique_ptr<libdnf5::rpm::PackageSet> pkgset;
     std::unique_ptr<libdnf5::rpm::Package> pkg0;
@@ -21,6 +21,8 @@
 #include "test_solv_map.hpp"
 
 #include <cstdint>
+#include <functional>
+#include <vector>
 
 
 CPPUNIT_TEST_SUITE_REGISTRATION(SolvMapTest);
@@ -161,6 +163,88 @@ void SolvMapTest::test_is_and_empty() {
 }
 
 
+void SolvMapTest::test_size_and_empty() {
+    CPPUNIT_ASSERT_EQUAL(std::size_t{4}, map1->size());
+    CPPUNIT_ASSERT(!map1->empty());
+
+    // map with the size not divisible by the word size
+    libdnf5::solv::SolvMap map(1000);
+    CPPUNIT_ASSERT_EQUAL(std::size_t{0}, map.size());
+    CPPUNIT_ASSERT(map.empty());
+
+    map.add(999);
+    CPPUNIT_ASSERT_EQUAL(std::size_t{1}, map.size());
+    CPPUNIT_ASSERT(!map.empty());
+
+    map.set_all();
+    CPPUNIT_ASSERT_EQUAL(std::size_t{1000}, map.size());
+}
+
+
+void SolvMapTest::test_large_map_operations() {
+    // maps with different sizes and ranges of words with and without set bits
+    constexpr int size1 = 1000;
+    constexpr int size2 = 777;
+    libdnf5::solv::SolvMap map1(size1);
+    libdnf5::solv::SolvMap map2(size2);
+    for (int i = 0; i < size1; i += 3) {
+        map1.add(i);
+    }
+    for (int i = 0; i < size2; ++i) {
+        if (i % 5 == 0 || (i > 300 && i < 500)) {
+            map2.add(i);
+        }
+    }
+
+    auto check = [](const libdnf5::solv::SolvMap & map, const std::function<bool(int)> & expected, int size) {
+        std::vector<Id> expected_ids;
+        for (int i = 0; i < size; ++i) {
+            if (expected(i)) {
+                expected_ids.push_back(i);
+            }
+        }
+        std::vector<Id> ids(map.begin(), map.end());
+        CPPUNIT_ASSERT(ids == expected_ids);
+        CPPUNIT_ASSERT_EQUAL(expected_ids.size(), map.size());
+    };
+    auto in_map1 = [](int i) { return i % 3 == 0; };
+    auto in_map2 = [](int i) { return i < size2 && (i % 5 == 0 || (i > 300 && i < 500)); };
+
+    {
+        auto map = map1;
+        map |= map2;
+        check(map, [&](int i) { return in_map1(i) || in_map2(i); }, size1);
+    }
+    {
+        auto map = map2;
+        map |= map1;
+        check(map, [&](int i) { return in_map1(i) || in_map2(i); }, size1);
+    }
+    {
+        auto map = map1;
+        map &= map2;
+        check(map, [&](int i) { return in_map1(i) && in_map2(i); }, size1);
+        CPPUNIT_ASSERT(!map1.is_intersection_empty(map2));
+    }
+    {
+        auto map = map2;
+        map &= map1;
+        check(map, [&](int i) { return in_map1(i) && in_map2(i); }, size1);
+    }
+    {
+        auto map = map1;
+        map -= map2;
+        check(map, [&](int i) { return in_map1(i) && !in_map2(i); }, size1);
+        CPPUNIT_ASSERT(map.is_intersection_empty(map2));
+    }
+    {
+        auto map = map2;
+        map -= map1;
+        check(map, [&](int i) { return !in_map1(i) && in_map2(i); }, size1);
+    }
+}
+
+
 void SolvMapTest::test_iterator_empty() {
     std::vector<Id> expected = {};
     std::vector<Id> result;
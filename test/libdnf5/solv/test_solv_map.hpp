@@ -40,6 +40,8 @@ class SolvMapTest : public CppUnit::TestCase {
     CPPUNIT_TEST(test_intersection);
     CPPUNIT_TEST(test_difference);
     CPPUNIT_TEST(test_is_and_empty);
+    CPPUNIT_TEST(test_size_and_empty);
+    CPPUNIT_TEST(test_large_map_operations);
     CPPUNIT_TEST(test_iterator_empty);
     CPPUNIT_TEST(test_iterator_full);
     CPPUNIT_TEST(test_iterator_sparse);
@@ -68,6 +70,8 @@ public:
     void test_difference();
 
     void test_is_and_empty();
+    void test_size_and_empty();
+    void test_large_map_operations();
 
     void test_iterator_empty();
     void test_iterator_full();
@@ -0,0 +1,176 @@
+// Copyright Contributors to the DNF5 project.
+// Copyright Contributors to the libdnf project.
+// SPDX-License-Identifier: GPL-2.0-or-later
+//
+// This file is part of libdnf: https://github.com/rpm-software-management/libdnf/
+//
+// Libdnf is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 2 of the License, or
+// (at your option) any later version.
+//
+// Libdnf is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
+#include "test_sparse_solv_map.hpp"
+
+#include <vector>
+
+
+CPPUNIT_TEST_SUITE_REGISTRATION(SparseSolvMapTest);
+
+
+namespace {
+
+std::vector<Id> to_vector(const libdnf5::solv::SolvMap & map) {
+    return std::vector<Id>(map.begin(), map.end());
+}
+
+}  // namespace
+
+
+void SparseSolvMapTest::test_sparse_intersection() {
+    libdnf5::solv::SolvMap map(1024);
+    map.add(1);
+    map.add(100);
+    map.add(500);
+    map.add(1000);
+
+    libdnf5::solv::SparseSolvMap filter_result(1024);
+    filter_result.add_unsafe(100);
+    filter_result.add_unsafe(200);
+    filter_result.add_unsafe(1000);
+    // duplicate ids are allowed
+    filter_result.add_unsafe(1000);
+    CPPUNIT_ASSERT(!filter_result.is_dense());
+
+    filter_result.apply_intersection(map);
+    CPPUNIT_ASSERT((to_vector(map) == std::vector<Id>{100, 1000}));
+}
+
+
+void SparseSolvMapTest::test_sparse_difference() {
+    libdnf5::solv::SolvMap map(1024);
+    map.add(1);
+    map.add(100);
+    map.add(500);
+
+    libdnf5::solv::SparseSolvMap filter_result(1024);
+    filter_result.add_unsafe(100);
+    filter_result.add_unsafe(200);
+    CPPUNIT_ASSERT(!filter_result.is_dense());
+
+    filter_result.apply_difference(map);
+    CPPUNIT_ASSERT((to_vector(map) == std::vector<Id>{1, 500}));
+}
+
+
+void SparseSolvMapTest::test_dense() {
+    constexpr int size = 10000;
+    libdnf5::solv::SolvMap map(size);
+    for (int i = 0; i < size; i += 2) {
+        map.add(i);
+    }
+
+    // many ids are moved to a dense map
+    libdnf5::solv::SparseSolvMap filter_result(size);
+    std::vector<Id> expected;
+    for (int i = 0; i < size; i += 3) {
+        filter_result.add_unsafe(i);
+        if (i % 2 == 0) {
+            expected.push_back(i);
+        }
+    }
+    CPPUNIT_ASSERT(filter_result.is_dense());
+
+    auto intersection = map;
+    filter_result.apply_intersection(intersection);
+    CPPUNIT_ASSERT(to_vector(intersection) == expected);
+
+    auto difference = map;
+    filter_result.apply_difference(difference);
+    CPPUNIT_ASSERT_EQUAL(map.size() - expected.size(), difference.size());
+    for (Id id : expected) {
+        CPPUNIT_ASSERT(!difference.contains(id));
+    }
+}
+
+
+void SparseSolvMapTest::test_duplicates() {
+    libdnf5::solv::SolvMap map(1024);
+    map.set_all();
+
+    // only distinct ids count towards the threshold of the dense map
+    libdnf5::solv::SparseSolvMap filter_result(1024);
+    for (int i = 0; i < 1000; ++i) {
+        filter_result.add_unsafe(i % 2 == 0 ? 900 : 7);
+    }
+    CPPUNIT_ASSERT(!filter_result.is_dense());
+
+    filter_result.apply_intersection(map);
+    CPPUNIT_ASSERT((to_vector(map) == std::vector<Id>{7, 900}));
+}
+
+
+void SparseSolvMapTest::test_repeated_pattern() {
+    libdnf5::solv::SolvMap map(1024);
+    map.set_all();
+
+    // the list of 1024 / 32 = 64 ids is normalized when it overflows, 30 distinct ids are less than half of it
+    libdnf5::solv::SparseSolvMap few_ids(1024);
+    std::vector<Id> expected;
+    for (int i = 0; i < 30; ++i) {
+        expected.push_back(i * 10);
+    }
+    for (int round = 0; round < 100; ++round) {
+        for (Id id : expected) {
+            few_ids.add_unsafe(id);
+        }
+    }
+    CPPUNIT_ASSERT(!few_ids.is_dense());
+
+    auto intersection = map;
+    few_ids.apply_intersection(intersection);
+    CPPUNIT_ASSERT(to_vector(intersection) == expected);
+
+    // with more than half distinct ids the repeated pattern would be normalized again soon, the ids go dense
+    libdnf5::solv::SparseSolvMap more_ids(1024);
+    expected.clear();
+    for (int i = 0; i < 40; ++i) {
+        expected.push_back(i * 10);
+    }
+    for (int round = 0; round < 2; ++round) {
+        for (Id id : expected) {
+            more_ids.add_unsafe(id);
+        }
+    }
+    CPPUNIT_ASSERT(more_ids.is_dense());
+
+    intersection = map;
+    more_ids.apply_intersection(intersection);
+    CPPUNIT_ASSERT(to_vector(intersection) == expected);
+}
+
+
+void SparseSolvMapTest::test_unsorted_intersection() {
+    libdnf5::solv::SolvMap map(1024);
+    map.set_all();
+
+    // ids in the same byte of the map, in the first and the last byte
+    libdnf5::solv::SparseSolvMap filter_result(1024);
+    for (Id id : {1023, 17, 0, 19, 16, 1016}) {
+        filter_result.add_unsafe(id);
+    }
+    CPPUNIT_ASSERT(!filter_result.is_dense());
+
+    filter_result.apply_intersection(map);
+    CPPUNIT_ASSERT((to_vector(map) == std::vector<Id>{0, 16, 17, 19, 1016, 1023}));
+
+    // applying the set again keeps the result
+    filter_result.apply_intersection(map);
+    CPPUNIT_ASSERT((to_vector(map) == std::vector<Id>{0, 16, 17, 19, 1016, 1023}));
+}
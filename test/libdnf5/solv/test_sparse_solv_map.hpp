@@ -0,0 +1,49 @@
+// Copyright Contributors to the DNF5 project.
+// Copyright Contributors to the libdnf project.
+// SPDX-License-Identifier: GPL-2.0-or-later
+//
+// This file is part of libdnf: https://github.com/rpm-software-management/libdnf/
+//
+// Libdnf is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 2 of the License, or
+// (at your option) any later version.
+//
+// Libdnf is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with libdnf.  If not, see <https://www.gnu.org/licenses/>.
+#ifndef TEST_LIBDNF5_SOLV_SPARSE_SOLV_MAP_HPP
+#define TEST_LIBDNF5_SOLV_SPARSE_SOLV_MAP_HPP
+
+
+#include "solv/sparse_solv_map.hpp"
+
+#include <cppunit/TestCase.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+
+class SparseSolvMapTest : public CppUnit::TestCase {
+    CPPUNIT_TEST_SUITE(SparseSolvMapTest);
+    CPPUNIT_TEST(test_sparse_intersection);
+    CPPUNIT_TEST(test_sparse_difference);
+    CPPUNIT_TEST(test_dense);
+    CPPUNIT_TEST(test_duplicates);
+    CPPUNIT_TEST(test_repeated_pattern);
+    CPPUNIT_TEST(test_unsorted_intersection);
+    CPPUNIT_TEST_SUITE_END();
+
+public:
+    void test_sparse_intersection();
+    void test_sparse_difference();
+    void test_dense();
+    void test_duplicates();
+    void test_repeated_pattern();
+    void test_unsorted_intersection();
+};
+
+
+#endif  // TEST_LIBDNF5_SOLV_SPARSE_SOLV_MAP_HPP
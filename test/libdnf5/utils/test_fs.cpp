@@ -20,6 +20,7 @@
 
 #include "test_fs.hpp"
 
+#include "utils/fs/mapped_file.hpp"
 #include "utils/fs/utils.hpp"
 
 #include <fcntl.h>
@@ -411,3 +412,40 @@ void UtilsFsTest::test_file_flush() {
 
     CPPUNIT_ASSERT_EQUAL(data_w, data_r);
 }
+
+
+void UtilsFsTest::test_mapped_file() {
+    libdnf5::utils::fs::TempDir temp_dir("libdnf_unittest_mapped_file");
+
+    std::string data_w = generate_test_data(10000);
+    {
+        libdnf5::utils::fs::File file(temp_dir.get_path() / "file", "w");
+        file.write(data_w);
+    }
+
+    libdnf5::utils::fs::MappedFile mapped_file(temp_dir.get_path() / "file");
+    CPPUNIT_ASSERT_EQUAL(temp_dir.get_path() / "file", mapped_file.get_path());
+    CPPUNIT_ASSERT_EQUAL(data_w.size(), mapped_file.size());
+    CPPUNIT_ASSERT_EQUAL(
+        data_w, std::string(reinterpret_cast<const char *>(mapped_file.data()), mapped_file.size()));
+    mapped_file.will_need();
+
+    // the stream reads the same file from the beginning
+    auto file_r = mapped_file.open_file();
+    CPPUNIT_ASSERT_EQUAL(data_w, file_r.read());
+
+    // the mapping stays valid after the path is removed
+    stdfs::remove(temp_dir.get_path() / "file");
+    CPPUNIT_ASSERT_EQUAL(
+        data_w, std::string(reinterpret_cast<const char *>(mapped_file.data()), mapped_file.size()));
+
+    // an empty file is not mapped
+    libdnf5::utils::fs::File(temp_dir.get_path() / "empty", "w").close();
+    libdnf5::utils::fs::MappedFile mapped_empty(temp_dir.get_path() / "empty");
+    CPPUNIT_ASSERT_EQUAL((size_t)0, mapped_empty.size());
+    CPPUNIT_ASSERT(mapped_empty.data() == nullptr);
+    CPPUNIT_ASSERT_EQUAL(std::string(), mapped_empty.open_file().read());
+
+    CPPUNIT_ASSERT_THROW(
+        libdnf5::utils::fs::MappedFile(temp_dir.get_path() / "nonexistent"), libdnf5::FileSystemError);
+}
@@ -39,6 +39,18 @@ class TestRpmSignature(base_test_case.BaseTestCase):
         result = rpm_sign.check_package_signature(package)
         self.assertEqual(result, libdnf5.rpm.RpmSignature.CheckResult_SKIPPED)
 
+    def test_checking_signatures(self):
+        # Test wrapper for check_package_signatures
+        query = libdnf5.rpm.PackageQuery(self.base)
+        query.filter_name(["pkg", "pkg-libs"])
+        packages = list(query)
+
+        rpm_sign = libdnf5.rpm.RpmSignature(self.base)
+        results = rpm_sign.check_package_signatures(packages)
+        self.assertEqual(len(results), len(packages))
+        for result in results:
+            self.assertEqual(result, libdnf5.rpm.RpmSignature.CheckResult_SKIPPED)
+
     def test_key_files_vector_wrapper(self):
         # Test wrapper for std::vector<KeyInfo>
         key_path = os.path.join(base_test_case.PROJECT_SOURCE_DIR,